@@ -0,0 +1,541 @@
+#ifndef BAKED_TEXTURE_LOADER_H
+#define BAKED_TEXTURE_LOADER_H
+
+#include <glad/glad.h>
+
+#include "LearnOpenGL/MappedFile.h"
+#include "LearnOpenGL/ImageArena.h"
+#include "LearnOpenGL/BlockCompressor.h"
+#include "LearnOpenGL/MipChainGenerator.h"
+#include "LearnOpenGL/TextureLoadOptions.h"
+#include "LearnOpenGL/ParallelJpegDecoder.h"
+#include "Images/stb_image.h"
+
+#include <cstdint>
+#include <cstring>
+#include <climits>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <algorithm>
+#include <filesystem>
+#include <initializer_list>
+
+
+/*
+ * Texture baked into a KTX2 container (uncompressed 8 bit or BCn formats, full mip chain, no supercompression), memory mapped &
+ * validated by Open. Upload hands every level straight from the mapping to the driver: there's nothing left to decode or generate.
+ */
+class BakedTextureFile
+{
+public:
+    // Needs the GL context, as files of textures larger than the driver supports are rejected as well
+    bool Open(const std::string& FilePath)
+    {
+        Levels.clear();
+        if (!File.Open(FilePath) || !Parse())
+        {
+            File.Close();
+            Levels.clear();
+            return false;
+        }
+        return true;
+    }
+
+    // Uploads all the levels into the texture bound to GL_TEXTURE_2D of the active texture unit
+    void Upload() const
+    {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (std::size_t levelIndex = 0; levelIndex < Levels.size(); ++levelIndex)
+        {
+            const Level& level = Levels[levelIndex];
+            if (bBlockCompressed)
+            {
+                glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(levelIndex), InternalFormat, level.Width, level.Height, 0,
+                    static_cast<GLsizei>(level.ByteLength), File.GetData() + level.ByteOffset);
+            }
+            else
+            {
+                glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(levelIndex), InternalFormat, level.Width, level.Height, 0, PixelFormat, GL_UNSIGNED_BYTE,
+                    File.GetData() + level.ByteOffset);
+            }
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(Levels.size()) - 1);
+    }
+
+    int GetWidth() const
+    {
+        return Levels.empty() ? 0 : Levels[0].Width;
+    }
+
+    int GetHeight() const
+    {
+        return Levels.empty() ? 0 : Levels[0].Height;
+    }
+
+    int GetChannels() const
+    {
+        return Channels;
+    }
+
+    bool IsBlockCompressed() const
+    {
+        return bBlockCompressed;
+    }
+
+    // Whether the driver can create textures of the file's format (uncompressed ones always; needs GLExtensions::Load for block compressed ones)
+    bool IsSupported() const
+    {
+        return !bBlockCompressed || BlockCompressor::IsSupported(BlockFormat, bBlockSRGB);
+    }
+
+    std::size_t GetLevelsCount() const
+    {
+        return Levels.size();
+    }
+
+    // all levels together
+    std::size_t GetSizeInBytes() const
+    {
+        std::size_t sizeInBytes = 0;
+        for (const Level& level : Levels)
+        {
+            sizeInBytes += level.ByteLength;
+        }
+        return sizeInBytes;
+    }
+
+    // KTX2 format constants (shared with the writer in BakedTextureLoader)
+    static constexpr unsigned char IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+    static constexpr std::size_t HEADER_SIZE = 80;
+    static constexpr std::size_t LEVEL_INDEX_ENTRY_SIZE = 24;
+
+    enum class EVulkanFormat : std::uint32_t
+    {
+        R8Unorm = 9,
+        R8G8Unorm = 16,
+        R8G8B8Unorm = 23,
+        R8G8B8Srgb = 29,
+        R8G8B8A8Unorm = 37,
+        R8G8B8A8Srgb = 43,
+        BC1RgbUnorm = 131,
+        BC1RgbSrgb = 132,
+        BC3Unorm = 137,
+        BC3Srgb = 138,
+        BC4Unorm = 139,
+        BC5Unorm = 141,
+        BC7Unorm = 145,
+        BC7Srgb = 146
+    };
+
+    // False for formats baked textures don't use
+    static bool GetFormatInfo(std::uint32_t VulkanFormat, int& OutChannels, GLenum& OutPixelFormat, GLenum& OutInternalFormat)
+    {
+        switch (static_cast<EVulkanFormat>(VulkanFormat))
+        {
+            case EVulkanFormat::R8Unorm: OutChannels = 1; OutPixelFormat = GL_RED; OutInternalFormat = GL_R8; return true;
+            case EVulkanFormat::R8G8Unorm: OutChannels = 2; OutPixelFormat = GL_RG; OutInternalFormat = GL_RG8; return true;
+            case EVulkanFormat::R8G8B8Unorm: OutChannels = 3; OutPixelFormat = GL_RGB; OutInternalFormat = GL_RGB8; return true;
+            case EVulkanFormat::R8G8B8Srgb: OutChannels = 3; OutPixelFormat = GL_RGB; OutInternalFormat = GL_SRGB8; return true;
+            case EVulkanFormat::R8G8B8A8Unorm: OutChannels = 4; OutPixelFormat = GL_RGBA; OutInternalFormat = GL_RGBA8; return true;
+            case EVulkanFormat::R8G8B8A8Srgb: OutChannels = 4; OutPixelFormat = GL_RGBA; OutInternalFormat = GL_SRGB8_ALPHA8; return true;
+            default: return false;
+        }
+    }
+
+    // False for formats that aren't block compressed
+    static bool GetBlockFormatInfo(std::uint32_t VulkanFormat, EBlockFormat& OutFormat, bool& OutSRGB)
+    {
+        OutSRGB = false;
+        switch (static_cast<EVulkanFormat>(VulkanFormat))
+        {
+            case EVulkanFormat::BC1RgbSrgb: OutSRGB = true; [[fallthrough]];
+            case EVulkanFormat::BC1RgbUnorm: OutFormat = EBlockFormat::BC1; return true;
+            case EVulkanFormat::BC3Srgb: OutSRGB = true; [[fallthrough]];
+            case EVulkanFormat::BC3Unorm: OutFormat = EBlockFormat::BC3; return true;
+            case EVulkanFormat::BC4Unorm: OutFormat = EBlockFormat::BC4; return true;
+            case EVulkanFormat::BC5Unorm: OutFormat = EBlockFormat::BC5; return true;
+            case EVulkanFormat::BC7Srgb: OutSRGB = true; [[fallthrough]];
+            case EVulkanFormat::BC7Unorm: OutFormat = EBlockFormat::BC7; return true;
+            default: return false;
+        }
+    }
+
+private:
+    struct Level
+    {
+        std::size_t ByteOffset;
+        std::size_t ByteLength;
+        int Width;
+        int Height;
+    };
+
+    bool Parse()
+    {
+        const unsigned char* data = File.GetData();
+        const std::size_t fileSize = File.GetSize();
+        if (fileSize < HEADER_SIZE || std::memcmp(data, IDENTIFIER, sizeof(IDENTIFIER)) != 0)
+        {
+            return false;
+        }
+
+        // vkFormat, typeSize, pixelWidth, pixelHeight, pixelDepth, layerCount, faceCount, levelCount, supercompressionScheme
+        std::uint32_t header[9];
+        std::memcpy(header, data + sizeof(IDENTIFIER), sizeof(header));
+        const std::uint32_t width = header[2];
+        const std::uint32_t height = header[3];
+        const std::uint32_t levelsCount = header[7];
+        bBlockCompressed = GetBlockFormatInfo(header[0], BlockFormat, bBlockSRGB);
+        if (bBlockCompressed)
+        {
+            Channels = BlockCompressor::GetChannels(BlockFormat);
+            InternalFormat = BlockCompressor::GetInternalFormat(BlockFormat, bBlockSRGB);
+        }
+        if ((!bBlockCompressed && !GetFormatInfo(header[0], Channels, PixelFormat, InternalFormat)) || width == 0 || height == 0 || header[4] != 0 || header[5] > 1 ||
+            header[6] != 1 || header[8] != 0)
+        {
+            return false;
+        }
+
+        GLint maxTextureSize = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+        if (width > static_cast<std::uint32_t>(INT_MAX) || height > static_cast<std::uint32_t>(INT_MAX) || width > static_cast<std::uint32_t>(maxTextureSize) ||
+            height > static_cast<std::uint32_t>(maxTextureSize))
+        {
+            return false;
+        }
+
+        // levels are sized by shifting the base level's size, so there can't be more of them than a full mip chain has
+        std::uint32_t maxLevelsCount = 1;
+        while ((std::max(width, height) >> maxLevelsCount) != 0)
+        {
+            ++maxLevelsCount;
+        }
+        if (levelsCount == 0 || levelsCount > maxLevelsCount || HEADER_SIZE + levelsCount * LEVEL_INDEX_ENTRY_SIZE > fileSize)
+        {
+            return false;
+        }
+
+        for (std::uint32_t levelIndex = 0; levelIndex < levelsCount; ++levelIndex)
+        {
+            // byteOffset, byteLength, uncompressedByteLength
+            std::uint64_t levelIndexEntry[3];
+            std::memcpy(levelIndexEntry, data + HEADER_SIZE + levelIndex * LEVEL_INDEX_ENTRY_SIZE, sizeof(levelIndexEntry));
+
+            const int levelWidth = static_cast<int>(std::max(width >> levelIndex, 1u));
+            const int levelHeight = static_cast<int>(std::max(height >> levelIndex, 1u));
+            const std::uint64_t expectedByteLength = bBlockCompressed ? BlockCompressor::GetCompressedSize(BlockFormat, levelWidth, levelHeight) :
+                static_cast<std::uint64_t>(levelWidth) * levelHeight * Channels;
+            if (levelIndexEntry[1] != expectedByteLength || levelIndexEntry[0] > fileSize || levelIndexEntry[1] > fileSize - levelIndexEntry[0])
+            {
+                return false;
+            }
+            Levels.push_back({ static_cast<std::size_t>(levelIndexEntry[0]), static_cast<std::size_t>(levelIndexEntry[1]), levelWidth, levelHeight });
+        }
+
+        return true;
+    }
+
+private:
+    MappedFile File;
+    std::vector<Level> Levels;
+    int Channels = 0;
+    GLenum PixelFormat = GL_RGBA;
+    GLenum InternalFormat = GL_RGBA8;
+    bool bBlockCompressed = false;
+    EBlockFormat BlockFormat = EBlockFormat::BC1;
+    bool bBlockSRGB = false;
+};
+
+// How TextureBaker bakes a file; unlike TextureLoadOptions, these don't change which baked file a texture is loaded from
+struct TextureBakeOptions
+{
+    EMipFilter MipFilter = EMipFilter::Box;
+    // levels get compressed into the format BlockCompressor::ChooseFormat picks for the image
+    bool bBlockCompressed = false;
+    EBlockCompressionQuality CompressionQuality = EBlockCompressionQuality::Normal;
+    // RGBA images go into BC7, or into BC3 for GPUs without BPTC
+    bool bBC7Available = true;
+};
+
+/*
+ * Textures baked offline by TextureBaker into "<image file>[.flip][.c<channels>][.srgb].ktx2" next to the image (one file per
+ * set of load options), with the mip chain precomputed in the final GL internal format. A baked file is only used while
+ * it's up to date, i.e. not older than its image; otherwise the image is decoded & mipmapped at runtime as usual.
+ */
+class BakedTextureLoader
+{
+public:
+    static void SetEnabled(bool bNewEnabled)
+    {
+        bEnabled = bNewEnabled;
+    }
+
+    static bool IsEnabled()
+    {
+        return bEnabled;
+    }
+
+    static std::string GetBakedFilePath(const std::string& ImageFilePath, const TextureLoadOptions& Options)
+    {
+        return ImageFilePath + (Options.bFlipVertically ? ".flip" : "") + (Options.DesiredChannels != 0 ? ".c" + std::to_string(Options.DesiredChannels) : "") +
+            (Options.bSRGB ? ".srgb" : "") + ".ktx2";
+    }
+
+    // Opens the baked file of the image if there's a valid one newer than the image
+    static bool OpenUpToDate(const std::string& ImageFilePath, const TextureLoadOptions& Options, BakedTextureFile& OutBakedTexture)
+    {
+        if (!bEnabled || !IsUpToDate(ImageFilePath, Options))
+        {
+            return false;
+        }
+
+        const std::string bakedFilePath = GetBakedFilePath(ImageFilePath, Options);
+        if (!OutBakedTexture.Open(bakedFilePath))
+        {
+            std::cout << "Ignoring invalid baked texture " << bakedFilePath << std::endl;
+            return false;
+        }
+        if (!OutBakedTexture.IsSupported())
+        {
+            std::cout << "Ignoring baked texture " << bakedFilePath << ", its compressed format isn't supported by the driver" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    static bool IsUpToDate(const std::string& ImageFilePath, const TextureLoadOptions& Options)
+    {
+        std::error_code errorCode;
+        const std::filesystem::file_time_type bakedWriteTime = std::filesystem::last_write_time(GetBakedFilePath(ImageFilePath, Options), errorCode);
+        if (errorCode)
+        {
+            return false;
+        }
+
+        const std::filesystem::file_time_type imageWriteTime = std::filesystem::last_write_time(ImageFilePath, errorCode);
+        return !errorCode && imageWriteTime <= bakedWriteTime;
+    }
+
+    // Decodes the image, generates its mip chain (block compressed if asked to) & writes the baked file (no GL context needed)
+    static bool Bake(const std::string& ImageFilePath, const TextureLoadOptions& Options, const TextureBakeOptions& BakeOptions = TextureBakeOptions())
+    {
+        // the decoded image is copied into level 0 right away, so stb_image's allocations can live in the thread's arena
+        ImageArena::Scope arenaScope;
+        stbi_set_flip_vertically_on_load_thread(Options.bFlipVertically);
+        int width = 0;
+        int height = 0;
+        int fileChannels = 0;
+        unsigned char* pixels = ParallelJpegDecoder::Load(ImageFilePath, &width, &height, &fileChannels, Options.DesiredChannels);
+        if (pixels == nullptr)
+        {
+            std::cout << "Failed to load texture " << ImageFilePath << std::endl;
+            return false;
+        }
+
+        const int channels = Options.DesiredChannels != 0 ? Options.DesiredChannels : fileChannels;
+        // same formats TextureCache uploads decoded images with, i.e. sRGB only applies to color images
+        const bool bSRGB = Options.bSRGB && channels >= 3;
+
+        MipGenerationOptions mipOptions;
+        mipOptions.Filter = BakeOptions.MipFilter;
+        mipOptions.bSRGB = bSRGB;
+        // colors of transparent texels must not bleed into the visible ones of smaller mips
+        mipOptions.bPremultipliedAlpha = true;
+        std::vector<MipLevel> levels(1);
+        levels[0].Width = width;
+        levels[0].Height = height;
+        levels[0].Pixels.assign(pixels, pixels + static_cast<std::size_t>(width) * height * channels);
+        std::vector<MipLevel> mipLevels = MipChainGenerator::Generate(pixels, width, height, channels, mipOptions);
+        levels.insert(levels.end(), std::make_move_iterator(mipLevels.begin()), std::make_move_iterator(mipLevels.end()));
+        stbi_image_free(pixels);
+
+        BlockCompressionOptions compressionOptions;
+        compressionOptions.Format = BlockCompressor::ChooseFormat(channels, BakeOptions.bBC7Available);
+        compressionOptions.Quality = BakeOptions.CompressionQuality;
+        if (BakeOptions.bBlockCompressed)
+        {
+            for (MipLevel& level : levels)
+            {
+                level.Pixels = BlockCompressor::Compress(level.Pixels.data(), level.Width, level.Height, channels, compressionOptions);
+            }
+        }
+
+        const std::string bakedFilePath = GetBakedFilePath(ImageFilePath, Options);
+        const LevelsFormat levelsFormat = { channels, bSRGB, BakeOptions.bBlockCompressed, compressionOptions.Format };
+        if (!WriteFile(bakedFilePath, levels, width, height, levelsFormat, Options.bFlipVertically))
+        {
+            std::cout << "Failed to write baked texture " << bakedFilePath << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    // What the baked levels hold
+    struct LevelsFormat
+    {
+        int Channels;
+        bool bSRGB;
+        bool bBlockCompressed;
+        EBlockFormat BlockFormat;
+    };
+
+    static std::uint32_t GetVulkanFormat(const LevelsFormat& Format)
+    {
+        using EVulkanFormat = BakedTextureFile::EVulkanFormat;
+        if (Format.bBlockCompressed)
+        {
+            switch (Format.BlockFormat)
+            {
+                case EBlockFormat::BC1: return static_cast<std::uint32_t>(Format.bSRGB ? EVulkanFormat::BC1RgbSrgb : EVulkanFormat::BC1RgbUnorm);
+                case EBlockFormat::BC3: return static_cast<std::uint32_t>(Format.bSRGB ? EVulkanFormat::BC3Srgb : EVulkanFormat::BC3Unorm);
+                case EBlockFormat::BC4: return static_cast<std::uint32_t>(EVulkanFormat::BC4Unorm);
+                case EBlockFormat::BC5: return static_cast<std::uint32_t>(EVulkanFormat::BC5Unorm);
+                default: return static_cast<std::uint32_t>(Format.bSRGB ? EVulkanFormat::BC7Srgb : EVulkanFormat::BC7Unorm);
+            }
+        }
+
+        switch (Format.Channels)
+        {
+            case 1: return static_cast<std::uint32_t>(EVulkanFormat::R8Unorm);
+            case 2: return static_cast<std::uint32_t>(EVulkanFormat::R8G8Unorm);
+            case 3: return static_cast<std::uint32_t>(Format.bSRGB ? EVulkanFormat::R8G8B8Srgb : EVulkanFormat::R8G8B8Unorm);
+            default: return static_cast<std::uint32_t>(Format.bSRGB ? EVulkanFormat::R8G8B8A8Srgb : EVulkanFormat::R8G8B8A8Unorm);
+        }
+    }
+
+    static void AppendWords(std::vector<unsigned char>& Destination, std::initializer_list<std::uint32_t> Words)
+    {
+        for (const std::uint32_t word : Words)
+        {
+            const std::size_t offset = Destination.size();
+            Destination.resize(offset + sizeof(word));
+            std::memcpy(Destination.data() + offset, &word, sizeof(word));
+        }
+    }
+
+    static void PadTo(std::vector<unsigned char>& Destination, std::size_t Alignment)
+    {
+        Destination.resize((Destination.size() + Alignment - 1) / Alignment * Alignment, 0);
+    }
+
+    // Basic data format descriptor, which KTX2 requires: one 8 bit sample per channel, RGB(A) color model, BT.709 primaries
+    static std::vector<unsigned char> MakeDataFormatDescriptor(int Channels, bool bSRGB)
+    {
+        constexpr std::uint32_t CHANNEL_IDS[4] = { 0, 1, 2, 15 };
+        constexpr std::uint32_t CHANNEL_LINEAR_QUALIFIER = 0x10;
+
+        const std::uint32_t descriptorBlockSize = 24 + 16 * static_cast<std::uint32_t>(Channels);
+        std::vector<unsigned char> descriptor;
+        AppendWords(descriptor, { 4 + descriptorBlockSize, 0, 2 | (descriptorBlockSize << 16), 1 | (1 << 8) | ((bSRGB ? 2u : 1u) << 16), 0,
+            static_cast<std::uint32_t>(Channels), 0 });
+        for (int channel = 0; channel < Channels; ++channel)
+        {
+            // alpha is always linear, even in sRGB formats
+            const std::uint32_t channelId = Channels == 4 && channel == 3 ? CHANNEL_IDS[3] | (bSRGB ? CHANNEL_LINEAR_QUALIFIER : 0) : CHANNEL_IDS[channel];
+            AppendWords(descriptor, { static_cast<std::uint32_t>(channel * 8) | (7 << 16) | (channelId << 24), 0, 0, 255 });
+        }
+        return descriptor;
+    }
+
+    // Same for block compressed formats: 4x4 texel blocks, BCn color model, one sample per 64 bit half of the block (BC7 has a single 128 bit one)
+    static std::vector<unsigned char> MakeBlockDataFormatDescriptor(EBlockFormat Format, bool bSRGB)
+    {
+        constexpr std::uint32_t CHANNEL_LINEAR_QUALIFIER = 0x10;
+        // color model, then channel ids & bit lengths of the samples (BC3's alpha comes first, the color model numbers its channels like that)
+        struct BlockSamples
+        {
+            std::uint32_t ColorModel;
+            std::uint32_t SamplesCount;
+            std::uint32_t ChannelIds[2];
+            std::uint32_t BitLength;
+        };
+        BlockSamples blockSamples;
+        switch (Format)
+        {
+            case EBlockFormat::BC1: blockSamples = { 128, 1, { 0, 0 }, 64 }; break;
+            case EBlockFormat::BC3: blockSamples = { 130, 2, { 15 | (bSRGB ? CHANNEL_LINEAR_QUALIFIER : 0), 0 }, 64 }; break;
+            case EBlockFormat::BC4: blockSamples = { 131, 1, { 0, 0 }, 64 }; break;
+            case EBlockFormat::BC5: blockSamples = { 132, 2, { 0, 1 }, 64 }; break;
+            default: blockSamples = { 134, 1, { 0, 0 }, 128 }; break;
+        }
+
+        const std::uint32_t descriptorBlockSize = 24 + 16 * blockSamples.SamplesCount;
+        std::vector<unsigned char> descriptor;
+        AppendWords(descriptor, { 4 + descriptorBlockSize, 0, 2 | (descriptorBlockSize << 16), blockSamples.ColorModel | (1 << 8) | ((bSRGB ? 2u : 1u) << 16),
+            3 | (3 << 8), static_cast<std::uint32_t>(BlockCompressor::GetBlockSize(Format)), 0 });
+        for (std::uint32_t sampleIndex = 0; sampleIndex < blockSamples.SamplesCount; ++sampleIndex)
+        {
+            AppendWords(descriptor, { (sampleIndex * 64) | ((blockSamples.BitLength - 1) << 16) | (blockSamples.ChannelIds[sampleIndex] << 24), 0, 0, 0xFFFFFFFFu });
+        }
+        return descriptor;
+    }
+
+    static bool WriteFile(const std::string& BakedFilePath, const std::vector<MipLevel>& Levels, int Width, int Height, const LevelsFormat& Format,
+        bool bFlippedVertically)
+    {
+        std::vector<unsigned char> contents(BakedTextureFile::IDENTIFIER, BakedTextureFile::IDENTIFIER + sizeof(BakedTextureFile::IDENTIFIER));
+        AppendWords(contents, { GetVulkanFormat(Format), 1, static_cast<std::uint32_t>(Width), static_cast<std::uint32_t>(Height), 0, 0, 1,
+            static_cast<std::uint32_t>(Levels.size()), 0 });
+
+        // index & level index get filled in once the layout is known
+        const std::size_t indexOffset = contents.size();
+        contents.resize(BakedTextureFile::HEADER_SIZE + Levels.size() * BakedTextureFile::LEVEL_INDEX_ENTRY_SIZE, 0);
+
+        const std::uint32_t dataFormatDescriptorOffset = static_cast<std::uint32_t>(contents.size());
+        const std::vector<unsigned char> dataFormatDescriptor = Format.bBlockCompressed ? MakeBlockDataFormatDescriptor(Format.BlockFormat, Format.bSRGB) :
+            MakeDataFormatDescriptor(Format.Channels, Format.bSRGB);
+        contents.insert(contents.end(), dataFormatDescriptor.begin(), dataFormatDescriptor.end());
+
+        // rows of the image go top to bottom, unless it was flipped on load
+        const std::uint32_t keyValueDataOffset = static_cast<std::uint32_t>(contents.size());
+        const char orientation[] = { 'K', 'T', 'X', 'o', 'r', 'i', 'e', 'n', 't', 'a', 't', 'i', 'o', 'n', '\0', 'r', bFlippedVertically ? 'u' : 'd', '\0' };
+        AppendWords(contents, { static_cast<std::uint32_t>(sizeof(orientation)) });
+        contents.insert(contents.end(), orientation, orientation + sizeof(orientation));
+        PadTo(contents, 4);
+        const std::uint32_t keyValueDataLength = static_cast<std::uint32_t>(contents.size()) - keyValueDataOffset;
+
+        std::uint32_t index[4] = { dataFormatDescriptorOffset, static_cast<std::uint32_t>(dataFormatDescriptor.size()), keyValueDataOffset, keyValueDataLength };
+        std::memcpy(contents.data() + indexOffset, index, sizeof(index));
+
+        // levels are stored from the smallest, each aligned to both the texel (or block) size & 4 bytes
+        const std::size_t levelAlignment = Format.bBlockCompressed ? BlockCompressor::GetBlockSize(Format.BlockFormat) : Format.Channels == 3 ? 12 : 4;
+        for (std::size_t levelIndex = Levels.size(); levelIndex-- > 0; )
+        {
+            PadTo(contents, levelAlignment);
+            const std::vector<unsigned char>& levelPixels = Levels[levelIndex].Pixels;
+            const std::uint64_t levelIndexEntry[3] = { contents.size(), levelPixels.size(), levelPixels.size() };
+            std::memcpy(contents.data() + BakedTextureFile::HEADER_SIZE + levelIndex * BakedTextureFile::LEVEL_INDEX_ENTRY_SIZE, levelIndexEntry,
+                sizeof(levelIndexEntry));
+            contents.insert(contents.end(), levelPixels.begin(), levelPixels.end());
+        }
+
+        // write to a temporary file first, so an interrupted write never leaves a truncated file under the real name
+        const std::string temporaryFilePath = BakedFilePath + ".tmp";
+        {
+            std::ofstream bakedFile(temporaryFilePath, std::ios::binary | std::ios::trunc);
+            bakedFile.write(reinterpret_cast<const char*>(contents.data()), static_cast<std::streamsize>(contents.size()));
+            if (!bakedFile)
+            {
+                return false;
+            }
+        }
+
+        std::error_code errorCode;
+        std::filesystem::rename(temporaryFilePath, BakedFilePath, errorCode);
+        if (errorCode)
+        {
+            std::filesystem::remove(temporaryFilePath, errorCode);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    inline static bool bEnabled = true;
+};
+#endif
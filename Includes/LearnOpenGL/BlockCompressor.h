@@ -0,0 +1,734 @@
+#ifndef BLOCK_COMPRESSOR_H
+#define BLOCK_COMPRESSOR_H
+
+#include <glad/glad.h>
+
+#include "LearnOpenGL/GLExtensions.h"
+#include "LearnOpenGL/MipChainGenerator.h"
+#include "LearnOpenGL/ParallelFor.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include <thread>
+#include <utility>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BLOCK_COMPRESSOR_SSE2
+#endif
+
+
+enum class EBlockFormat : unsigned int
+{
+    // opaque RGB, 4 bits per texel
+    BC1,
+    // RGBA: BC1 color plus BC4 alpha, 8 bits per texel
+    BC3,
+    // single channel, 4 bits per texel
+    BC4,
+    // two BC4 channels (e.g. normal map XY), 8 bits per texel
+    BC5,
+    // RGBA, 8 bits per texel; encoded in mode 6 only (one endpoint pair of RGBA 7.7.7.7 + p bits, 16 levels), still well above BC3
+    BC7
+};
+
+enum class EBlockCompressionQuality : unsigned int
+{
+    // bounding box endpoints, levels by projection on the endpoint line
+    Fast,
+    // principal axis endpoints, levels by the least error, one least squares refinement of the endpoints
+    Normal,
+    // like Normal, with more refinement rounds
+    High
+};
+
+struct BlockCompressionOptions
+{
+    EBlockFormat Format = EBlockFormat::BC1;
+    EBlockCompressionQuality Quality = EBlockCompressionQuality::Normal;
+    // 0 uses all the cores
+    unsigned int ThreadsCount = 0;
+};
+
+/*
+ * Encoder of the BCn formats desktop GPUs sample natively, so textures take 4 to 8 times less memory & bandwidth than in RGB(A)8.
+ * Every 4x4 block is fitted with an endpoint pair per group of channels, and each texel gets the level (point between the
+ * endpoints) closest to it; the SSE2 kernels work on 4 texels at a time, and rows of blocks are split between threads.
+ * Blocks of sRGB textures are encoded as they are stored, i.e. errors are measured in sRGB.
+ */
+class BlockCompressor
+{
+public:
+    // Compresses the tightly packed 8 bit image (channels it lacks are read as GL does: green & blue 0, alpha 255); partial blocks at the edges repeat the edge texels
+    static std::vector<unsigned char> Compress(const unsigned char* Pixels, int Width, int Height, int Channels,
+        const BlockCompressionOptions& Options = BlockCompressionOptions())
+    {
+        const int blocksCountX = (Width + 3) / 4;
+        const int blocksCountY = (Height + 3) / 4;
+        const std::size_t blockSize = GetBlockSize(Options.Format);
+        const unsigned int threadsCount = Options.ThreadsCount != 0 ? Options.ThreadsCount : std::max(std::thread::hardware_concurrency(), 1u);
+
+        std::vector<unsigned char> blocks(GetCompressedSize(Options.Format, Width, Height));
+        ParallelFor(blocksCountY, threadsCount, MIN_BLOCK_ROWS_PER_THREAD, [&](int FirstBlockRow, int EndBlockRow)
+        {
+            Block block;
+            for (int blockY = FirstBlockRow; blockY < EndBlockRow; ++blockY)
+            {
+                for (int blockX = 0; blockX < blocksCountX; ++blockX)
+                {
+                    LoadBlock(Pixels, Width, Height, Channels, blockX * 4, blockY * 4, block);
+                    EncodeBlock(block, Options, blocks.data() + (static_cast<std::size_t>(blockY) * blocksCountX + blockX) * blockSize);
+                }
+            }
+        });
+
+        return blocks;
+    }
+
+    // Level 0 plus the mip levels of the image (as generated by MipChainGenerator), all compressed; Pixels of the returned levels hold the blocks
+    static std::vector<MipLevel> CompressMipChain(const unsigned char* Pixels, int Width, int Height, int Channels, const std::vector<MipLevel>& MipLevels,
+        const BlockCompressionOptions& Options = BlockCompressionOptions())
+    {
+        std::vector<MipLevel> compressedLevels;
+        compressedLevels.push_back({ Width, Height, Compress(Pixels, Width, Height, Channels, Options) });
+        for (const MipLevel& mipLevel : MipLevels)
+        {
+            compressedLevels.push_back({ mipLevel.Width, mipLevel.Height, Compress(mipLevel.Pixels.data(), mipLevel.Width, mipLevel.Height, Channels, Options) });
+        }
+        return compressedLevels;
+    }
+
+    static std::size_t GetBlockSize(EBlockFormat Format)
+    {
+        return Format == EBlockFormat::BC1 || Format == EBlockFormat::BC4 ? 8 : 16;
+    }
+
+    static std::size_t GetCompressedSize(EBlockFormat Format, int Width, int Height)
+    {
+        return static_cast<std::size_t>((Width + 3) / 4) * ((Height + 3) / 4) * GetBlockSize(Format);
+    }
+
+    // Channels the format stores
+    static int GetChannels(EBlockFormat Format)
+    {
+        switch (Format)
+        {
+            case EBlockFormat::BC1: return 3;
+            case EBlockFormat::BC4: return 1;
+            case EBlockFormat::BC5: return 2;
+            default: return 4;
+        }
+    }
+
+    // Format keeping all the channels of an image: BC4 & BC5 for 1 & 2 channels, BC1 for RGB, BC7 for RGBA (BC3 where BC7 isn't available)
+    static EBlockFormat ChooseFormat(int Channels, bool bBC7Available)
+    {
+        switch (Channels)
+        {
+            case 1: return EBlockFormat::BC4;
+            case 2: return EBlockFormat::BC5;
+            case 3: return EBlockFormat::BC1;
+            default: return bBC7Available ? EBlockFormat::BC7 : EBlockFormat::BC3;
+        }
+    }
+
+    // sRGB only applies to the color formats (BC1, BC3 & BC7)
+    static GLenum GetInternalFormat(EBlockFormat Format, bool bSRGB)
+    {
+        switch (Format)
+        {
+            case EBlockFormat::BC1: return bSRGB ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+            case EBlockFormat::BC3: return bSRGB ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            case EBlockFormat::BC4: return GL_COMPRESSED_RED_RGTC1;
+            case EBlockFormat::BC5: return GL_COMPRESSED_RG_RGTC2;
+            default: return bSRGB ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+        }
+    }
+
+    // Whether textures of the format can be created in the current context (relies on GLExtensions::Load for everything but BC4/BC5)
+    static bool IsSupported(EBlockFormat Format, bool bSRGB)
+    {
+        switch (Format)
+        {
+            case EBlockFormat::BC1:
+            case EBlockFormat::BC3: return bSRGB ? GLExtensions::bHasTextureCompressionS3TCSrgb : GLExtensions::bHasTextureCompressionS3TC;
+            case EBlockFormat::BC4:
+            case EBlockFormat::BC5: return true;
+            default: return GLExtensions::bHasTextureCompressionBPTC;
+        }
+    }
+
+private:
+    static constexpr int MIN_BLOCK_ROWS_PER_THREAD = 4;
+    static constexpr int BLOCK_TEXELS_COUNT = 16;
+    static constexpr int MAX_LEVELS_COUNT = 16;
+
+    // Texels of a 4x4 block, one array per channel, so the kernels can work on 4 texels at a time
+    struct Block
+    {
+        alignas(16) float Channels[4][BLOCK_TEXELS_COUNT];
+    };
+
+    // How endpoints of a channels group are stored, which also decides the levels between them
+    enum class EEndpointEncoding : unsigned int
+    {
+        // BC1 color: 5.6.5 bits, 4 levels
+        Rgb565,
+        // BC4 channel (BC3 alpha, BC5 channels): 8 bits, 8 levels
+        Unorm8,
+        // BC7 mode 6: 7 bits per channel plus a p bit per endpoint (its lowest bit in all channels), 16 levels
+        Rgba7PBit
+    };
+
+    // Endpoint values as the GPU decodes them (0-255), for the channels of the group
+    struct EndpointPair
+    {
+        float First[4] = {};
+        float Second[4] = {};
+    };
+
+    static void LoadBlock(const unsigned char* Pixels, int Width, int Height, int Channels, int FirstX, int FirstY, Block& OutBlock)
+    {
+        for (int texelIndex = 0; texelIndex < BLOCK_TEXELS_COUNT; ++texelIndex)
+        {
+            const int x = std::min(FirstX + texelIndex % 4, Width - 1);
+            const int y = std::min(FirstY + texelIndex / 4, Height - 1);
+            const unsigned char* pixel = Pixels + (static_cast<std::size_t>(y) * Width + x) * Channels;
+            for (int channel = 0; channel < 4; ++channel)
+            {
+                OutBlock.Channels[channel][texelIndex] = channel < Channels ? pixel[channel] : channel == 3 ? 255.0f : 0.0f;
+            }
+        }
+    }
+
+    static void EncodeBlock(const Block& SourceBlock, const BlockCompressionOptions& Options, unsigned char* OutBlock)
+    {
+        static constexpr int RGB_CHANNELS[3] = { 0, 1, 2 };
+        static constexpr int RGBA_CHANNELS[4] = { 0, 1, 2, 3 };
+        static constexpr int RED_CHANNEL[1] = { 0 };
+        static constexpr int GREEN_CHANNEL[1] = { 1 };
+        static constexpr int ALPHA_CHANNEL[1] = { 3 };
+
+        EndpointPair endpoints;
+        unsigned char levels[BLOCK_TEXELS_COUNT];
+        switch (Options.Format)
+        {
+            case EBlockFormat::BC1:
+                EncodeEndpoints(SourceBlock, RGB_CHANNELS, 3, EEndpointEncoding::Rgb565, Options.Quality, endpoints, levels);
+                WriteColorBlock(endpoints, levels, OutBlock);
+                break;
+            case EBlockFormat::BC3:
+                EncodeEndpoints(SourceBlock, ALPHA_CHANNEL, 1, EEndpointEncoding::Unorm8, Options.Quality, endpoints, levels);
+                WriteChannelBlock(endpoints, levels, OutBlock);
+                EncodeEndpoints(SourceBlock, RGB_CHANNELS, 3, EEndpointEncoding::Rgb565, Options.Quality, endpoints, levels);
+                WriteColorBlock(endpoints, levels, OutBlock + 8);
+                break;
+            case EBlockFormat::BC4:
+                EncodeEndpoints(SourceBlock, RED_CHANNEL, 1, EEndpointEncoding::Unorm8, Options.Quality, endpoints, levels);
+                WriteChannelBlock(endpoints, levels, OutBlock);
+                break;
+            case EBlockFormat::BC5:
+                EncodeEndpoints(SourceBlock, RED_CHANNEL, 1, EEndpointEncoding::Unorm8, Options.Quality, endpoints, levels);
+                WriteChannelBlock(endpoints, levels, OutBlock);
+                EncodeEndpoints(SourceBlock, GREEN_CHANNEL, 1, EEndpointEncoding::Unorm8, Options.Quality, endpoints, levels);
+                WriteChannelBlock(endpoints, levels, OutBlock + 8);
+                break;
+            case EBlockFormat::BC7:
+                EncodeEndpoints(SourceBlock, RGBA_CHANNELS, 4, EEndpointEncoding::Rgba7PBit, Options.Quality, endpoints, levels);
+                WriteMode6Block(endpoints, levels, OutBlock);
+                break;
+        }
+    }
+
+    // Weight of the second endpoint in every level, levels going from the first endpoint to the second one
+    static const float* GetLevelWeights(EEndpointEncoding Encoding, int& OutLevelsCount)
+    {
+        static constexpr float RGB565_WEIGHTS[4] = { 0.0f, 1.0f / 3.0f, 2.0f / 3.0f, 1.0f };
+        static constexpr float UNORM8_WEIGHTS[8] = { 0.0f, 1.0f / 7.0f, 2.0f / 7.0f, 3.0f / 7.0f, 4.0f / 7.0f, 5.0f / 7.0f, 6.0f / 7.0f, 1.0f };
+        static constexpr float RGBA7_PBIT_WEIGHTS[16] = { 0.0f / 64.0f, 4.0f / 64.0f, 9.0f / 64.0f, 13.0f / 64.0f, 17.0f / 64.0f, 21.0f / 64.0f, 26.0f / 64.0f,
+            30.0f / 64.0f, 34.0f / 64.0f, 38.0f / 64.0f, 43.0f / 64.0f, 47.0f / 64.0f, 51.0f / 64.0f, 55.0f / 64.0f, 60.0f / 64.0f, 64.0f / 64.0f };
+
+        switch (Encoding)
+        {
+            case EEndpointEncoding::Rgb565: OutLevelsCount = 4; return RGB565_WEIGHTS;
+            case EEndpointEncoding::Unorm8: OutLevelsCount = 8; return UNORM8_WEIGHTS;
+            default: OutLevelsCount = 16; return RGBA7_PBIT_WEIGHTS;
+        }
+    }
+
+    // Fits the endpoints of the channels group & picks the level of every texel; quality decides how hard the fit is refined
+    static void EncodeEndpoints(const Block& SourceBlock, const int* ChannelIndices, int ChannelsCount, EEndpointEncoding Encoding,
+        EBlockCompressionQuality Quality, EndpointPair& OutEndpoints, unsigned char* OutLevels)
+    {
+        int levelsCount = 0;
+        const float* levelWeights = GetLevelWeights(Encoding, levelsCount);
+
+        const EndpointPair fittedEndpoints = Quality == EBlockCompressionQuality::Fast ? FitBoundingBox(SourceBlock, ChannelIndices, ChannelsCount) :
+            FitPrincipalAxis(SourceBlock, ChannelIndices, ChannelsCount);
+        OutEndpoints = QuantizeEndpoints(fittedEndpoints, ChannelsCount, Encoding);
+        if (Quality == EBlockCompressionQuality::Fast)
+        {
+            ProjectLevels(SourceBlock, ChannelIndices, ChannelsCount, OutEndpoints, levelsCount, OutLevels);
+            return;
+        }
+
+        float error = FindClosestLevels(SourceBlock, ChannelIndices, ChannelsCount, OutEndpoints, levelWeights, levelsCount, OutLevels);
+        const int refinementsCount = Quality == EBlockCompressionQuality::High ? 4 : 1;
+        for (int refinementIndex = 0; refinementIndex < refinementsCount && error > 0.0f; ++refinementIndex)
+        {
+            EndpointPair refinedEndpoints;
+            if (!RefineEndpoints(SourceBlock, ChannelIndices, ChannelsCount, levelWeights, OutLevels, refinedEndpoints))
+            {
+                return;
+            }
+            refinedEndpoints = QuantizeEndpoints(refinedEndpoints, ChannelsCount, Encoding);
+
+            unsigned char refinedLevels[BLOCK_TEXELS_COUNT];
+            const float refinedError = FindClosestLevels(SourceBlock, ChannelIndices, ChannelsCount, refinedEndpoints, levelWeights, levelsCount, refinedLevels);
+            if (refinedError >= error)
+            {
+                return;
+            }
+            error = refinedError;
+            OutEndpoints = refinedEndpoints;
+            std::memcpy(OutLevels, refinedLevels, sizeof(refinedLevels));
+        }
+    }
+
+    // Corners of the bounding box, inset a bit (extremes are rarely worth a level of their own); the diagonal follows the sign of the channel correlations
+    static EndpointPair FitBoundingBox(const Block& SourceBlock, const int* ChannelIndices, int ChannelsCount)
+    {
+        float minimums[4];
+        float maximums[4];
+        float means[4];
+        for (int channel = 0; channel < ChannelsCount; ++channel)
+        {
+            const float* values = SourceBlock.Channels[ChannelIndices[channel]];
+            minimums[channel] = *std::min_element(values, values + BLOCK_TEXELS_COUNT);
+            maximums[channel] = *std::max_element(values, values + BLOCK_TEXELS_COUNT);
+            means[channel] = (minimums[channel] + maximums[channel]) * 0.5f;
+        }
+
+        // the widest channel leads, the others run against it where they're anti-correlated
+        int leadingChannel = 0;
+        for (int channel = 1; channel < ChannelsCount; ++channel)
+        {
+            if (maximums[channel] - minimums[channel] > maximums[leadingChannel] - minimums[leadingChannel])
+            {
+                leadingChannel = channel;
+            }
+        }
+
+        EndpointPair endpoints;
+        for (int channel = 0; channel < ChannelsCount; ++channel)
+        {
+            float covariance = 0.0f;
+            for (int texelIndex = 0; texelIndex < BLOCK_TEXELS_COUNT; ++texelIndex)
+            {
+                covariance += (SourceBlock.Channels[ChannelIndices[channel]][texelIndex] - means[channel]) *
+                    (SourceBlock.Channels[ChannelIndices[leadingChannel]][texelIndex] - means[leadingChannel]);
+            }
+
+            const float inset = (maximums[channel] - minimums[channel]) / 16.0f;
+            endpoints.First[channel] = minimums[channel] + inset;
+            endpoints.Second[channel] = maximums[channel] - inset;
+            if (covariance < 0.0f)
+            {
+                std::swap(endpoints.First[channel], endpoints.Second[channel]);
+            }
+        }
+        return endpoints;
+    }
+
+    // Extremes of the texels along their principal axis (power iteration on the covariance matrix)
+    static EndpointPair FitPrincipalAxis(const Block& SourceBlock, const int* ChannelIndices, int ChannelsCount)
+    {
+        constexpr int POWER_ITERATIONS_COUNT = 8;
+
+        float means[4] = {};
+        for (int channel = 0; channel < ChannelsCount; ++channel)
+        {
+            const float* values = SourceBlock.Channels[ChannelIndices[channel]];
+            for (int texelIndex = 0; texelIndex < BLOCK_TEXELS_COUNT; ++texelIndex)
+            {
+                means[channel] += values[texelIndex];
+            }
+            means[channel] /= BLOCK_TEXELS_COUNT;
+        }
+
+        float covariances[4][4] = {};
+        for (int row = 0; row < ChannelsCount; ++row)
+        {
+            for (int column = row; column < ChannelsCount; ++column)
+            {
+                float covariance = 0.0f;
+                for (int texelIndex = 0; texelIndex < BLOCK_TEXELS_COUNT; ++texelIndex)
+                {
+                    covariance += (SourceBlock.Channels[ChannelIndices[row]][texelIndex] - means[row]) *
+                        (SourceBlock.Channels[ChannelIndices[column]][texelIndex] - means[column]);
+                }
+                covariances[row][column] = covariances[column][row] = covariance;
+            }
+        }
+
+        float axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        for (int iteration = 0; iteration < POWER_ITERATIONS_COUNT; ++iteration)
+        {
+            float nextAxis[4] = {};
+            float largestComponent = 0.0f;
+            for (int row = 0; row < ChannelsCount; ++row)
+            {
+                for (int column = 0; column < ChannelsCount; ++column)
+                {
+                    nextAxis[row] += covariances[row][column] * axis[column];
+                }
+                largestComponent = std::max(largestComponent, std::abs(nextAxis[row]));
+            }
+            // flat block, any axis does
+            if (largestComponent == 0.0f)
+            {
+                break;
+            }
+            for (int channel = 0; channel < ChannelsCount; ++channel)
+            {
+                axis[channel] = nextAxis[channel] / largestComponent;
+            }
+        }
+
+        float axisLengthSquared = 0.0f;
+        for (int channel = 0; channel < ChannelsCount; ++channel)
+        {
+            axisLengthSquared += axis[channel] * axis[channel];
+        }
+
+        float minimumPosition = 0.0f;
+        float maximumPosition = 0.0f;
+        for (int texelIndex = 0; texelIndex < BLOCK_TEXELS_COUNT; ++texelIndex)
+        {
+            float position = 0.0f;
+            for (int channel = 0; channel < ChannelsCount; ++channel)
+            {
+                position += (SourceBlock.Channels[ChannelIndices[channel]][texelIndex] - means[channel]) * axis[channel];
+            }
+            minimumPosition = std::min(minimumPosition, position / axisLengthSquared);
+            maximumPosition = std::max(maximumPosition, position / axisLengthSquared);
+        }
+
+        EndpointPair endpoints;
+        for (int channel = 0; channel < ChannelsCount; ++channel)
+        {
+            endpoints.First[channel] = std::clamp(means[channel] + axis[channel] * minimumPosition, 0.0f, 255.0f);
+            endpoints.Second[channel] = std::clamp(means[channel] + axis[channel] * maximumPosition, 0.0f, 255.0f);
+        }
+        return endpoints;
+    }
+
+    // Least squares endpoints for the levels the texels got (per channel, as levels share their weights across channels); false if all texels sit on one level
+    static bool RefineEndpoints(const Block& SourceBlock, const int* ChannelIndices, int ChannelsCount, const float* LevelWeights, const unsigned char* Levels,
+        EndpointPair& OutEndpoints)
+    {
+        float firstWeightsSum = 0.0f;
+        float crossWeightsSum = 0.0f;
+        float secondWeightsSum = 0.0f;
+        float firstSums[4] = {};
+        float secondSums[4] = {};
+        for (int texelIndex = 0; texelIndex < BLOCK_TEXELS_COUNT; ++texelIndex)
+        {
+            const float secondWeight = LevelWeights[Levels[texelIndex]];
+            const float firstWeight = 1.0f - secondWeight;
+            firstWeightsSum += firstWeight * firstWeight;
+            crossWeightsSum += firstWeight * secondWeight;
+            secondWeightsSum += secondWeight * secondWeight;
+            for (int channel = 0; channel < ChannelsCount; ++channel)
+            {
+                firstSums[channel] += firstWeight * SourceBlock.Channels[ChannelIndices[channel]][texelIndex];
+                secondSums[channel] += secondWeight * SourceBlock.Channels[ChannelIndices[channel]][texelIndex];
+            }
+        }
+
+        const float determinant = firstWeightsSum * secondWeightsSum - crossWeightsSum * crossWeightsSum;
+        if (std::abs(determinant) < 1e-6f)
+        {
+            return false;
+        }
+
+        for (int channel = 0; channel < ChannelsCount; ++channel)
+        {
+            OutEndpoints.First[channel] = std::clamp((secondWeightsSum * firstSums[channel] - crossWeightsSum * secondSums[channel]) / determinant, 0.0f, 255.0f);
+            OutEndpoints.Second[channel] = std::clamp((firstWeightsSum * secondSums[channel] - crossWeightsSum * firstSums[channel]) / determinant, 0.0f, 255.0f);
+        }
+        return true;
+    }
+
+    // Rounds the endpoints to what the encoding can store, returning the values the GPU decodes them to
+    static EndpointPair QuantizeEndpoints(const EndpointPair& Endpoints, int ChannelsCount, EEndpointEncoding Encoding)
+    {
+        EndpointPair quantizedEndpoints;
+        for (int endpointIndex = 0; endpointIndex < 2; ++endpointIndex)
+        {
+            const float* values = endpointIndex == 0 ? Endpoints.First : Endpoints.Second;
+            float* quantizedValues = endpointIndex == 0 ? quantizedEndpoints.First : quantizedEndpoints.Second;
+            if (Encoding == EEndpointEncoding::Rgb565)
+            {
+                for (int channel = 0; channel < ChannelsCount; ++channel)
+                {
+                    // bits get replicated into the low ones on decode
+                    const int bitsCount = channel == 1 ? 6 : 5;
+                    const int maximum = (1 << bitsCount) - 1;
+                    const int value = static_cast<int>(values[channel] * maximum / 255.0f + 0.5f);
+                    quantizedValues[channel] = static_cast<float>((value << (8 - bitsCount)) | (value >> (2 * bitsCount - 8)));
+                }
+            }
+            else if (Encoding == EEndpointEncoding::Unorm8)
+            {
+                for (int channel = 0; channel < ChannelsCount; ++channel)
+                {
+                    quantizedValues[channel] = std::floor(values[channel] + 0.5f);
+                }
+            }
+            else
+            {
+                // the p bit is shared by all channels of the endpoint, so it's picked by the error it leaves
+                float bestError = 0.0f;
+                for (int pBit = 0; pBit < 2; ++pBit)
+                {
+                    float candidateValues[4];
+                    float error = 0.0f;
+                    for (int channel = 0; channel < ChannelsCount; ++channel)
+                    {
+                        const int value = std::clamp(static_cast<int>((values[channel] - pBit) / 2.0f + 0.5f), 0, 127);
+                        candidateValues[channel] = static_cast<float>((value << 1) | pBit);
+                        error += (candidateValues[channel] - values[channel]) * (candidateValues[channel] - values[channel]);
+                    }
+                    if (pBit == 0 || error < bestError)
+                    {
+                        bestError = error;
+                        std::copy(candidateValues, candidateValues + ChannelsCount, quantizedValues);
+                    }
+                }
+            }
+        }
+        return quantizedEndpoints;
+    }
+
+    // Level of every texel by its position along the endpoint line (levels are spread evenly enough for rounding to be nearly exact)
+    static void ProjectLevels(const Block& SourceBlock, const int* ChannelIndices, int ChannelsCount, const EndpointPair& Endpoints, int LevelsCount,
+        unsigned char* OutLevels)
+    {
+        float direction[4];
+        float directionLengthSquared = 0.0f;
+        for (int channel = 0; channel < ChannelsCount; ++channel)
+        {
+            direction[channel] = Endpoints.Second[channel] - Endpoints.First[channel];
+            directionLengthSquared += direction[channel] * direction[channel];
+        }
+        if (directionLengthSquared == 0.0f)
+        {
+            std::memset(OutLevels, 0, BLOCK_TEXELS_COUNT);
+            return;
+        }
+        const float scale = (LevelsCount - 1) / directionLengthSquared;
+
+#ifdef BLOCK_COMPRESSOR_SSE2
+        for (int texelIndex = 0; texelIndex < BLOCK_TEXELS_COUNT; texelIndex += 4)
+        {
+            __m128 position = _mm_setzero_ps();
+            for (int channel = 0; channel < ChannelsCount; ++channel)
+            {
+                const __m128 offset = _mm_sub_ps(_mm_load_ps(SourceBlock.Channels[ChannelIndices[channel]] + texelIndex), _mm_set1_ps(Endpoints.First[channel]));
+                position = _mm_add_ps(position, _mm_mul_ps(offset, _mm_set1_ps(direction[channel])));
+            }
+            position = _mm_add_ps(_mm_mul_ps(position, _mm_set1_ps(scale)), _mm_set1_ps(0.5f));
+            position = _mm_min_ps(_mm_max_ps(position, _mm_setzero_ps()), _mm_set1_ps(static_cast<float>(LevelsCount - 1)));
+
+            alignas(16) std::int32_t levels[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(levels), _mm_cvttps_epi32(position));
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                OutLevels[texelIndex + lane] = static_cast<unsigned char>(levels[lane]);
+            }
+        }
+#else
+        for (int texelIndex = 0; texelIndex < BLOCK_TEXELS_COUNT; ++texelIndex)
+        {
+            float position = 0.0f;
+            for (int channel = 0; channel < ChannelsCount; ++channel)
+            {
+                position += (SourceBlock.Channels[ChannelIndices[channel]][texelIndex] - Endpoints.First[channel]) * direction[channel];
+            }
+            OutLevels[texelIndex] = static_cast<unsigned char>(std::clamp(position * scale + 0.5f, 0.0f, static_cast<float>(LevelsCount - 1)));
+        }
+#endif
+    }
+
+    // Level closest to every texel; returns the squared error of the whole block
+    static float FindClosestLevels(const Block& SourceBlock, const int* ChannelIndices, int ChannelsCount, const EndpointPair& Endpoints, const float* LevelWeights,
+        int LevelsCount, unsigned char* OutLevels)
+    {
+        float palette[MAX_LEVELS_COUNT][4];
+        for (int level = 0; level < LevelsCount; ++level)
+        {
+            for (int channel = 0; channel < ChannelsCount; ++channel)
+            {
+                palette[level][channel] = Endpoints.First[channel] + (Endpoints.Second[channel] - Endpoints.First[channel]) * LevelWeights[level];
+            }
+        }
+
+#ifdef BLOCK_COMPRESSOR_SSE2
+        __m128 blockError = _mm_setzero_ps();
+        for (int texelIndex = 0; texelIndex < BLOCK_TEXELS_COUNT; texelIndex += 4)
+        {
+            __m128 texels[4];
+            for (int channel = 0; channel < ChannelsCount; ++channel)
+            {
+                texels[channel] = _mm_load_ps(SourceBlock.Channels[ChannelIndices[channel]] + texelIndex);
+            }
+
+            __m128 bestErrors = _mm_set1_ps(1e30f);
+            __m128 bestLevels = _mm_setzero_ps();
+            for (int level = 0; level < LevelsCount; ++level)
+            {
+                __m128 errors = _mm_setzero_ps();
+                for (int channel = 0; channel < ChannelsCount; ++channel)
+                {
+                    const __m128 difference = _mm_sub_ps(texels[channel], _mm_set1_ps(palette[level][channel]));
+                    errors = _mm_add_ps(errors, _mm_mul_ps(difference, difference));
+                }
+                const __m128 isBetter = _mm_cmplt_ps(errors, bestErrors);
+                bestErrors = _mm_min_ps(errors, bestErrors);
+                bestLevels = _mm_or_ps(_mm_and_ps(isBetter, _mm_set1_ps(static_cast<float>(level))), _mm_andnot_ps(isBetter, bestLevels));
+            }
+            blockError = _mm_add_ps(blockError, bestErrors);
+
+            alignas(16) std::int32_t levels[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(levels), _mm_cvttps_epi32(bestLevels));
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                OutLevels[texelIndex + lane] = static_cast<unsigned char>(levels[lane]);
+            }
+        }
+
+        alignas(16) float laneErrors[4];
+        _mm_store_ps(laneErrors, blockError);
+        return laneErrors[0] + laneErrors[1] + laneErrors[2] + laneErrors[3];
+#else
+        float blockError = 0.0f;
+        for (int texelIndex = 0; texelIndex < BLOCK_TEXELS_COUNT; ++texelIndex)
+        {
+            float bestError = 1e30f;
+            for (int level = 0; level < LevelsCount; ++level)
+            {
+                float error = 0.0f;
+                for (int channel = 0; channel < ChannelsCount; ++channel)
+                {
+                    const float difference = SourceBlock.Channels[ChannelIndices[channel]][texelIndex] - palette[level][channel];
+                    error += difference * difference;
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    OutLevels[texelIndex] = static_cast<unsigned char>(level);
+                }
+            }
+            blockError += bestError;
+        }
+        return blockError;
+#endif
+    }
+
+    // BC1 block (also the color half of BC3): two 5.6.5 colors, the first one greater for the 4 level mode, then 2 bit indices
+    static void WriteColorBlock(const EndpointPair& Endpoints, const unsigned char* Levels, unsigned char* OutBlock)
+    {
+        static constexpr std::uint32_t LEVEL_INDICES[4] = { 0, 2, 3, 1 };
+
+        const auto packColor = [](const float* Color)
+        {
+            return static_cast<std::uint16_t>(((static_cast<int>(Color[0]) >> 3) << 11) | ((static_cast<int>(Color[1]) >> 2) << 5) | (static_cast<int>(Color[2]) >> 3));
+        };
+        std::uint16_t colors[2] = { packColor(Endpoints.First), packColor(Endpoints.Second) };
+
+        // equal colors leave every texel on the first one
+        std::uint32_t indices = 0;
+        if (colors[0] != colors[1])
+        {
+            const bool bSwapped = colors[0] < colors[1];
+            if (bSwapped)
+            {
+                std::swap(colors[0], colors[1]);
+            }
+            for (int texelIndex = 0; texelIndex < BLOCK_TEXELS_COUNT; ++texelIndex)
+            {
+                indices |= LEVEL_INDICES[bSwapped ? 3 - Levels[texelIndex] : Levels[texelIndex]] << (2 * texelIndex);
+            }
+        }
+
+        std::memcpy(OutBlock, colors, sizeof(colors));
+        std::memcpy(OutBlock + sizeof(colors), &indices, sizeof(indices));
+    }
+
+    // BC4 block (also the alpha half of BC3 & either half of BC5): two values, the first one greater for the 8 level mode, then 3 bit indices
+    static void WriteChannelBlock(const EndpointPair& Endpoints, const unsigned char* Levels, unsigned char* OutBlock)
+    {
+        static constexpr std::uint64_t LEVEL_INDICES[8] = { 0, 2, 3, 4, 5, 6, 7, 1 };
+
+        unsigned char values[2] = { static_cast<unsigned char>(Endpoints.First[0]), static_cast<unsigned char>(Endpoints.Second[0]) };
+        std::uint64_t indices = 0;
+        if (values[0] != values[1])
+        {
+            const bool bSwapped = values[0] < values[1];
+            if (bSwapped)
+            {
+                std::swap(values[0], values[1]);
+            }
+            for (int texelIndex = 0; texelIndex < BLOCK_TEXELS_COUNT; ++texelIndex)
+            {
+                indices |= LEVEL_INDICES[bSwapped ? 7 - Levels[texelIndex] : Levels[texelIndex]] << (3 * texelIndex);
+            }
+        }
+
+        OutBlock[0] = values[0];
+        OutBlock[1] = values[1];
+        for (int byteIndex = 0; byteIndex < 6; ++byteIndex)
+        {
+            OutBlock[2 + byteIndex] = static_cast<unsigned char>(indices >> (8 * byteIndex));
+        }
+    }
+
+    // BC7 mode 6 block: mode bits, RGBA endpoints, p bits, then 4 bit indices, the first texel's one having its top bit implied 0
+    static void WriteMode6Block(const EndpointPair& Endpoints, const unsigned char* Levels, unsigned char* OutBlock)
+    {
+        const bool bSwapped = Levels[0] >= 8;
+        const float* first = bSwapped ? Endpoints.Second : Endpoints.First;
+        const float* second = bSwapped ? Endpoints.First : Endpoints.Second;
+
+        std::uint64_t bits[2] = {};
+        int bitPosition = 0;
+        const auto writeBits = [&bits, &bitPosition](std::uint64_t Value, int BitsCount)
+        {
+            for (int bitIndex = 0; bitIndex < BitsCount; ++bitIndex, ++bitPosition)
+            {
+                bits[bitPosition / 64] |= ((Value >> bitIndex) & 1) << (bitPosition % 64);
+            }
+        };
+
+        writeBits(1 << 6, 7);
+        for (int channel = 0; channel < 4; ++channel)
+        {
+            writeBits(static_cast<std::uint64_t>(first[channel]) >> 1, 7);
+            writeBits(static_cast<std::uint64_t>(second[channel]) >> 1, 7);
+        }
+        writeBits(static_cast<std::uint64_t>(first[0]) & 1, 1);
+        writeBits(static_cast<std::uint64_t>(second[0]) & 1, 1);
+        for (int texelIndex = 0; texelIndex < BLOCK_TEXELS_COUNT; ++texelIndex)
+        {
+            writeBits(bSwapped ? 15 - Levels[texelIndex] : Levels[texelIndex], texelIndex == 0 ? 3 : 4);
+        }
+
+        std::memcpy(OutBlock, bits, sizeof(bits));
+    }
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,876 @@
+#ifndef FAST_INFLATE_H
+#define FAST_INFLATE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FAST_INFLATE_SSE2
+#endif
+
+
+/*
+ * DEFLATE decoder (zlib streams, RFC 1950 & 1951) which stb_image's PNG decoder goes through instead of its own (see stb_image.cpp).
+ * Huffman codes are looked up LITERAL_LENGTH_TABLE_BITS bits at a time, in tables whose entries hold one or two literals, or a
+ * length or distance base with its extra bits count, so most symbols take a single lookup; longer codes go through subtables.
+ * Bits come from a 64 bit buffer refilled with a word at a time, enough for a whole length/distance pair, and matches are copied
+ * a word at a time. Valid streams decode to the very same bytes as with stb_image's decoder, which doesn't check the Adler-32
+ * checksum at the end of zlib streams though; it's checked here unless turned off with SetChecksumVerified, for trusted assets.
+ */
+class FastInflate
+{
+public:
+    // Where a stream is decompressed to: Size bytes in use out of Capacity. Grown with Reallocate (which keeps the contents) when the
+    // stream doesn't fit, or fixed when it's nullptr. Bytes between Size & Capacity may get overwritten.
+    struct OutputBuffer
+    {
+        unsigned char* Data = nullptr;
+        std::size_t Size = 0;
+        std::size_t Capacity = 0;
+        unsigned char* (*Reallocate)(unsigned char* Memory, std::size_t OldSize, std::size_t NewSize) = nullptr;
+    };
+
+    // Decompresses a zlib stream (raw DEFLATE data without bZlibHeader) after Output's contents; on failure, OutFailureReason gets
+    // the reason in stb_image's words
+    static bool Inflate(const unsigned char* Input, std::size_t InputSize, bool bZlibHeader, bool bVerifyChecksum, OutputBuffer& Output,
+        const char*& OutFailureReason)
+    {
+        if (bZlibHeader)
+        {
+            if (!ReadZlibHeader(Input, InputSize, OutFailureReason))
+            {
+                return false;
+            }
+            Input += 2;
+            InputSize -= 2;
+        }
+
+        const std::size_t streamStart = Output.Size;
+        BitReader reader { Input, Input + InputSize };
+        bool bFinalBlock = false;
+        do
+        {
+            if (!reader.Refill())
+            {
+                OutFailureReason = "outofdata";
+                return false;
+            }
+            bFinalBlock = reader.Take(1) != 0;
+            const unsigned int blockType = reader.Take(2);
+            if (blockType == 0)
+            {
+                if (!CopyStoredBlock(reader, Output, OutFailureReason))
+                {
+                    return false;
+                }
+            }
+            else if (blockType == 1)
+            {
+                if (!DecodeBlock(reader, GetFixedTables(), Output, OutFailureReason))
+                {
+                    return false;
+                }
+            }
+            else if (blockType == 2)
+            {
+                HuffmanTables tables;
+                if (!ReadDynamicTables(reader, tables, OutFailureReason) || !DecodeBlock(reader, tables, Output, OutFailureReason))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                OutFailureReason = "bad block type";
+                return false;
+            }
+        } while (!bFinalBlock);
+
+        if (bZlibHeader && bVerifyChecksum)
+        {
+            // big endian Adler-32 of the decompressed data, right after the last block
+            if (!reader.AlignToByte() || reader.InputEnd - reader.Input < 4)
+            {
+                OutFailureReason = "bad zlib checksum";
+                return false;
+            }
+            const std::uint32_t checksum = static_cast<std::uint32_t>(reader.Input[0]) << 24 | static_cast<std::uint32_t>(reader.Input[1]) << 16 |
+                static_cast<std::uint32_t>(reader.Input[2]) << 8 | reader.Input[3];
+            if (ComputeAdler32(Output.Data + streamStart, Output.Size - streamStart) != checksum)
+            {
+                OutFailureReason = "bad zlib checksum";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Adler-32 checksum of zlib streams (RFC 1950)
+    static std::uint32_t ComputeAdler32(const unsigned char* Data, std::size_t Size)
+    {
+        std::uint32_t sumA = 1;
+        std::uint32_t sumB = 0;
+        while (Size > 0)
+        {
+            std::size_t blockSize = std::min(Size, ADLER32_BLOCK_SIZE);
+            Size -= blockSize;
+#ifdef FAST_INFLATE_SSE2
+            // over 32 bytes, B grows by 32 times A as it was before them, plus each byte times the number of sums it's part of (32 to 1);
+            // even & odd bytes are weighted apart, masking & shifting them to 16 bits keeps unpacking off the shuffle port psadbw needs
+            const std::size_t groupsCount = blockSize / 32;
+            if (groupsCount > 0)
+            {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i lowBytesMask = _mm_set1_epi16(0xFF);
+                const __m128i firstEvenWeights = _mm_setr_epi16(32, 30, 28, 26, 24, 22, 20, 18);
+                const __m128i firstOddWeights = _mm_setr_epi16(31, 29, 27, 25, 23, 21, 19, 17);
+                const __m128i secondEvenWeights = _mm_setr_epi16(16, 14, 12, 10, 8, 6, 4, 2);
+                const __m128i secondOddWeights = _mm_setr_epi16(15, 13, 11, 9, 7, 5, 3, 1);
+                __m128i bytesSums = zero;
+                __m128i previousBytesSums = zero;
+                __m128i firstWeightedSums = zero;
+                __m128i secondWeightedSums = zero;
+                for (std::size_t groupIndex = 0; groupIndex < groupsCount; ++groupIndex)
+                {
+                    const __m128i firstBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Data));
+                    const __m128i secondBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Data + 16));
+                    previousBytesSums = _mm_add_epi32(previousBytesSums, bytesSums);
+                    bytesSums = _mm_add_epi32(bytesSums, _mm_add_epi32(_mm_sad_epu8(firstBytes, zero), _mm_sad_epu8(secondBytes, zero)));
+                    firstWeightedSums = _mm_add_epi32(firstWeightedSums, _mm_add_epi32(_mm_madd_epi16(_mm_and_si128(firstBytes, lowBytesMask), firstEvenWeights),
+                        _mm_madd_epi16(_mm_srli_epi16(firstBytes, 8), firstOddWeights)));
+                    secondWeightedSums = _mm_add_epi32(secondWeightedSums, _mm_add_epi32(_mm_madd_epi16(_mm_and_si128(secondBytes, lowBytesMask),
+                        secondEvenWeights), _mm_madd_epi16(_mm_srli_epi16(secondBytes, 8), secondOddWeights)));
+                    Data += 32;
+                }
+                const std::uint64_t newSumB = sumB + static_cast<std::uint64_t>(sumA) * 32 * groupsCount + 32 * SumLanes(previousBytesSums) +
+                    SumLanes(firstWeightedSums) + SumLanes(secondWeightedSums);
+                sumA += static_cast<std::uint32_t>(SumLanes(bytesSums));
+                sumB = static_cast<std::uint32_t>(newSumB % ADLER32_MODULUS);
+                blockSize -= groupsCount * 32;
+            }
+#endif
+            for (; blockSize > 0; --blockSize)
+            {
+                sumA += *Data++;
+                sumB += sumA;
+            }
+            sumA %= ADLER32_MODULUS;
+            sumB %= ADLER32_MODULUS;
+        }
+        return sumB << 16 | sumA;
+    }
+
+    static bool IsChecksumVerified()
+    {
+        return bChecksumVerified;
+    }
+
+    // Checksums are verified by default; skipping them (e.g. when only loading assets shipped with the application) only affects
+    // streams decoded afterwards
+    static void SetChecksumVerified(bool bNewVerified)
+    {
+        bChecksumVerified = bNewVerified;
+    }
+
+private:
+    static constexpr int LITERAL_LENGTH_TABLE_BITS = 11;
+    static constexpr int DISTANCE_TABLE_BITS = 8;
+    static constexpr int CODE_LENGTH_TABLE_BITS = 7;
+    static constexpr int MAX_CODE_LENGTH = 15;
+    static constexpr int LITERAL_LENGTH_SYMBOLS_COUNT = 288;
+    static constexpr int DISTANCE_SYMBOLS_COUNT = 32;
+    static constexpr int CODE_LENGTH_SYMBOLS_COUNT = 19;
+    // root table, then at most a subtable per symbol with a code longer than the root's bits
+    static constexpr int LITERAL_LENGTH_TABLE_SIZE = (1 << LITERAL_LENGTH_TABLE_BITS) +
+        LITERAL_LENGTH_SYMBOLS_COUNT * (1 << (MAX_CODE_LENGTH - LITERAL_LENGTH_TABLE_BITS));
+    static constexpr int DISTANCE_TABLE_SIZE = (1 << DISTANCE_TABLE_BITS) + DISTANCE_SYMBOLS_COUNT * (1 << (MAX_CODE_LENGTH - DISTANCE_TABLE_BITS));
+    // matches are copied 16 bytes at a time, so the word copies stay within the output buffer when there's that much room past the match
+    static constexpr std::size_t MATCH_COPY_SLACK = 16;
+    static constexpr std::uint32_t ADLER32_MODULUS = 65521;
+    // the most bytes the sums can take in before overflowing 32 bits
+    static constexpr std::size_t ADLER32_BLOCK_SIZE = 5552;
+
+    /*
+     * Table entries: bits 0-7 are the bits the entry's code(s) take, 8-11 the extra bits count after the code (or the subtable's
+     * index bits), 12-15 the kind of entry and 16-31 its value: literal byte(s), length/distance base or subtable offset.
+     */
+    enum EEntryKind : std::uint32_t
+    {
+        Literal,
+        // two literals in a row, the first one in the low byte of the value
+        LiteralPair,
+        // length or distance: base value plus extra bits
+        BaseValue,
+        EndOfBlock,
+        Subtable,
+        Invalid
+    };
+
+    struct HuffmanTables
+    {
+        std::uint32_t LiteralLength[LITERAL_LENGTH_TABLE_SIZE];
+        std::uint32_t Distance[DISTANCE_TABLE_SIZE];
+    };
+
+    // LSB first bit reader; past the end of the data, it reads zero bytes, which is fine as long as none of their bits get used
+    struct BitReader
+    {
+        const unsigned char* Input;
+        const unsigned char* InputEnd;
+        // bits above BitsCount may already hold the next input bytes, ORing them in again leaves them as they are
+        std::uint64_t Buffer = 0;
+        unsigned int BitsCount = 0;
+        std::size_t PaddingBytes = 0;
+
+        // Makes sure at least 56 bits are buffered, enough for any literal/length code, its extra bits, distance code & extra bits;
+        // fails once bits past the end of the data were used
+        bool Refill()
+        {
+            if (InputEnd - Input >= 8)
+            {
+                std::uint64_t word;
+                std::memcpy(&word, Input, sizeof(word));
+                Buffer |= word << BitsCount;
+                Input += (63 - BitsCount) >> 3;
+                BitsCount |= 56;
+                return true;
+            }
+            if (PaddingBytes * 8 > BitsCount)
+            {
+                return false;
+            }
+            while (BitsCount <= 56)
+            {
+                std::uint64_t byte = 0;
+                if (Input < InputEnd)
+                {
+                    byte = *Input++;
+                }
+                else
+                {
+                    ++PaddingBytes;
+                }
+                Buffer |= byte << BitsCount;
+                BitsCount += 8;
+            }
+            return true;
+        }
+
+        void Consume(unsigned int Count)
+        {
+            Buffer >>= Count;
+            BitsCount -= Count;
+        }
+
+        unsigned int Take(unsigned int Count)
+        {
+            const unsigned int value = static_cast<unsigned int>(Buffer & ((std::uint64_t(1) << Count) - 1));
+            Consume(Count);
+            return value;
+        }
+
+        bool IsPastEnd() const
+        {
+            return PaddingBytes * 8 > BitsCount;
+        }
+
+        // Drops the bits left in the current byte & gives back the whole bytes buffered, so the data can be read bytewise from Input
+        bool AlignToByte()
+        {
+            Consume(BitsCount & 7);
+            std::size_t bufferedBytes = BitsCount >> 3;
+            const std::size_t bufferedPaddingBytes = std::min(bufferedBytes, PaddingBytes);
+            PaddingBytes -= bufferedPaddingBytes;
+            bufferedBytes -= bufferedPaddingBytes;
+            Input -= bufferedBytes;
+            Buffer = 0;
+            BitsCount = 0;
+            return PaddingBytes == 0;
+        }
+    };
+
+    static constexpr std::uint32_t MakeEntry(std::uint32_t Kind, std::uint32_t Value, std::uint32_t ExtraBitsCount, std::uint32_t CodeBitsCount)
+    {
+        return CodeBitsCount | ExtraBitsCount << 8 | Kind << 12 | Value << 16;
+    }
+
+    static unsigned int GetCodeBitsCount(std::uint32_t Entry)
+    {
+        return Entry & 0xFF;
+    }
+
+    static unsigned int GetExtraBitsCount(std::uint32_t Entry)
+    {
+        return (Entry >> 8) & 0xF;
+    }
+
+    static std::uint32_t GetKind(std::uint32_t Entry)
+    {
+        return (Entry >> 12) & 0xF;
+    }
+
+    static unsigned int GetValue(std::uint32_t Entry)
+    {
+        return Entry >> 16;
+    }
+
+    static bool ReadZlibHeader(const unsigned char* Input, std::size_t InputSize, const char*& OutFailureReason)
+    {
+        // same checks as stb_image, which wants more than the header too
+        if (InputSize <= 2 || (Input[0] * 256 + Input[1]) % 31 != 0)
+        {
+            OutFailureReason = "bad zlib header";
+            return false;
+        }
+        // PNG doesn't allow preset dictionaries
+        if ((Input[1] & 32) != 0)
+        {
+            OutFailureReason = "no preset dict";
+            return false;
+        }
+        if ((Input[0] & 15) != 8)
+        {
+            OutFailureReason = "bad compression";
+            return false;
+        }
+        return true;
+    }
+
+    // Makes room for Count more bytes after the first Size ones (Output.Data may move)
+    static bool ReserveOutput(OutputBuffer& Output, std::size_t Size, std::size_t Count, const char*& OutFailureReason)
+    {
+        if (Output.Capacity - Size >= Count)
+        {
+            return true;
+        }
+        if (Output.Reallocate == nullptr)
+        {
+            OutFailureReason = "output buffer limit";
+            return false;
+        }
+
+        std::size_t capacity = std::max<std::size_t>(Output.Capacity, 1);
+        while (capacity - Size < Count)
+        {
+            if (capacity > SIZE_MAX / 2)
+            {
+                OutFailureReason = "outofmem";
+                return false;
+            }
+            capacity *= 2;
+        }
+        unsigned char* data = Output.Reallocate(Output.Data, Output.Capacity, capacity);
+        if (data == nullptr)
+        {
+            OutFailureReason = "outofmem";
+            return false;
+        }
+        Output.Data = data;
+        Output.Capacity = capacity;
+        return true;
+    }
+
+    static bool CopyStoredBlock(BitReader& Reader, OutputBuffer& Output, const char*& OutFailureReason)
+    {
+        if (!Reader.AlignToByte())
+        {
+            OutFailureReason = "outofdata";
+            return false;
+        }
+        if (Reader.InputEnd - Reader.Input < 4 || (Reader.Input[0] ^ Reader.Input[2]) != 0xFF || (Reader.Input[1] ^ Reader.Input[3]) != 0xFF)
+        {
+            OutFailureReason = "zlib corrupt";
+            return false;
+        }
+        const std::size_t length = Reader.Input[0] | Reader.Input[1] << 8;
+        Reader.Input += 4;
+        if (static_cast<std::size_t>(Reader.InputEnd - Reader.Input) < length)
+        {
+            OutFailureReason = "read past buffer";
+            return false;
+        }
+
+        if (!ReserveOutput(Output, Output.Size, length, OutFailureReason))
+        {
+            return false;
+        }
+        if (length > 0)
+        {
+            std::memcpy(Output.Data + Output.Size, Reader.Input, length);
+        }
+        Reader.Input += length;
+        Output.Size += length;
+        return true;
+    }
+
+    static void CopyWord(unsigned char* Destination, const unsigned char* Source)
+    {
+        std::uint64_t word;
+        std::memcpy(&word, Source, sizeof(word));
+        std::memcpy(Destination, &word, sizeof(word));
+    }
+
+    // Copies Length bytes from Distance bytes back, writing up to MATCH_COPY_SLACK bytes past them
+    static void CopyMatch(unsigned char* Output, std::size_t Distance, std::size_t Length)
+    {
+        unsigned char* const outputEnd = Output + Length;
+        if (Distance == 1)
+        {
+            std::memset(Output, Output[-1], Length);
+        }
+        else if (Distance >= 8)
+        {
+            // each word is read after all the bytes it holds are written
+            const unsigned char* source = Output - Distance;
+            do
+            {
+                CopyWord(Output, source);
+                CopyWord(Output + 8, source + 8);
+                Output += 16;
+                source += 16;
+            } while (Output < outputEnd);
+        }
+        else
+        {
+            // the pattern is shorter than a word: it's written a copy at a time (only the first Distance bytes of each word being right)
+            // until a word's worth of whole copies is behind, which then get repeated a word at a time
+            const std::size_t wordDistance = (8 + Distance - 1) / Distance * Distance;
+            unsigned char* const patternEnd = Output + wordDistance - Distance;
+            while (Output < patternEnd)
+            {
+                CopyWord(Output, Output - Distance);
+                Output += Distance;
+            }
+            while (Output < outputEnd)
+            {
+                CopyWord(Output, Output - wordDistance);
+                Output += 8;
+            }
+        }
+    }
+
+    // Decodes a symbol with the table's root & subtable lookups
+    static std::uint32_t DecodeEntry(const std::uint32_t* Table, int TableBits, BitReader& Reader)
+    {
+        std::uint32_t entry = Table[Reader.Buffer & ((1u << TableBits) - 1)];
+        if (GetKind(entry) == Subtable)
+        {
+            Reader.Consume(TableBits);
+            entry = Table[GetValue(entry) + (Reader.Buffer & ((1u << GetExtraBitsCount(entry)) - 1))];
+        }
+        Reader.Consume(GetCodeBitsCount(entry));
+        return entry;
+    }
+
+    static bool DecodeBlock(BitReader& Reader, const HuffmanTables& Tables, OutputBuffer& Output, const char*& OutFailureReason)
+    {
+        // the state lives in locals while decoding: written bytes could alias anything reached through a pointer or a reference
+        BitReader reader = Reader;
+        unsigned char* outputStart = Output.Data;
+        unsigned char* output = outputStart + Output.Size;
+        unsigned char* outputEnd = outputStart + Output.Capacity;
+        const char* failureReason = nullptr;
+        for (;;)
+        {
+            if (!reader.Refill())
+            {
+                failureReason = "outofdata";
+                break;
+            }
+
+            const std::uint32_t entry = DecodeEntry(Tables.LiteralLength, LITERAL_LENGTH_TABLE_BITS, reader);
+            const std::uint32_t kind = GetKind(entry);
+            if (kind <= LiteralPair)
+            {
+                // both bytes of the value get written, the second one is only kept for a pair
+                const unsigned int value = GetValue(entry);
+                const std::size_t literalsCount = 1 + kind;
+                if (outputEnd - output < 2)
+                {
+                    const std::size_t size = static_cast<std::size_t>(output - outputStart);
+                    if (!ReserveOutput(Output, size, literalsCount, failureReason))
+                    {
+                        break;
+                    }
+                    outputStart = Output.Data;
+                    output = outputStart + size;
+                    outputEnd = outputStart + Output.Capacity;
+                    if (outputEnd - output < 2)
+                    {
+                        *output++ = static_cast<unsigned char>(value);
+                        continue;
+                    }
+                }
+                output[0] = static_cast<unsigned char>(value);
+                output[1] = static_cast<unsigned char>(value >> 8);
+                output += literalsCount;
+                continue;
+            }
+            if (kind == EndOfBlock)
+            {
+                if (reader.IsPastEnd())
+                {
+                    failureReason = "outofdata";
+                }
+                break;
+            }
+            if (kind != BaseValue)
+            {
+                failureReason = "bad huffman code";
+                break;
+            }
+
+            const std::size_t length = GetValue(entry) + reader.Take(GetExtraBitsCount(entry));
+            const std::uint32_t distanceEntry = DecodeEntry(Tables.Distance, DISTANCE_TABLE_BITS, reader);
+            if (GetKind(distanceEntry) != BaseValue)
+            {
+                failureReason = "bad huffman code";
+                break;
+            }
+            const std::size_t distance = GetValue(distanceEntry) + reader.Take(GetExtraBitsCount(distanceEntry));
+            if (distance > static_cast<std::size_t>(output - outputStart))
+            {
+                failureReason = "bad dist";
+                break;
+            }
+
+            if (static_cast<std::size_t>(outputEnd - output) >= length + MATCH_COPY_SLACK)
+            {
+                CopyMatch(output, distance, length);
+            }
+            else
+            {
+                // close to the end of the buffer (usually the last few bytes of an image), bytes are copied one at a time
+                const std::size_t size = static_cast<std::size_t>(output - outputStart);
+                if (!ReserveOutput(Output, size, length, failureReason))
+                {
+                    break;
+                }
+                outputStart = Output.Data;
+                output = outputStart + size;
+                outputEnd = outputStart + Output.Capacity;
+                for (std::size_t byteIndex = 0; byteIndex < length; ++byteIndex)
+                {
+                    output[byteIndex] = output[byteIndex - distance];
+                }
+            }
+            output += length;
+        }
+
+        Reader = reader;
+        Output.Size = static_cast<std::size_t>(output - outputStart);
+        if (failureReason != nullptr)
+        {
+            OutFailureReason = failureReason;
+            return false;
+        }
+        return true;
+    }
+
+    static int ReverseBits(int Code, int BitsCount)
+    {
+        int reversedCode = 0;
+        for (int bitIndex = 0; bitIndex < BitsCount; ++bitIndex)
+        {
+            reversedCode = (reversedCode << 1) | ((Code >> bitIndex) & 1);
+        }
+        return reversedCode;
+    }
+
+    // Fills the lookup table of the canonical code with the given lengths (RFC 1951 3.2.2): SymbolEntries are the symbols' entries
+    // without their code bits
+    static bool BuildTable(const unsigned char* CodeLengths, int SymbolsCount, const std::uint32_t* SymbolEntries, int TableBits, std::uint32_t* Table,
+        int TableCapacity, const char*& OutFailureReason)
+    {
+        int lengthsCounts[MAX_CODE_LENGTH + 1] = {};
+        for (int symbol = 0; symbol < SymbolsCount; ++symbol)
+        {
+            ++lengthsCounts[CodeLengths[symbol]];
+        }
+        lengthsCounts[0] = 0;
+
+        // incomplete codes are fine, over-subscribed ones get rejected like stb_image does
+        int nextCodes[MAX_CODE_LENGTH + 1];
+        int sortedOffsets[MAX_CODE_LENGTH + 1];
+        int code = 0;
+        int codesCount = 0;
+        for (int length = 1; length <= MAX_CODE_LENGTH; ++length)
+        {
+            if (lengthsCounts[length] > (1 << length))
+            {
+                OutFailureReason = "bad sizes";
+                return false;
+            }
+            nextCodes[length] = code;
+            sortedOffsets[length] = codesCount;
+            code += lengthsCounts[length];
+            if (lengthsCounts[length] != 0 && code - 1 >= (1 << length))
+            {
+                OutFailureReason = "bad codelengths";
+                return false;
+            }
+            code <<= 1;
+            codesCount += lengthsCounts[length];
+        }
+
+        // symbols in the order of their codes: by length, then by value
+        int sortedSymbols[LITERAL_LENGTH_SYMBOLS_COUNT];
+        int sortedCodes[LITERAL_LENGTH_SYMBOLS_COUNT];
+        for (int symbol = 0; symbol < SymbolsCount; ++symbol)
+        {
+            const int length = CodeLengths[symbol];
+            if (length != 0)
+            {
+                sortedSymbols[sortedOffsets[length]] = symbol;
+                sortedCodes[sortedOffsets[length]++] = nextCodes[length]++;
+            }
+        }
+
+        const int rootSize = 1 << TableBits;
+        std::fill(Table, Table + rootSize, MakeEntry(Invalid, 0, 0, 0));
+        int tableSize = rootSize;
+        int subtablePrefix = -1;
+        int subtableOffset = 0;
+        int subtableBits = 0;
+        for (int codeIndex = 0; codeIndex < codesCount; ++codeIndex)
+        {
+            const int symbol = sortedSymbols[codeIndex];
+            const int length = CodeLengths[symbol];
+            const int symbolCode = sortedCodes[codeIndex];
+            if (length <= TableBits)
+            {
+                // the entry repeats for every value of the bits after the code
+                for (int index = ReverseBits(symbolCode, length); index < rootSize; index += 1 << length)
+                {
+                    Table[index] = SymbolEntries[symbol] | static_cast<std::uint32_t>(length);
+                }
+                continue;
+            }
+
+            const int prefixCode = symbolCode >> (length - TableBits);
+            if (prefixCode != subtablePrefix)
+            {
+                // codes sharing the first TableBits bits follow each other, the longest last: it gives the subtable's size
+                int lastCodeIndex = codeIndex;
+                while (lastCodeIndex + 1 < codesCount &&
+                    sortedCodes[lastCodeIndex + 1] >> (CodeLengths[sortedSymbols[lastCodeIndex + 1]] - TableBits) == prefixCode)
+                {
+                    ++lastCodeIndex;
+                }
+                subtablePrefix = prefixCode;
+                subtableOffset = tableSize;
+                subtableBits = CodeLengths[sortedSymbols[lastCodeIndex]] - TableBits;
+                if (tableSize + (1 << subtableBits) > TableCapacity)
+                {
+                    OutFailureReason = "bad codelengths";
+                    return false;
+                }
+                std::fill(Table + tableSize, Table + tableSize + (1 << subtableBits), MakeEntry(Invalid, 0, 0, 0));
+                tableSize += 1 << subtableBits;
+                Table[ReverseBits(prefixCode, TableBits)] = MakeEntry(Subtable, static_cast<std::uint32_t>(subtableOffset),
+                    static_cast<std::uint32_t>(subtableBits), static_cast<std::uint32_t>(TableBits));
+            }
+            const int subcodeLength = length - TableBits;
+            for (int index = ReverseBits(symbolCode & ((1 << subcodeLength) - 1), subcodeLength); index < (1 << subtableBits); index += 1 << subcodeLength)
+            {
+                Table[subtableOffset + index] = SymbolEntries[symbol] | static_cast<std::uint32_t>(subcodeLength);
+            }
+        }
+        return true;
+    }
+
+    static bool BuildLiteralLengthTable(const unsigned char* CodeLengths, int SymbolsCount, std::uint32_t* Table, const char*& OutFailureReason)
+    {
+        static constexpr std::uint32_t LENGTH_BASES[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115,
+            131, 163, 195, 227, 258 };
+        static constexpr std::uint32_t LENGTH_EXTRA_BITS[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+        std::uint32_t symbolEntries[LITERAL_LENGTH_SYMBOLS_COUNT];
+        for (int symbol = 0; symbol < LITERAL_LENGTH_SYMBOLS_COUNT; ++symbol)
+        {
+            if (symbol < 256)
+            {
+                symbolEntries[symbol] = MakeEntry(Literal, static_cast<std::uint32_t>(symbol), 0, 0);
+            }
+            else if (symbol == 256)
+            {
+                symbolEntries[symbol] = MakeEntry(EndOfBlock, 0, 0, 0);
+            }
+            else if (symbol < 286)
+            {
+                symbolEntries[symbol] = MakeEntry(BaseValue, LENGTH_BASES[symbol - 257], LENGTH_EXTRA_BITS[symbol - 257], 0);
+            }
+            else
+            {
+                symbolEntries[symbol] = MakeEntry(Invalid, 0, 0, 0);
+            }
+        }
+        if (!BuildTable(CodeLengths, SymbolsCount, symbolEntries, LITERAL_LENGTH_TABLE_BITS, Table, LITERAL_LENGTH_TABLE_SIZE, OutFailureReason))
+        {
+            return false;
+        }
+
+        // where a literal's code leaves room in the index for the whole code of another one, the entry gets both; going down the
+        // root table, the entry of the second code (the index bits after the first code) is always still a single one
+        for (int index = (1 << LITERAL_LENGTH_TABLE_BITS) - 1; index >= 0; --index)
+        {
+            const std::uint32_t firstEntry = Table[index];
+            if (GetKind(firstEntry) != Literal)
+            {
+                continue;
+            }
+            const unsigned int firstCodeBits = GetCodeBitsCount(firstEntry);
+            const std::uint32_t secondEntry = Table[index >> firstCodeBits];
+            const unsigned int codeBits = firstCodeBits + GetCodeBitsCount(secondEntry);
+            if (GetKind(secondEntry) == Literal && codeBits <= LITERAL_LENGTH_TABLE_BITS)
+            {
+                Table[index] = MakeEntry(LiteralPair, GetValue(firstEntry) | GetValue(secondEntry) << 8, 0, codeBits);
+            }
+        }
+        return true;
+    }
+
+    static bool BuildDistanceTable(const unsigned char* CodeLengths, int SymbolsCount, std::uint32_t* Table, const char*& OutFailureReason)
+    {
+        static constexpr std::uint32_t DISTANCE_BASES[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537,
+            2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+        static constexpr std::uint32_t DISTANCE_EXTRA_BITS[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12,
+            13, 13 };
+
+        std::uint32_t symbolEntries[DISTANCE_SYMBOLS_COUNT];
+        for (int symbol = 0; symbol < DISTANCE_SYMBOLS_COUNT; ++symbol)
+        {
+            symbolEntries[symbol] = symbol < 30 ? MakeEntry(BaseValue, DISTANCE_BASES[symbol], DISTANCE_EXTRA_BITS[symbol], 0) : MakeEntry(Invalid, 0, 0, 0);
+        }
+        return BuildTable(CodeLengths, SymbolsCount, symbolEntries, DISTANCE_TABLE_BITS, Table, DISTANCE_TABLE_SIZE, OutFailureReason);
+    }
+
+    static const HuffmanTables& GetFixedTables()
+    {
+        static const HuffmanTables fixedTables = []()
+        {
+            // RFC 1951 3.2.6
+            unsigned char codeLengths[LITERAL_LENGTH_SYMBOLS_COUNT + DISTANCE_SYMBOLS_COUNT];
+            std::fill(codeLengths, codeLengths + 144, static_cast<unsigned char>(8));
+            std::fill(codeLengths + 144, codeLengths + 256, static_cast<unsigned char>(9));
+            std::fill(codeLengths + 256, codeLengths + 280, static_cast<unsigned char>(7));
+            std::fill(codeLengths + 280, codeLengths + LITERAL_LENGTH_SYMBOLS_COUNT, static_cast<unsigned char>(8));
+            std::fill(codeLengths + LITERAL_LENGTH_SYMBOLS_COUNT, codeLengths + LITERAL_LENGTH_SYMBOLS_COUNT + DISTANCE_SYMBOLS_COUNT, static_cast<unsigned char>(5));
+
+            HuffmanTables tables;
+            const char* failureReason = nullptr;
+            BuildLiteralLengthTable(codeLengths, LITERAL_LENGTH_SYMBOLS_COUNT, tables.LiteralLength, failureReason);
+            BuildDistanceTable(codeLengths + LITERAL_LENGTH_SYMBOLS_COUNT, DISTANCE_SYMBOLS_COUNT, tables.Distance, failureReason);
+            return tables;
+        }();
+        return fixedTables;
+    }
+
+    static bool ReadDynamicTables(BitReader& Reader, HuffmanTables& OutTables, const char*& OutFailureReason)
+    {
+        static constexpr unsigned char CODE_LENGTH_ORDER[CODE_LENGTH_SYMBOLS_COUNT] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+        if (!Reader.Refill())
+        {
+            OutFailureReason = "outofdata";
+            return false;
+        }
+        const int literalLengthCodesCount = static_cast<int>(Reader.Take(5)) + 257;
+        const int distanceCodesCount = static_cast<int>(Reader.Take(5)) + 1;
+        const int codeLengthCodesCount = static_cast<int>(Reader.Take(4)) + 4;
+
+        unsigned char codeLengthCodeLengths[CODE_LENGTH_SYMBOLS_COUNT] = {};
+        for (int codeIndex = 0; codeIndex < codeLengthCodesCount; ++codeIndex)
+        {
+            if (!Reader.Refill())
+            {
+                OutFailureReason = "outofdata";
+                return false;
+            }
+            codeLengthCodeLengths[CODE_LENGTH_ORDER[codeIndex]] = static_cast<unsigned char>(Reader.Take(3));
+        }
+        std::uint32_t codeLengthSymbolEntries[CODE_LENGTH_SYMBOLS_COUNT];
+        for (int symbol = 0; symbol < CODE_LENGTH_SYMBOLS_COUNT; ++symbol)
+        {
+            codeLengthSymbolEntries[symbol] = MakeEntry(Literal, static_cast<std::uint32_t>(symbol), 0, 0);
+        }
+        // code length codes are 7 bits at most, so the root table covers them all
+        std::uint32_t codeLengthTable[1 << CODE_LENGTH_TABLE_BITS];
+        if (!BuildTable(codeLengthCodeLengths, CODE_LENGTH_SYMBOLS_COUNT, codeLengthSymbolEntries, CODE_LENGTH_TABLE_BITS, codeLengthTable,
+            1 << CODE_LENGTH_TABLE_BITS, OutFailureReason))
+        {
+            return false;
+        }
+
+        const int codesCount = literalLengthCodesCount + distanceCodesCount;
+        unsigned char codeLengths[LITERAL_LENGTH_SYMBOLS_COUNT + DISTANCE_SYMBOLS_COUNT];
+        int codeIndex = 0;
+        while (codeIndex < codesCount)
+        {
+            if (!Reader.Refill())
+            {
+                OutFailureReason = "outofdata";
+                return false;
+            }
+            const std::uint32_t entry = DecodeEntry(codeLengthTable, CODE_LENGTH_TABLE_BITS, Reader);
+            if (GetKind(entry) == Invalid)
+            {
+                OutFailureReason = "bad codelengths";
+                return false;
+            }
+
+            const unsigned int symbol = GetValue(entry);
+            if (symbol < 16)
+            {
+                codeLengths[codeIndex++] = static_cast<unsigned char>(symbol);
+                continue;
+            }
+            // 16 repeats the previous length 3-6 times, 17 & 18 repeat zero 3-10 & 11-138 times
+            unsigned char repeatedLength = 0;
+            int repeatsCount = 0;
+            if (symbol == 16)
+            {
+                if (codeIndex == 0)
+                {
+                    OutFailureReason = "bad codelengths";
+                    return false;
+                }
+                repeatedLength = codeLengths[codeIndex - 1];
+                repeatsCount = static_cast<int>(Reader.Take(2)) + 3;
+            }
+            else if (symbol == 17)
+            {
+                repeatsCount = static_cast<int>(Reader.Take(3)) + 3;
+            }
+            else
+            {
+                repeatsCount = static_cast<int>(Reader.Take(7)) + 11;
+            }
+            if (codesCount - codeIndex < repeatsCount)
+            {
+                OutFailureReason = "bad codelengths";
+                return false;
+            }
+            std::memset(codeLengths + codeIndex, repeatedLength, static_cast<std::size_t>(repeatsCount));
+            codeIndex += repeatsCount;
+        }
+
+        return BuildLiteralLengthTable(codeLengths, literalLengthCodesCount, OutTables.LiteralLength, OutFailureReason) &&
+            BuildDistanceTable(codeLengths + literalLengthCodesCount, distanceCodesCount, OutTables.Distance, OutFailureReason);
+    }
+
+#ifdef FAST_INFLATE_SSE2
+    static std::uint64_t SumLanes(__m128i Values)
+    {
+        alignas(16) std::uint32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), Values);
+        return static_cast<std::uint64_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+    }
+#endif
+
+    inline static bool bChecksumVerified = true;
+};
+#endif
\ No newline at end of file
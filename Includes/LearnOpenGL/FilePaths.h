@@ -0,0 +1,24 @@
+#ifndef FILE_PATHS_H
+#define FILE_PATHS_H
+
+#include <string>
+#include <algorithm>
+#include <filesystem>
+
+
+/*
+ * Absolute & lexically normalized path, identifying a file however it was spelled (shader sources, their #includes & watched
+ * files are all keyed by it). The samples' Windows style separators are turned into '/' first, as POSIX paths would otherwise
+ * take "Source\\...\\Shader.vs" for a single file name.
+ */
+inline std::filesystem::path NormalizePath(const std::string& FilePath)
+{
+    std::string separatedFilePath = FilePath;
+#ifndef _WIN32
+    std::replace(separatedFilePath.begin(), separatedFilePath.end(), '\\', '/');
+#endif
+    std::error_code errorCode;
+    const std::filesystem::path absoluteFilePath = std::filesystem::absolute(separatedFilePath, errorCode);
+    return (errorCode ? std::filesystem::path(separatedFilePath) : absoluteFilePath).lexically_normal();
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,239 @@
+#ifndef GL_EXTENSIONS_H
+#define GL_EXTENSIONS_H
+
+#include <glad/glad.h>
+
+#include <cstring>
+
+/*
+ * Entry points & enums newer than the GL 3.3 core profile our glad loader is generated for.
+ * Call GLExtensions::Load right after gladLoadGLLoader; everything that relies on them checks the matching bHas... flag first
+ * and keeps working on the plain 3.3 core path when the extension is missing (or Load was never called).
+ */
+
+// ARB_get_program_binary (core since 4.1)
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_PROGRAM_BINARY_FORMATS 0x87FF
+#endif
+
+// KHR_parallel_shader_compile / ARB_parallel_shader_compile
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+// ARB_buffer_storage (core since 4.4)
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#endif
+
+// ARB_separate_shader_objects (core since 4.1)
+#ifndef GL_PROGRAM_SEPARABLE
+#define GL_VERTEX_SHADER_BIT 0x00000001
+#define GL_FRAGMENT_SHADER_BIT 0x00000002
+#define GL_PROGRAM_SEPARABLE 0x8258
+#define GL_PROGRAM_PIPELINE_BINDING 0x825A
+#endif
+
+// ARB_gl_spirv (core since 4.6)
+#ifndef GL_SHADER_BINARY_FORMAT_SPIR_V_ARB
+#define GL_SHADER_BINARY_FORMAT_SPIR_V_ARB 0x9551
+#define GL_SPIR_V_BINARY_ARB 0x9552
+#endif
+
+// EXT_texture_compression_s3tc, plus its sRGB formats from EXT_texture_sRGB
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
+// ARB_texture_compression_bptc (core since 4.2)
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#define GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM 0x8E8D
+#endif
+
+namespace GLExtensions
+{
+    typedef void (APIENTRYP PFNGETPROGRAMBINARYPROC)(GLuint Program, GLsizei BufferSize, GLsizei* Length, GLenum* BinaryFormat, void* Binary);
+    typedef void (APIENTRYP PFNPROGRAMBINARYPROC)(GLuint Program, GLenum BinaryFormat, const void* Binary, GLsizei Length);
+    typedef void (APIENTRYP PFNPROGRAMPARAMETERIPROC)(GLuint Program, GLenum ParameterName, GLint Value);
+
+    typedef void (APIENTRYP PFNMAXSHADERCOMPILERTHREADSPROC)(GLuint Count);
+
+    typedef void (APIENTRYP PFNBUFFERSTORAGEPROC)(GLenum Target, GLsizeiptr Size, const void* Data, GLbitfield Flags);
+
+    typedef void (APIENTRYP PFNTEXSTORAGE2DPROC)(GLenum Target, GLsizei LevelsCount, GLenum InternalFormat, GLsizei Width, GLsizei Height);
+
+    typedef GLuint (APIENTRYP PFNCREATESHADERPROGRAMVPROC)(GLenum Type, GLsizei Count, const GLchar* const* Strings);
+    typedef void (APIENTRYP PFNGENPROGRAMPIPELINESPROC)(GLsizei Count, GLuint* Pipelines);
+    typedef void (APIENTRYP PFNDELETEPROGRAMPIPELINESPROC)(GLsizei Count, const GLuint* Pipelines);
+    typedef void (APIENTRYP PFNBINDPROGRAMPIPELINEPROC)(GLuint Pipeline);
+    typedef void (APIENTRYP PFNUSEPROGRAMSTAGESPROC)(GLuint Pipeline, GLbitfield Stages, GLuint Program);
+    typedef void (APIENTRYP PFNPROGRAMUNIFORMIVPROC)(GLuint Program, GLint Location, GLsizei Count, const GLint* Values);
+    typedef void (APIENTRYP PFNPROGRAMUNIFORMFVPROC)(GLuint Program, GLint Location, GLsizei Count, const GLfloat* Values);
+    typedef void (APIENTRYP PFNPROGRAMUNIFORMMATRIXFVPROC)(GLuint Program, GLint Location, GLsizei Count, GLboolean bTranspose, const GLfloat* Values);
+
+    typedef void (APIENTRYP PFNSHADERBINARYPROC)(GLsizei Count, const GLuint* Shaders, GLenum BinaryFormat, const void* Binary, GLsizei Length);
+    typedef void (APIENTRYP PFNSPECIALIZESHADERPROC)(GLuint Shader, const GLchar* EntryPoint, GLuint SpecializationConstantsCount,
+        const GLuint* ConstantIndices, const GLuint* ConstantValues);
+
+    inline bool bHasProgramBinary = false;
+    inline PFNGETPROGRAMBINARYPROC GetProgramBinary = nullptr;
+    inline PFNPROGRAMBINARYPROC ProgramBinary = nullptr;
+    inline PFNPROGRAMPARAMETERIPROC ProgramParameteri = nullptr;
+
+    inline bool bHasParallelShaderCompile = false;
+    inline PFNMAXSHADERCOMPILERTHREADSPROC MaxShaderCompilerThreads = nullptr;
+
+    inline bool bHasBufferStorage = false;
+    inline PFNBUFFERSTORAGEPROC BufferStorage = nullptr;
+
+    // ARB_texture_storage (core since 4.2)
+    inline bool bHasTextureStorage = false;
+    inline PFNTEXSTORAGE2DPROC TexStorage2D = nullptr;
+
+    inline bool bHasSeparateShaderObjects = false;
+    inline PFNCREATESHADERPROGRAMVPROC CreateShaderProgramv = nullptr;
+    inline PFNGENPROGRAMPIPELINESPROC GenProgramPipelines = nullptr;
+    inline PFNDELETEPROGRAMPIPELINESPROC DeleteProgramPipelines = nullptr;
+    inline PFNBINDPROGRAMPIPELINEPROC BindProgramPipeline = nullptr;
+    inline PFNUSEPROGRAMSTAGESPROC UseProgramStages = nullptr;
+
+    // glProgramUniform* (part of ARB_separate_shader_objects): set uniforms of any program, without making it current
+    inline bool bHasProgramUniforms = false;
+    inline PFNPROGRAMUNIFORMIVPROC ProgramUniform1iv = nullptr;
+    inline PFNPROGRAMUNIFORMFVPROC ProgramUniform1fv = nullptr;
+    inline PFNPROGRAMUNIFORMFVPROC ProgramUniform2fv = nullptr;
+    inline PFNPROGRAMUNIFORMFVPROC ProgramUniform3fv = nullptr;
+    inline PFNPROGRAMUNIFORMFVPROC ProgramUniform4fv = nullptr;
+    inline PFNPROGRAMUNIFORMMATRIXFVPROC ProgramUniformMatrix3fv = nullptr;
+    inline PFNPROGRAMUNIFORMMATRIXFVPROC ProgramUniformMatrix4fv = nullptr;
+
+    inline bool bHasSpirV = false;
+    inline PFNSHADERBINARYPROC ShaderBinary = nullptr;
+    inline PFNSPECIALIZESHADERPROC SpecializeShader = nullptr;
+
+    // block compressed texture formats (nothing to load, glCompressedTexImage2D is core); RGTC (BC4/BC5) is core since 3.0
+    inline bool bHasTextureCompressionS3TC = false;
+    inline bool bHasTextureCompressionS3TCSrgb = false;
+    inline bool bHasTextureCompressionBPTC = false;
+
+    inline bool IsVersionAtLeast(int Major, int Minor)
+    {
+        GLint contextMajorVersion = 0;
+        GLint contextMinorVersion = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &contextMajorVersion);
+        glGetIntegerv(GL_MINOR_VERSION, &contextMinorVersion);
+        return contextMajorVersion > Major || (contextMajorVersion == Major && contextMinorVersion >= Minor);
+    }
+
+    inline bool IsExtensionSupported(const char* ExtensionName)
+    {
+        GLint extensionsCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionsCount);
+        for (GLint extensionIndex = 0; extensionIndex < extensionsCount; ++extensionIndex)
+        {
+            const char* supportedExtensionName = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, extensionIndex));
+            if (supportedExtensionName != nullptr && std::strcmp(supportedExtensionName, ExtensionName) == 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Loads entry points with the same loader glad was initialized with (e.g. glfwGetProcAddress). Requires a current context.
+    inline void Load(GLADloadproc Loader)
+    {
+        if (IsVersionAtLeast(4, 1) || IsExtensionSupported("GL_ARB_get_program_binary"))
+        {
+            GetProgramBinary = reinterpret_cast<PFNGETPROGRAMBINARYPROC>(Loader("glGetProgramBinary"));
+            ProgramBinary = reinterpret_cast<PFNPROGRAMBINARYPROC>(Loader("glProgramBinary"));
+            ProgramParameteri = reinterpret_cast<PFNPROGRAMPARAMETERIPROC>(Loader("glProgramParameteri"));
+
+            // a driver may expose the extension while supporting no binary formats at all, making it useless for caching
+            GLint binaryFormatsCount = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatsCount);
+            bHasProgramBinary = GetProgramBinary != nullptr && ProgramBinary != nullptr && ProgramParameteri != nullptr && binaryFormatsCount > 0;
+        }
+
+        if (IsExtensionSupported("GL_KHR_parallel_shader_compile"))
+        {
+            MaxShaderCompilerThreads = reinterpret_cast<PFNMAXSHADERCOMPILERTHREADSPROC>(Loader("glMaxShaderCompilerThreadsKHR"));
+        }
+        else if (IsExtensionSupported("GL_ARB_parallel_shader_compile"))
+        {
+            MaxShaderCompilerThreads = reinterpret_cast<PFNMAXSHADERCOMPILERTHREADSPROC>(Loader("glMaxShaderCompilerThreadsARB"));
+        }
+
+        bHasParallelShaderCompile = MaxShaderCompilerThreads != nullptr;
+        if (bHasParallelShaderCompile)
+        {
+            // let the driver pick as many compiler threads as it sees fit
+            MaxShaderCompilerThreads(0xFFFFFFFFu);
+        }
+
+        if (IsVersionAtLeast(4, 4) || IsExtensionSupported("GL_ARB_buffer_storage"))
+        {
+            BufferStorage = reinterpret_cast<PFNBUFFERSTORAGEPROC>(Loader("glBufferStorage"));
+        }
+        bHasBufferStorage = BufferStorage != nullptr;
+
+        if (IsVersionAtLeast(4, 2) || IsExtensionSupported("GL_ARB_texture_storage"))
+        {
+            TexStorage2D = reinterpret_cast<PFNTEXSTORAGE2DPROC>(Loader("glTexStorage2D"));
+        }
+        bHasTextureStorage = TexStorage2D != nullptr;
+
+        if (IsVersionAtLeast(4, 1) || IsExtensionSupported("GL_ARB_separate_shader_objects"))
+        {
+            CreateShaderProgramv = reinterpret_cast<PFNCREATESHADERPROGRAMVPROC>(Loader("glCreateShaderProgramv"));
+            GenProgramPipelines = reinterpret_cast<PFNGENPROGRAMPIPELINESPROC>(Loader("glGenProgramPipelines"));
+            DeleteProgramPipelines = reinterpret_cast<PFNDELETEPROGRAMPIPELINESPROC>(Loader("glDeleteProgramPipelines"));
+            BindProgramPipeline = reinterpret_cast<PFNBINDPROGRAMPIPELINEPROC>(Loader("glBindProgramPipeline"));
+            UseProgramStages = reinterpret_cast<PFNUSEPROGRAMSTAGESPROC>(Loader("glUseProgramStages"));
+
+            ProgramUniform1iv = reinterpret_cast<PFNPROGRAMUNIFORMIVPROC>(Loader("glProgramUniform1iv"));
+            ProgramUniform1fv = reinterpret_cast<PFNPROGRAMUNIFORMFVPROC>(Loader("glProgramUniform1fv"));
+            ProgramUniform2fv = reinterpret_cast<PFNPROGRAMUNIFORMFVPROC>(Loader("glProgramUniform2fv"));
+            ProgramUniform3fv = reinterpret_cast<PFNPROGRAMUNIFORMFVPROC>(Loader("glProgramUniform3fv"));
+            ProgramUniform4fv = reinterpret_cast<PFNPROGRAMUNIFORMFVPROC>(Loader("glProgramUniform4fv"));
+            ProgramUniformMatrix3fv = reinterpret_cast<PFNPROGRAMUNIFORMMATRIXFVPROC>(Loader("glProgramUniformMatrix3fv"));
+            ProgramUniformMatrix4fv = reinterpret_cast<PFNPROGRAMUNIFORMMATRIXFVPROC>(Loader("glProgramUniformMatrix4fv"));
+        }
+        bHasSeparateShaderObjects = CreateShaderProgramv != nullptr && GenProgramPipelines != nullptr && DeleteProgramPipelines != nullptr &&
+            BindProgramPipeline != nullptr && UseProgramStages != nullptr;
+        bHasProgramUniforms = ProgramUniform1iv != nullptr && ProgramUniform1fv != nullptr && ProgramUniform2fv != nullptr && ProgramUniform3fv != nullptr &&
+            ProgramUniform4fv != nullptr && ProgramUniformMatrix3fv != nullptr && ProgramUniformMatrix4fv != nullptr;
+
+        if (IsVersionAtLeast(4, 6))
+        {
+            ShaderBinary = reinterpret_cast<PFNSHADERBINARYPROC>(Loader("glShaderBinary"));
+            SpecializeShader = reinterpret_cast<PFNSPECIALIZESHADERPROC>(Loader("glSpecializeShader"));
+        }
+        else if (IsExtensionSupported("GL_ARB_gl_spirv"))
+        {
+            ShaderBinary = reinterpret_cast<PFNSHADERBINARYPROC>(Loader("glShaderBinary"));
+            SpecializeShader = reinterpret_cast<PFNSPECIALIZESHADERPROC>(Loader("glSpecializeShaderARB"));
+        }
+        bHasSpirV = ShaderBinary != nullptr && SpecializeShader != nullptr;
+
+        bHasTextureCompressionS3TC = IsExtensionSupported("GL_EXT_texture_compression_s3tc");
+        bHasTextureCompressionS3TCSrgb = bHasTextureCompressionS3TC &&
+            (IsExtensionSupported("GL_EXT_texture_sRGB") || IsExtensionSupported("GL_EXT_texture_compression_s3tc_srgb"));
+        bHasTextureCompressionBPTC = IsVersionAtLeast(4, 2) || IsExtensionSupported("GL_ARB_texture_compression_bptc");
+    }
+}
+#endif
@@ -0,0 +1,329 @@
+#ifndef GL_STATE_CACHE_H
+#define GL_STATE_CACHE_H
+
+#include <glad/glad.h>
+
+#include "LearnOpenGL/GLExtensions.h"
+
+#include <cstddef>
+#include <iterator>
+#include <algorithm>
+
+
+struct GLStateCacheStats
+{
+    // bind calls that actually reached the driver
+    unsigned int IssuedCalls = 0;
+    // bind calls skipped, as the requested object was bound already
+    unsigned int ElidedCalls = 0;
+};
+
+// Shadowed binding of GLStateCache; starts as unknown (no GL object has this name), so the first bind always goes through
+struct GLShadowedBinding
+{
+    GLuint ObjectID = 0xFFFFFFFFu;
+};
+
+// Shadowed indexed buffer binding of GLStateCache (negative size stands for the whole buffer)
+struct GLShadowedBufferRange
+{
+    GLShadowedBinding Buffer;
+    GLintptr Offset = 0;
+    GLsizeiptr Size = 0;
+};
+
+/*
+ * Shadow copy of the most frequently rebound GL state (program, program pipeline, VAO, buffers, textures & samplers per unit, indexed uniform
+ * buffer ranges), so binding an already bound object never reaches the driver and doesn't pay for its validation.
+ * All state starts as unknown, so the first bind always goes through. Code binding objects with raw GL calls (or deleting
+ * them) must tell the cache about it via Invalidate / On...Deleted, otherwise the cache would elide binds it shouldn't.
+ */
+class GLStateCache
+{
+public:
+    static void UseProgram(GLuint ProgramID)
+    {
+        if (IsRedundant(CurrentProgram, ProgramID))
+        {
+            return;
+        }
+        glUseProgram(ProgramID);
+    }
+
+    // Program pipeline is only used while no program is current (see ProgramPipeline::Bind)
+    static void BindProgramPipeline(GLuint ProgramPipelineID)
+    {
+        if (IsRedundant(CurrentProgramPipeline, ProgramPipelineID))
+        {
+            return;
+        }
+        GLExtensions::BindProgramPipeline(ProgramPipelineID);
+    }
+
+    static void BindVertexArray(GLuint VertexArrayID)
+    {
+        if (IsRedundant(CurrentVertexArray, VertexArrayID))
+        {
+            return;
+        }
+        glBindVertexArray(VertexArrayID);
+
+        // element array buffer binding is part of the VAO state
+        BoundBuffers[BufferTargetToIndex(GL_ELEMENT_ARRAY_BUFFER)] = GLShadowedBinding();
+    }
+
+    static void BindBuffer(GLenum Target, GLuint BufferID)
+    {
+        const std::size_t targetIndex = BufferTargetToIndex(Target);
+        if (targetIndex < BUFFER_TARGETS_COUNT && IsRedundant(BoundBuffers[targetIndex], BufferID))
+        {
+            return;
+        }
+        if (targetIndex >= BUFFER_TARGETS_COUNT)
+        {
+            ++FrameStats.IssuedCalls;
+        }
+        glBindBuffer(Target, BufferID);
+    }
+
+    // Binds the whole buffer to indexed binding point (generic binding of the target changes as well, as with glBindBufferBase)
+    static void BindBufferBase(GLenum Target, GLuint BindingIndex, GLuint BufferID)
+    {
+        BindBufferRange(Target, BindingIndex, BufferID, 0, WHOLE_BUFFER_SIZE);
+    }
+
+    static void BindBufferRange(GLenum Target, GLuint BindingIndex, GLuint BufferID, GLintptr Offset, GLsizeiptr Size)
+    {
+        const bool bTracked = Target == GL_UNIFORM_BUFFER && BindingIndex < MAX_TRACKED_UNIFORM_BINDINGS;
+        if (bTracked)
+        {
+            GLShadowedBufferRange& boundRange = UniformBufferRanges[BindingIndex];
+            if (boundRange.Buffer.ObjectID == BufferID && boundRange.Offset == Offset && boundRange.Size == Size)
+            {
+                ++FrameStats.ElidedCalls;
+                return;
+            }
+            boundRange = { { BufferID }, Offset, Size };
+        }
+
+        ++FrameStats.IssuedCalls;
+        if (Size == WHOLE_BUFFER_SIZE)
+        {
+            glBindBufferBase(Target, BindingIndex, BufferID);
+        }
+        else
+        {
+            glBindBufferRange(Target, BindingIndex, BufferID, Offset, Size);
+        }
+
+        const std::size_t targetIndex = BufferTargetToIndex(Target);
+        if (targetIndex < BUFFER_TARGETS_COUNT)
+        {
+            BoundBuffers[targetIndex].ObjectID = BufferID;
+        }
+    }
+
+    /*
+     * Makes the unit active (if it isn't already) and binds the texture to it. The unit is activated even if the texture is bound
+     * already, as callers editing the texture (glTexSubImage2D, glTexParameteri...) rely on it being the one the unit targets.
+     */
+    static void BindTexture(GLuint TextureUnit, GLenum Target, GLuint TextureID)
+    {
+        ActiveTexture(TextureUnit);
+
+        const std::size_t targetIndex = TextureTargetToIndex(Target);
+        const bool bTracked = TextureUnit < MAX_TRACKED_TEXTURE_UNITS && targetIndex < TEXTURE_TARGETS_COUNT;
+        if (bTracked && BoundTextures[TextureUnit][targetIndex].ObjectID == TextureID)
+        {
+            ++FrameStats.ElidedCalls;
+            return;
+        }
+
+        ++FrameStats.IssuedCalls;
+        glBindTexture(Target, TextureID);
+        if (bTracked)
+        {
+            BoundTextures[TextureUnit][targetIndex].ObjectID = TextureID;
+        }
+    }
+
+    static void ActiveTexture(GLuint TextureUnit)
+    {
+        if (IsRedundant(ActiveTextureUnit, TextureUnit))
+        {
+            return;
+        }
+        glActiveTexture(GL_TEXTURE0 + TextureUnit);
+    }
+
+    static void BindSampler(GLuint TextureUnit, GLuint SamplerID)
+    {
+        if (TextureUnit < MAX_TRACKED_TEXTURE_UNITS && IsRedundant(BoundSamplers[TextureUnit], SamplerID))
+        {
+            return;
+        }
+        if (TextureUnit >= MAX_TRACKED_TEXTURE_UNITS)
+        {
+            ++FrameStats.IssuedCalls;
+        }
+        glBindSampler(TextureUnit, SamplerID);
+    }
+
+    // Deleted objects get unbound by GL (except a current program, which stays in use until replaced)
+
+    static void OnProgramDeleted(GLuint ProgramID)
+    {
+        if (CurrentProgram.ObjectID == ProgramID)
+        {
+            CurrentProgram = GLShadowedBinding();
+        }
+    }
+
+    static void OnProgramPipelineDeleted(GLuint ProgramPipelineID)
+    {
+        ResetIfBound(CurrentProgramPipeline, ProgramPipelineID);
+    }
+
+    static void OnVertexArrayDeleted(GLuint VertexArrayID)
+    {
+        if (CurrentVertexArray.ObjectID == VertexArrayID)
+        {
+            CurrentVertexArray.ObjectID = 0;
+            BoundBuffers[BufferTargetToIndex(GL_ELEMENT_ARRAY_BUFFER)] = GLShadowedBinding();
+        }
+    }
+
+    static void OnBufferDeleted(GLuint BufferID)
+    {
+        for (GLShadowedBinding& boundBuffer : BoundBuffers)
+        {
+            ResetIfBound(boundBuffer, BufferID);
+        }
+        for (GLShadowedBufferRange& boundRange : UniformBufferRanges)
+        {
+            boundRange = boundRange.Buffer.ObjectID == BufferID ? GLShadowedBufferRange{ { 0 }, 0, 0 } : boundRange;
+        }
+    }
+
+    static void OnTextureDeleted(GLuint TextureID)
+    {
+        for (auto& unitTextures : BoundTextures)
+        {
+            for (GLShadowedBinding& boundTexture : unitTextures)
+            {
+                ResetIfBound(boundTexture, TextureID);
+            }
+        }
+    }
+
+    static void OnSamplerDeleted(GLuint SamplerID)
+    {
+        for (GLShadowedBinding& boundSampler : BoundSamplers)
+        {
+            ResetIfBound(boundSampler, SamplerID);
+        }
+    }
+
+    // Forgets the current program only, e.g. after code that switched programs with raw glUseProgram calls
+    static void InvalidateProgram()
+    {
+        CurrentProgram = GLShadowedBinding();
+    }
+
+    // Forgets all the shadowed state, so the next bind of anything goes to the driver
+    static void Invalidate()
+    {
+        CurrentProgram = GLShadowedBinding();
+        CurrentProgramPipeline = GLShadowedBinding();
+        CurrentVertexArray = GLShadowedBinding();
+        ActiveTextureUnit = GLShadowedBinding();
+        std::fill(std::begin(BoundBuffers), std::end(BoundBuffers), GLShadowedBinding());
+        std::fill(std::begin(UniformBufferRanges), std::end(UniformBufferRanges), GLShadowedBufferRange());
+        for (auto& unitTextures : BoundTextures)
+        {
+            std::fill(std::begin(unitTextures), std::end(unitTextures), GLShadowedBinding());
+        }
+        std::fill(std::begin(BoundSamplers), std::end(BoundSamplers), GLShadowedBinding());
+    }
+
+    // Returns counters accumulated since the last call and starts counting anew (call it once per frame)
+    static GLStateCacheStats ConsumeFrameStats()
+    {
+        const GLStateCacheStats frameStats = FrameStats;
+        FrameStats = GLStateCacheStats();
+        return frameStats;
+    }
+
+private:
+    static constexpr GLsizeiptr WHOLE_BUFFER_SIZE = -1;
+
+    static constexpr std::size_t BUFFER_TARGETS_COUNT = 7;
+    static constexpr std::size_t TEXTURE_TARGETS_COUNT = 5;
+    static constexpr GLuint MAX_TRACKED_TEXTURE_UNITS = 32;
+    static constexpr GLuint MAX_TRACKED_UNIFORM_BINDINGS = 32;
+
+    // Updates the shadowed binding and counts the call; returns whether it can be skipped
+    static bool IsRedundant(GLShadowedBinding& ShadowedBinding, GLuint RequestedObjectID)
+    {
+        if (ShadowedBinding.ObjectID == RequestedObjectID)
+        {
+            ++FrameStats.ElidedCalls;
+            return true;
+        }
+
+        ShadowedBinding.ObjectID = RequestedObjectID;
+        ++FrameStats.IssuedCalls;
+        return false;
+    }
+
+    // GL rebinds name 0 wherever a deleted object was bound
+    static void ResetIfBound(GLShadowedBinding& ShadowedBinding, GLuint DeletedObjectID)
+    {
+        if (ShadowedBinding.ObjectID == DeletedObjectID)
+        {
+            ShadowedBinding.ObjectID = 0;
+        }
+    }
+
+    // BUFFER_TARGETS_COUNT for targets that aren't tracked
+    static std::size_t BufferTargetToIndex(GLenum Target)
+    {
+        switch (Target)
+        {
+        case GL_ARRAY_BUFFER: return 0;
+        case GL_ELEMENT_ARRAY_BUFFER: return 1;
+        case GL_UNIFORM_BUFFER: return 2;
+        case GL_PIXEL_PACK_BUFFER: return 3;
+        case GL_PIXEL_UNPACK_BUFFER: return 4;
+        case GL_COPY_READ_BUFFER: return 5;
+        case GL_COPY_WRITE_BUFFER: return 6;
+        default: return BUFFER_TARGETS_COUNT;
+        }
+    }
+
+    // TEXTURE_TARGETS_COUNT for targets that aren't tracked
+    static std::size_t TextureTargetToIndex(GLenum Target)
+    {
+        switch (Target)
+        {
+        case GL_TEXTURE_2D: return 0;
+        case GL_TEXTURE_CUBE_MAP: return 1;
+        case GL_TEXTURE_2D_ARRAY: return 2;
+        case GL_TEXTURE_3D: return 3;
+        case GL_TEXTURE_1D: return 4;
+        default: return TEXTURE_TARGETS_COUNT;
+        }
+    }
+
+private:
+    inline static GLShadowedBinding CurrentProgram;
+    inline static GLShadowedBinding CurrentProgramPipeline;
+    inline static GLShadowedBinding CurrentVertexArray;
+    inline static GLShadowedBinding ActiveTextureUnit;
+    inline static GLShadowedBinding BoundBuffers[BUFFER_TARGETS_COUNT];
+    inline static GLShadowedBufferRange UniformBufferRanges[MAX_TRACKED_UNIFORM_BINDINGS];
+    inline static GLShadowedBinding BoundTextures[MAX_TRACKED_TEXTURE_UNITS][TEXTURE_TARGETS_COUNT];
+    inline static GLShadowedBinding BoundSamplers[MAX_TRACKED_TEXTURE_UNITS];
+    inline static GLStateCacheStats FrameStats;
+};
+#endif
@@ -0,0 +1,243 @@
+#ifndef IMAGE_ARENA_H
+#define IMAGE_ARENA_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+
+struct ImageArenaStats
+{
+    // allocations served by the arena
+    std::size_t ArenaAllocations = 0;
+    // allocations that went to the global heap: outside of an arena scope, plus the arena's own chunks
+    std::size_t HeapAllocations = 0;
+    // allocations served by the output memory given to a scope
+    std::size_t OutputAllocations = 0;
+    // memory held by the arena's chunks
+    std::size_t ReservedBytes = 0;
+};
+
+/*
+ * Per thread bump allocator behind stb_image's STBI_MALLOC/STBI_REALLOC_SIZED/STBI_FREE (see stb_image.cpp). While a Scope is
+ * alive on a thread, every allocation stb_image makes there (zlib buffers, JPEG planes, the decoded image itself) is carved
+ * out of the thread's chunks and freeing is a no-op, apart from rolling back the latest allocation; the outermost Scope resets
+ * the arena when it ends, so all decoded images must be freed (or copied) by then. Chunks are kept, and merged into a single
+ * one once the arena had to grow, so decoding images of the same sizes again doesn't touch the global heap at all.
+ * Outside of a Scope, allocations go to the heap as usual (and may be freed on any thread); arena memory must be freed on its own thread.
+ * A Scope can also be given the memory the decoded image should end up in (e.g. a mapped pixel buffer): the first allocation of
+ * the image's size is served from it, which is the one decoders write the final image into, so nothing has to be copied out of
+ * stb_image's buffer. Callers still have to compare the returned image with that memory, decoders may take another route.
+ */
+class ImageArena
+{
+    // memory a Scope was given for the decoded image
+    struct OutputBuffer
+    {
+        unsigned char* Memory = nullptr;
+        std::size_t ImageSize = 0;
+        std::size_t Capacity = 0;
+        bool bTaken = false;
+    };
+
+public:
+    class Scope
+    {
+    public:
+        Scope()
+        {
+            ++State.ScopesCount;
+        }
+
+        // Allocations of ImageSize up to OutputCapacity bytes (decoders may ask for a few bytes more than the image) get OutputMemory, one at a time
+        Scope(void* OutputMemory, std::size_t ImageSize, std::size_t OutputCapacity)
+            : bHasOutput(true), PreviousOutput(State.Output)
+        {
+            ++State.ScopesCount;
+            State.Output = { static_cast<unsigned char*>(OutputMemory), ImageSize, OutputCapacity, false };
+        }
+
+        ~Scope()
+        {
+            if (bHasOutput)
+            {
+                State.Output = PreviousOutput;
+            }
+            if (--State.ScopesCount == 0)
+            {
+                Reset();
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        bool bHasOutput = false;
+        OutputBuffer PreviousOutput;
+    };
+
+    static void* Allocate(std::size_t Size)
+    {
+        if (State.ScopesCount == 0)
+        {
+            ++State.Stats.HeapAllocations;
+            return std::malloc(Size);
+        }
+        if (!State.Output.bTaken && State.Output.Memory != nullptr && Size >= State.Output.ImageSize && Size <= State.Output.Capacity)
+        {
+            State.Output.bTaken = true;
+            ++State.Stats.OutputAllocations;
+            return State.Output.Memory;
+        }
+        return AllocateInArena(Size);
+    }
+
+    // Like realloc, knowing the old size (which the arena doesn't store); grows the latest allocation in place when it fits
+    static void* Reallocate(void* Memory, std::size_t OldSize, std::size_t NewSize)
+    {
+        if (Memory == nullptr)
+        {
+            return Allocate(NewSize);
+        }
+        if (Memory == State.Output.Memory)
+        {
+            // moved into the arena, the output memory is free to take for another allocation
+            void* newMemory = AllocateInArena(NewSize);
+            std::memcpy(newMemory, Memory, std::min(OldSize, NewSize));
+            State.Output.bTaken = false;
+            return newMemory;
+        }
+        if (!IsInArena(Memory))
+        {
+            ++State.Stats.HeapAllocations;
+            return std::realloc(Memory, NewSize);
+        }
+
+        Chunk& chunk = State.Chunks[State.ChunkIndex];
+        if (Memory == State.LatestAllocation && static_cast<unsigned char*>(Memory) + NewSize <= chunk.Memory.get() + chunk.Size)
+        {
+            State.Offset = static_cast<std::size_t>(static_cast<unsigned char*>(Memory) - chunk.Memory.get()) + AlignSize(NewSize);
+            return Memory;
+        }
+
+        void* newMemory = AllocateInArena(NewSize);
+        std::memcpy(newMemory, Memory, std::min(OldSize, NewSize));
+        return newMemory;
+    }
+
+    static void Free(void* Memory)
+    {
+        if (Memory == nullptr)
+        {
+            return;
+        }
+        if (Memory == State.Output.Memory)
+        {
+            State.Output.bTaken = false;
+            return;
+        }
+        if (!IsInArena(Memory))
+        {
+            std::free(Memory);
+            return;
+        }
+
+        // short lived buffers are usually freed right after being allocated, which gives their memory back
+        if (Memory == State.LatestAllocation)
+        {
+            State.Offset = static_cast<std::size_t>(static_cast<unsigned char*>(Memory) - State.Chunks[State.ChunkIndex].Memory.get());
+            State.LatestAllocation = nullptr;
+        }
+    }
+
+    // Stats of the calling thread
+    static ImageArenaStats GetStats()
+    {
+        return State.Stats;
+    }
+
+private:
+    static constexpr std::size_t ALIGNMENT = 16;
+    static constexpr std::size_t MIN_CHUNK_SIZE = 1 << 20;
+
+    struct Chunk
+    {
+        std::unique_ptr<unsigned char[]> Memory;
+        std::size_t Size = 0;
+    };
+
+    struct ThreadState
+    {
+        std::vector<Chunk> Chunks;
+        std::size_t ChunkIndex = 0;
+        std::size_t Offset = 0;
+        void* LatestAllocation = nullptr;
+        unsigned int ScopesCount = 0;
+        OutputBuffer Output;
+        ImageArenaStats Stats;
+    };
+
+    static std::size_t AlignSize(std::size_t Size)
+    {
+        return (Size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    static void* AllocateInArena(std::size_t Size)
+    {
+        const std::size_t alignedSize = AlignSize(std::max<std::size_t>(Size, 1));
+        while (State.ChunkIndex < State.Chunks.size() && State.Offset + alignedSize > State.Chunks[State.ChunkIndex].Size)
+        {
+            ++State.ChunkIndex;
+            State.Offset = 0;
+        }
+        if (State.ChunkIndex == State.Chunks.size())
+        {
+            const std::size_t chunkSize = std::max({ alignedSize, MIN_CHUNK_SIZE, State.Stats.ReservedBytes });
+            // operator new hands out memory aligned for any fundamental type, at least 16 bytes on the platforms we target
+            State.Chunks.push_back({ std::unique_ptr<unsigned char[]>(new unsigned char[chunkSize]), chunkSize });
+            State.Stats.ReservedBytes += chunkSize;
+            ++State.Stats.HeapAllocations;
+        }
+
+        void* memory = State.Chunks[State.ChunkIndex].Memory.get() + State.Offset;
+        State.Offset += alignedSize;
+        State.LatestAllocation = memory;
+        ++State.Stats.ArenaAllocations;
+        return memory;
+    }
+
+    static bool IsInArena(const void* Memory)
+    {
+        const unsigned char* memory = static_cast<const unsigned char*>(Memory);
+        return std::any_of(State.Chunks.begin(), State.Chunks.end(), [memory](const Chunk& ArenaChunk)
+        {
+            return memory >= ArenaChunk.Memory.get() && memory < ArenaChunk.Memory.get() + ArenaChunk.Size;
+        });
+    }
+
+    static void Reset()
+    {
+        // an arena that had to grow gets one chunk big enough for all of it, so the next round fits without growing
+        if (State.Chunks.size() > 1)
+        {
+            const std::size_t chunkSize = State.Stats.ReservedBytes;
+            State.Chunks.clear();
+            State.Chunks.push_back({ std::unique_ptr<unsigned char[]>(new unsigned char[chunkSize]), chunkSize });
+            ++State.Stats.HeapAllocations;
+        }
+        State.ChunkIndex = 0;
+        State.Offset = 0;
+        State.LatestAllocation = nullptr;
+    }
+
+private:
+    static thread_local ThreadState State;
+};
+
+// defined out of the class, ThreadState's member initializers aren't usable before the class is complete
+inline thread_local ImageArena::ThreadState ImageArena::State;
+#endif
\ No newline at end of file
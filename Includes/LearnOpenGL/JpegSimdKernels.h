@@ -0,0 +1,206 @@
+#ifndef JPEG_SIMD_KERNELS_H
+#define JPEG_SIMD_KERNELS_H
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#define JPEG_SIMD_KERNELS_AVX2
+// AVX2 code is compiled for the functions that need it only, the rest of the program keeps running on any x86 CPU
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define JPEG_SIMD_KERNELS_TARGET_AVX2
+#else
+#define JPEG_SIMD_KERNELS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+
+/*
+ * AVX2 versions of the per row JPEG kernels stb_image has SSE2 versions of (stb_image.cpp hands them to it): 2x2 chroma
+ * upsampling & YCbCr to RGB conversion. They do the exact same integer math as stb_image's scalar & SSE2 code, on twice as
+ * many values at a time, so decoded images don't depend on the CPU they're decoded on. Unlike stb_image's SSE2 one, the color
+ * conversion covers 3 channel output too, which is what most textures get loaded with. The IDCT stays on SSE2: an 8x8 block
+ * already fills 128 bit registers row by row, and spreading it over 256 bits costs more shuffles than it saves.
+ * Picked at runtime, where both the CPU & the OS support AVX2.
+ */
+class JpegSimdKernels
+{
+public:
+    static bool IsAvx2Supported()
+    {
+#if !defined(JPEG_SIMD_KERNELS_AVX2)
+        return false;
+#elif defined(_MSC_VER) && !defined(__clang__)
+        int cpuInfo[4];
+        __cpuid(cpuInfo, 0);
+        if (cpuInfo[0] < 7)
+        {
+            return false;
+        }
+        // the OS has to save the YMM registers on context switches (OSXSAVE & XCR0 bits 1-2)
+        __cpuid(cpuInfo, 1);
+        if ((cpuInfo[2] & (1 << 27)) == 0 || (cpuInfo[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6)
+        {
+            return false;
+        }
+        __cpuidex(cpuInfo, 7, 0);
+        return (cpuInfo[1] & (1 << 5)) != 0;
+#else
+        // checks OS support as well
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+#endif
+    }
+
+    static bool IsAvx2Enabled()
+    {
+        return bAvx2Enabled;
+    }
+
+    // AVX2 kernels are used by default where supported; turning them off (e.g. to compare with SSE2) only affects decodes started afterwards
+    static void SetAvx2Enabled(bool bNewEnabled)
+    {
+        bAvx2Enabled = bNewEnabled && IsAvx2Supported();
+    }
+
+#ifdef JPEG_SIMD_KERNELS_AVX2
+    // Upsamples a row of Width chroma samples 2x in both directions (triangle filter between the near & far rows); matches stbi__resample_row_hv_2
+    JPEG_SIMD_KERNELS_TARGET_AVX2 static unsigned char* ResampleRowHV2(unsigned char* Out, unsigned char* InNear, unsigned char* InFar, int Width, int)
+    {
+        if (Width == 1)
+        {
+            Out[0] = Out[1] = static_cast<unsigned char>((3 * InNear[0] + InFar[0] + 2) >> 2);
+            return Out;
+        }
+
+        int previousValue = 3 * InNear[0] + InFar[0];
+        int sampleIndex = 0;
+        // the last sample needs the filter's boundary condition, so it's always left to the scalar loop
+        for (; sampleIndex < ((Width - 1) & ~15); sampleIndex += 16)
+        {
+            // vertical pass: 3 * near + far = 4 * near + (far - near)
+            const __m256i nearValues = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(InNear + sampleIndex)));
+            const __m256i farValues = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(InFar + sampleIndex)));
+            const __m256i current = _mm256_add_epi16(_mm256_slli_epi16(nearValues, 2), _mm256_sub_epi16(farValues, nearValues));
+
+            // current row shifted by one sample either way, across the 128 bit lanes, with the neighbours of the group shifted in
+            __m256i previous = _mm256_alignr_epi8(current, _mm256_permute2x128_si256(current, current, 0x08), 14);
+            previous = _mm256_insert_epi16(previous, static_cast<short>(previousValue), 0);
+            __m256i next = _mm256_alignr_epi8(_mm256_permute2x128_si256(current, current, 0x81), current, 2);
+            next = _mm256_insert_epi16(next, static_cast<short>(3 * InNear[sampleIndex + 16] + InFar[sampleIndex + 16]), 15);
+
+            // horizontal pass: even outputs = 3 * current + previous, odd ones = 3 * current + next (plus rounding)
+            const __m256i biasedCurrent = _mm256_add_epi16(_mm256_slli_epi16(current, 2), _mm256_set1_epi16(8));
+            const __m256i evenValues = _mm256_add_epi16(_mm256_sub_epi16(previous, current), biasedCurrent);
+            const __m256i oddValues = _mm256_add_epi16(_mm256_sub_epi16(next, current), biasedCurrent);
+
+            // interleaving within lanes leaves the outputs of each lane in order, so packing puts all 32 in place
+            const __m256i low = _mm256_srli_epi16(_mm256_unpacklo_epi16(evenValues, oddValues), 4);
+            const __m256i high = _mm256_srli_epi16(_mm256_unpackhi_epi16(evenValues, oddValues), 4);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(Out + sampleIndex * 2), _mm256_packus_epi16(low, high));
+
+            previousValue = 3 * InNear[sampleIndex + 15] + InFar[sampleIndex + 15];
+        }
+
+        int currentValue = 3 * InNear[sampleIndex] + InFar[sampleIndex];
+        Out[sampleIndex * 2] = static_cast<unsigned char>((3 * currentValue + previousValue + 8) >> 4);
+        for (++sampleIndex; sampleIndex < Width; ++sampleIndex)
+        {
+            previousValue = currentValue;
+            currentValue = 3 * InNear[sampleIndex] + InFar[sampleIndex];
+            Out[sampleIndex * 2 - 1] = static_cast<unsigned char>((3 * previousValue + currentValue + 8) >> 4);
+            Out[sampleIndex * 2] = static_cast<unsigned char>((3 * currentValue + previousValue + 8) >> 4);
+        }
+        Out[Width * 2 - 1] = static_cast<unsigned char>((currentValue + 2) >> 2);
+        return Out;
+    }
+
+    // Converts Count pixels into RGB (Step 3) or RGBA (Step 4, opaque); matches stbi__YCbCr_to_RGB_row
+    JPEG_SIMD_KERNELS_TARGET_AVX2 static void YCbCrToRgb(unsigned char* Out, const unsigned char* Y, const unsigned char* Cb, const unsigned char* Cr, int Count,
+        int Step)
+    {
+        // same reduced precision as stb_image: 16 bit math with 12 bit constants
+        const __m256i crToRed = _mm256_set1_epi16(static_cast<short>(1.40200f * 4096.0f + 0.5f));
+        const __m256i crToGreen = _mm256_set1_epi16(-static_cast<short>(0.71414f * 4096.0f + 0.5f));
+        const __m256i cbToGreen = _mm256_set1_epi16(-static_cast<short>(0.34414f * 4096.0f + 0.5f));
+        const __m256i cbToBlue = _mm256_set1_epi16(static_cast<short>(1.77200f * 4096.0f + 0.5f));
+        const __m256i opaque = _mm256_set1_epi16(255);
+        // drops the alpha of the 4 RGBA pixels in each lane, the last 4 bytes are left over
+        const __m256i rgbaToRgb = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+        int pixelIndex = 0;
+        // 3 channel stores spill 4 bytes past the group, so they need at least 2 more pixels after it to land in
+        const int groupsEnd = Step == 4 ? Count - 15 : Count - 17;
+        for (; (Step == 3 || Step == 4) && pixelIndex < groupsEnd; pixelIndex += 16)
+        {
+            // Y as (Y << 4) + 8 (rounding), chroma as (C - 128) << 8, multiplied keeping the high 16 bits
+            const __m256i yValues = _mm256_add_epi16(_mm256_slli_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Y + pixelIndex))), 4),
+                _mm256_set1_epi16(8));
+            const __m256i crValues = _mm256_slli_epi16(_mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Cr + pixelIndex))),
+                _mm256_set1_epi16(128)), 8);
+            const __m256i cbValues = _mm256_slli_epi16(_mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Cb + pixelIndex))),
+                _mm256_set1_epi16(128)), 8);
+
+            const __m256i red = _mm256_srai_epi16(_mm256_add_epi16(_mm256_mulhi_epi16(crToRed, crValues), yValues), 4);
+            const __m256i green = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(_mm256_mulhi_epi16(cbToGreen, cbValues), yValues),
+                _mm256_mulhi_epi16(crValues, crToGreen)), 4);
+            const __m256i blue = _mm256_srai_epi16(_mm256_add_epi16(yValues, _mm256_mulhi_epi16(cbValues, cbToBlue)), 4);
+
+            // interleave within lanes: pixels 0-3 & 8-11 end up in the first register, 4-7 & 12-15 in the second one
+            const __m256i redBlue = _mm256_packus_epi16(red, blue);
+            const __m256i greenAlpha = _mm256_packus_epi16(green, opaque);
+            const __m256i redGreen = _mm256_unpacklo_epi8(redBlue, greenAlpha);
+            const __m256i blueAlpha = _mm256_unpackhi_epi8(redBlue, greenAlpha);
+            const __m256i pixels0 = _mm256_unpacklo_epi16(redGreen, blueAlpha);
+            const __m256i pixels1 = _mm256_unpackhi_epi16(redGreen, blueAlpha);
+            const __m256i pixels0To7 = _mm256_permute2x128_si256(pixels0, pixels1, 0x20);
+            const __m256i pixels8To15 = _mm256_permute2x128_si256(pixels0, pixels1, 0x31);
+
+            if (Step == 4)
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(Out), pixels0To7);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(Out + 32), pixels8To15);
+                Out += 64;
+            }
+            else
+            {
+                const __m256i rgb0To7 = _mm256_shuffle_epi8(pixels0To7, rgbaToRgb);
+                const __m256i rgb8To15 = _mm256_shuffle_epi8(pixels8To15, rgbaToRgb);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(Out), _mm256_castsi256_si128(rgb0To7));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(Out + 12), _mm256_extracti128_si256(rgb0To7, 1));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(Out + 24), _mm256_castsi256_si128(rgb8To15));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(Out + 36), _mm256_extracti128_si256(rgb8To15, 1));
+                Out += 48;
+            }
+        }
+
+        for (; pixelIndex < Count; ++pixelIndex)
+        {
+            const int yFixed = (Y[pixelIndex] << 20) + (1 << 19);
+            const int cr = Cr[pixelIndex] - 128;
+            const int cb = Cb[pixelIndex] - 128;
+            const int red = (yFixed + cr * FloatToFixed(1.40200f)) >> 20;
+            const int green = (yFixed + cr * -FloatToFixed(0.71414f) + static_cast<int>(static_cast<unsigned int>(cb * -FloatToFixed(0.34414f)) & 0xFFFF0000u)) >> 20;
+            const int blue = (yFixed + cb * FloatToFixed(1.77200f)) >> 20;
+            Out[0] = static_cast<unsigned char>(std::clamp(red, 0, 255));
+            Out[1] = static_cast<unsigned char>(std::clamp(green, 0, 255));
+            Out[2] = static_cast<unsigned char>(std::clamp(blue, 0, 255));
+            Out[3] = 255;
+            Out += Step;
+        }
+    }
+#endif
+
+private:
+#ifdef JPEG_SIMD_KERNELS_AVX2
+    // stb_image's 8 bit fixed point of the color conversion (stbi__float2fixed)
+    static constexpr int FloatToFixed(float Value)
+    {
+        return static_cast<int>(Value * 4096.0f + 0.5f) << 8;
+    }
+#endif
+
+    inline static bool bAvx2Enabled = IsAvx2Supported();
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,143 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+
+/*
+ * Read-only memory mapping of a whole file: contents are paged in by the OS as they're touched, with no read into an
+ * intermediate buffer. Meant for big binary files consumed as they are (for small ones a single read is cheaper, see ReadShaderSourceFile).
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+
+    ~MappedFile()
+    {
+        Close();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Returns false (leaving the file closed) if it can't be opened or mapped; empty files can't be mapped either
+    bool Open(const std::string& FilePath)
+    {
+        Close();
+
+#ifdef _WIN32
+        FileHandle = CreateFileA(FilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        LARGE_INTEGER fileSize;
+        if (FileHandle == INVALID_HANDLE_VALUE || !GetFileSizeEx(FileHandle, &fileSize) || fileSize.QuadPart == 0)
+        {
+            Close();
+            return false;
+        }
+
+        MappingHandle = CreateFileMappingA(FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void* mappedData = MappingHandle != nullptr ? MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (mappedData == nullptr)
+        {
+            Close();
+            return false;
+        }
+        Data = static_cast<const unsigned char*>(mappedData);
+        Size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+        const int fileDescriptor = open(FilePath.c_str(), O_RDONLY);
+        struct stat fileStatus;
+        if (fileDescriptor < 0 || fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size == 0)
+        {
+            if (fileDescriptor >= 0)
+            {
+                close(fileDescriptor);
+            }
+            return false;
+        }
+
+        // mapping stays valid after the descriptor is closed
+        void* mappedData = mmap(nullptr, static_cast<std::size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        close(fileDescriptor);
+        if (mappedData == MAP_FAILED)
+        {
+            return false;
+        }
+        Data = static_cast<const unsigned char*>(mappedData);
+        Size = static_cast<std::size_t>(fileStatus.st_size);
+
+        // whole file is about to be read front to back
+        madvise(mappedData, Size, MADV_SEQUENTIAL);
+        madvise(mappedData, Size, MADV_WILLNEED);
+#endif
+        return true;
+    }
+
+    void Close()
+    {
+#ifdef _WIN32
+        if (Data != nullptr)
+        {
+            UnmapViewOfFile(Data);
+        }
+        if (MappingHandle != nullptr)
+        {
+            CloseHandle(MappingHandle);
+            MappingHandle = nullptr;
+        }
+        if (FileHandle != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(FileHandle);
+            FileHandle = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (Data != nullptr)
+        {
+            munmap(const_cast<unsigned char*>(Data), Size);
+        }
+#endif
+        Data = nullptr;
+        Size = 0;
+    }
+
+    bool IsOpen() const
+    {
+        return Data != nullptr;
+    }
+
+    const unsigned char* GetData() const
+    {
+        return Data;
+    }
+
+    std::size_t GetSize() const
+    {
+        return Size;
+    }
+
+private:
+    const unsigned char* Data = nullptr;
+    std::size_t Size = 0;
+
+#ifdef _WIN32
+    HANDLE FileHandle = INVALID_HANDLE_VALUE;
+    HANDLE MappingHandle = nullptr;
+#endif
+};
+#endif
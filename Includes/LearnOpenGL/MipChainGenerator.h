@@ -0,0 +1,408 @@
+#ifndef MIP_CHAIN_GENERATOR_H
+#define MIP_CHAIN_GENERATOR_H
+
+#include "LearnOpenGL/ParallelFor.h"
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MIP_CHAIN_GENERATOR_SSE2
+#endif
+
+#ifdef __AVX__
+#include <immintrin.h>
+#define MIP_CHAIN_GENERATOR_AVX
+#endif
+
+
+enum class EMipFilter : unsigned int
+{
+    // 2x2 average, the same as glGenerateMipmap of most drivers
+    Box,
+    // 8 tap windowed sinc (Kaiser window), keeps distant mips sharper at the cost of a slight ringing
+    Kaiser
+};
+
+struct MipGenerationOptions
+{
+    EMipFilter Filter = EMipFilter::Box;
+    // color channels are stored in sRGB, so they get filtered in linear space (only applies to 3 & 4 channel images)
+    bool bSRGB = false;
+    // colors are weighted by alpha while filtering (only applies to 4 channel images), so colors of transparent texels don't bleed into visible ones
+    bool bPremultipliedAlpha = false;
+    // 0 uses all the cores
+    unsigned int ThreadsCount = 0;
+};
+
+struct MipLevel
+{
+    int Width = 0;
+    int Height = 0;
+    // tightly packed, same channels as the source image
+    std::vector<unsigned char> Pixels;
+};
+
+/*
+ * CPU replacement for glGenerateMipmap, giving the same results on every driver. Levels are computed one from another in
+ * linear float RGBA with a separable filter (horizontal pass, then vertical one), with SSE2/AVX kernels where the compiler
+ * targets them; rows of every level are split between threads. The result is converted back to the 8 bit format of the source.
+ */
+class MipChainGenerator
+{
+public:
+    // Levels 1 to the 1x1 one of the tightly packed 8 bit image (level 0 is the image itself, so it isn't included)
+    static std::vector<MipLevel> Generate(const unsigned char* Pixels, int Width, int Height, int Channels, const MipGenerationOptions& Options = MipGenerationOptions())
+    {
+        const bool bSRGB = Options.bSRGB && Channels >= 3;
+        const bool bPremultipliedAlpha = Options.bPremultipliedAlpha && Channels == 4;
+        const unsigned int threadsCount = Options.ThreadsCount != 0 ? Options.ThreadsCount : std::max(std::thread::hardware_concurrency(), 1u);
+        const FilterKernel& filterKernel = GetFilterKernel(Options.Filter);
+
+        std::vector<float> level(static_cast<std::size_t>(Width) * Height * 4);
+        ParallelFor(Height, threadsCount, GetMinRowsPerThread(Width), [&](int FirstRow, int EndRow)
+        {
+            const std::size_t firstTexel = static_cast<std::size_t>(FirstRow) * Width;
+            ToLinear(Pixels + firstTexel * Channels, level.data() + firstTexel * 4, static_cast<std::size_t>(EndRow - FirstRow) * Width, Channels, bSRGB,
+                bPremultipliedAlpha);
+        });
+
+        std::vector<MipLevel> mipLevels;
+        std::vector<float> halfWidthLevel;
+        std::vector<float> nextLevel;
+        while (Width > 1 || Height > 1)
+        {
+            const int nextWidth = std::max(Width / 2, 1);
+            const int nextHeight = std::max(Height / 2, 1);
+
+            halfWidthLevel.resize(static_cast<std::size_t>(nextWidth) * Height * 4);
+            ParallelFor(Height, threadsCount, GetMinRowsPerThread(Width), [&](int FirstRow, int EndRow)
+            {
+                for (int row = FirstRow; row < EndRow; ++row)
+                {
+                    DownsampleRow(level.data() + static_cast<std::size_t>(row) * Width * 4, Width, halfWidthLevel.data() + static_cast<std::size_t>(row) * nextWidth * 4,
+                        nextWidth, filterKernel);
+                }
+            });
+
+            MipLevel mipLevel;
+            mipLevel.Width = nextWidth;
+            mipLevel.Height = nextHeight;
+            mipLevel.Pixels.resize(static_cast<std::size_t>(nextWidth) * nextHeight * Channels);
+            nextLevel.resize(static_cast<std::size_t>(nextWidth) * nextHeight * 4);
+            ParallelFor(nextHeight, threadsCount, GetMinRowsPerThread(nextWidth), [&](int FirstRow, int EndRow)
+            {
+                for (int row = FirstRow; row < EndRow; ++row)
+                {
+                    DownsampleColumns(halfWidthLevel.data(), static_cast<std::size_t>(nextWidth) * 4, Height, row, nextLevel.data() + static_cast<std::size_t>(row) * nextWidth * 4,
+                        filterKernel);
+                }
+
+                const std::size_t firstTexel = static_cast<std::size_t>(FirstRow) * nextWidth;
+                FromLinear(nextLevel.data() + firstTexel * 4, mipLevel.Pixels.data() + firstTexel * Channels, static_cast<std::size_t>(EndRow - FirstRow) * nextWidth,
+                    Channels, bSRGB, bPremultipliedAlpha);
+            });
+
+            mipLevels.push_back(std::move(mipLevel));
+            level.swap(nextLevel);
+            Width = nextWidth;
+            Height = nextHeight;
+        }
+
+        return mipLevels;
+    }
+
+private:
+    // smaller levels aren't worth starting threads for, so they stay on the calling thread
+    static constexpr int MIN_TEXELS_PER_THREAD = 1 << 16;
+    static constexpr int LINEAR_TO_SRGB_STEPS = 4096;
+
+    // Output texel i of a downsampled line is the weighted sum of source texels 2i + FirstTapOffset, 2i + FirstTapOffset + 1, ... (clamped to the line)
+    struct FilterKernel
+    {
+        int FirstTapOffset;
+        std::vector<float> Weights;
+    };
+
+    // Rows of the given width making up the least work worth a thread of its own
+    static int GetMinRowsPerThread(int RowWidth)
+    {
+        return std::max(MIN_TEXELS_PER_THREAD / std::max(RowWidth, 1), 1);
+    }
+
+    static const FilterKernel& GetFilterKernel(EMipFilter Filter)
+    {
+        static const FilterKernel boxKernel = { 0, { 0.5f, 0.5f } };
+        static const FilterKernel kaiserKernel = []()
+        {
+            // taps sit at 0.5, 1.5, ... 3.5 source texels from the output texel center; sinc cut off at the new Nyquist frequency
+            constexpr double PI = 3.14159265358979323846;
+            constexpr double KAISER_ALPHA = 4.0;
+            constexpr double WINDOW_RADIUS = 4.0;
+
+            const auto besselI0 = [](double X)
+            {
+                double sum = 1.0;
+                double term = 1.0;
+                for (int k = 1; k < 32; ++k)
+                {
+                    term *= (X / (2.0 * k)) * (X / (2.0 * k));
+                    sum += term;
+                }
+                return sum;
+            };
+
+            FilterKernel kernel = { -3, {} };
+            double weightsSum = 0.0;
+            for (int tap = 0; tap < 8; ++tap)
+            {
+                const double distance = tap - 3.5;
+                const double sincArgument = PI * distance / 2.0;
+                const double sinc = std::sin(sincArgument) / sincArgument;
+                const double windowPosition = distance / WINDOW_RADIUS;
+                const double window = besselI0(PI * KAISER_ALPHA * std::sqrt(1.0 - windowPosition * windowPosition)) / besselI0(PI * KAISER_ALPHA);
+                kernel.Weights.push_back(static_cast<float>(sinc * window));
+                weightsSum += sinc * window;
+            }
+            for (float& weight : kernel.Weights)
+            {
+                weight = static_cast<float>(weight / weightsSum);
+            }
+            return kernel;
+        }();
+
+        return Filter == EMipFilter::Kaiser ? kaiserKernel : boxKernel;
+    }
+
+    // Linear value of every 8 bit value, for sRGB encoded (bSRGB) or plain channels
+    static const float* GetToLinearTable(bool bSRGB)
+    {
+        static const std::vector<float> tables = []()
+        {
+            std::vector<float> table(512);
+            for (int value = 0; value < 256; ++value)
+            {
+                const double color = value / 255.0;
+                table[value] = static_cast<float>(color);
+                table[256 + value] = static_cast<float>(color <= 0.04045 ? color / 12.92 : std::pow((color + 0.055) / 1.055, 2.4));
+            }
+            return table;
+        }();
+        return tables.data() + (bSRGB ? 256 : 0);
+    }
+
+    // Linear values half way between consecutive sRGB values, so encoding rounds the same way as the sRGB formula would
+    static const float* GetLinearToSrgbThresholds()
+    {
+        static const std::vector<float> thresholds = []()
+        {
+            std::vector<float> table(255);
+            for (int value = 0; value < 255; ++value)
+            {
+                const double color = (value + 0.5) / 255.0;
+                table[value] = static_cast<float>(color <= 0.04045 ? color / 12.92 : std::pow((color + 0.055) / 1.055, 2.4));
+            }
+            return table;
+        }();
+        return thresholds.data();
+    }
+
+    // Guess of the sRGB value for every 1/4096th of the linear range, off by one at most (sRGB values are never closer than that in linear space)
+    static const unsigned char* GetLinearToSrgbGuesses()
+    {
+        static const std::vector<unsigned char> guesses = []()
+        {
+            const float* thresholds = GetLinearToSrgbThresholds();
+            std::vector<unsigned char> table(LINEAR_TO_SRGB_STEPS + 1);
+            for (int step = 0; step <= LINEAR_TO_SRGB_STEPS; ++step)
+            {
+                table[step] = static_cast<unsigned char>(std::upper_bound(thresholds, thresholds + 255, static_cast<float>(step) / LINEAR_TO_SRGB_STEPS) - thresholds);
+            }
+            return table;
+        }();
+        return guesses.data();
+    }
+
+    // Value has to be within [0, 1]
+    static unsigned char EncodeSrgb(float Value, const unsigned char* Guesses, const float* Thresholds)
+    {
+        int srgbValue = Guesses[static_cast<int>(Value * LINEAR_TO_SRGB_STEPS)];
+        if (srgbValue < 255 && Thresholds[srgbValue] <= Value)
+        {
+            ++srgbValue;
+        }
+        else if (srgbValue > 0 && Thresholds[srgbValue - 1] > Value)
+        {
+            --srgbValue;
+        }
+        return static_cast<unsigned char>(srgbValue);
+    }
+
+    static void ToLinear(const unsigned char* Pixels, float* OutTexels, std::size_t TexelsCount, int Channels, bool bSRGB, bool bPremultipliedAlpha)
+    {
+        const float* channelTables[4] = { GetToLinearTable(bSRGB), GetToLinearTable(bSRGB), GetToLinearTable(bSRGB), GetToLinearTable(false) };
+        for (std::size_t texelIndex = 0; texelIndex < TexelsCount; ++texelIndex)
+        {
+            const unsigned char* pixel = Pixels + texelIndex * Channels;
+            float* texel = OutTexels + texelIndex * 4;
+            texel[0] = texel[1] = texel[2] = 0.0f;
+            texel[3] = 1.0f;
+            for (int channel = 0; channel < Channels; ++channel)
+            {
+                texel[channel] = channelTables[channel][pixel[channel]];
+            }
+
+            if (bPremultipliedAlpha)
+            {
+                texel[0] *= texel[3];
+                texel[1] *= texel[3];
+                texel[2] *= texel[3];
+            }
+        }
+    }
+
+    static void FromLinear(const float* Texels, unsigned char* OutPixels, std::size_t TexelsCount, int Channels, bool bSRGB, bool bPremultipliedAlpha)
+    {
+        const unsigned char* linearToSrgbGuesses = GetLinearToSrgbGuesses();
+        const float* linearToSrgbThresholds = GetLinearToSrgbThresholds();
+        for (std::size_t texelIndex = 0; texelIndex < TexelsCount; ++texelIndex)
+        {
+            // texels are stored with straight alpha again; negative filter lobes may push the color past alpha, hence the clamping
+            float texel[4];
+#ifdef MIP_CHAIN_GENERATOR_SSE2
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            __m128 texelVector = _mm_loadu_ps(Texels + texelIndex * 4);
+            if (bPremultipliedAlpha)
+            {
+                const __m128 alpha = _mm_min_ps(_mm_max_ps(_mm_shuffle_ps(texelVector, texelVector, _MM_SHUFFLE(3, 3, 3, 3)), zero), one);
+                const __m128 inverseAlpha = _mm_and_ps(_mm_cmpgt_ps(alpha, zero), _mm_div_ps(one, alpha));
+                const __m128 colorMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+                texelVector = _mm_or_ps(_mm_and_ps(colorMask, _mm_mul_ps(texelVector, inverseAlpha)), _mm_andnot_ps(colorMask, alpha));
+            }
+            _mm_storeu_ps(texel, _mm_min_ps(_mm_max_ps(texelVector, zero), one));
+#else
+            std::copy(Texels + texelIndex * 4, Texels + texelIndex * 4 + 4, texel);
+            if (bPremultipliedAlpha)
+            {
+                texel[3] = std::clamp(texel[3], 0.0f, 1.0f);
+                const float inverseAlpha = texel[3] > 0.0f ? 1.0f / texel[3] : 0.0f;
+                texel[0] *= inverseAlpha;
+                texel[1] *= inverseAlpha;
+                texel[2] *= inverseAlpha;
+            }
+            for (float& value : texel)
+            {
+                value = std::clamp(value, 0.0f, 1.0f);
+            }
+#endif
+
+            unsigned char* pixel = OutPixels + texelIndex * Channels;
+            for (int channel = 0; channel < Channels; ++channel)
+            {
+                pixel[channel] = bSRGB && channel < 3 ? EncodeSrgb(texel[channel], linearToSrgbGuesses, linearToSrgbThresholds) :
+                    static_cast<unsigned char>(texel[channel] * 255.0f + 0.5f);
+            }
+        }
+    }
+
+    // Filters a line of RGBA texels down to OutputWidth texels
+    static void DownsampleRow(const float* Source, int SourceWidth, float* Output, int OutputWidth, const FilterKernel& Kernel)
+    {
+        const int tapsCount = static_cast<int>(Kernel.Weights.size());
+        const auto sourceTexel = [&](int OutputTexel, int Tap)
+        {
+            return Source + std::clamp(OutputTexel * 2 + Kernel.FirstTapOffset + Tap, 0, SourceWidth - 1) * 4;
+        };
+
+        int outputTexel = 0;
+#ifdef MIP_CHAIN_GENERATOR_AVX
+        // two output texels per iteration, one in each half of the register
+        for (; outputTexel + 1 < OutputWidth; outputTexel += 2)
+        {
+            __m256 sum = _mm256_setzero_ps();
+            for (int tap = 0; tap < tapsCount; ++tap)
+            {
+                const __m256 texels = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(sourceTexel(outputTexel, tap))),
+                    _mm_loadu_ps(sourceTexel(outputTexel + 1, tap)), 1);
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(Kernel.Weights[tap]), texels));
+            }
+            _mm256_storeu_ps(Output + outputTexel * 4, sum);
+        }
+#endif
+#ifdef MIP_CHAIN_GENERATOR_SSE2
+        for (; outputTexel < OutputWidth; ++outputTexel)
+        {
+            __m128 sum = _mm_setzero_ps();
+            for (int tap = 0; tap < tapsCount; ++tap)
+            {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(Kernel.Weights[tap]), _mm_loadu_ps(sourceTexel(outputTexel, tap))));
+            }
+            _mm_storeu_ps(Output + outputTexel * 4, sum);
+        }
+#endif
+        for (; outputTexel < OutputWidth; ++outputTexel)
+        {
+            float sum[4] = {};
+            for (int tap = 0; tap < tapsCount; ++tap)
+            {
+                const float* texel = sourceTexel(outputTexel, tap);
+                for (int channel = 0; channel < 4; ++channel)
+                {
+                    sum[channel] += Kernel.Weights[tap] * texel[channel];
+                }
+            }
+            std::copy(sum, sum + 4, Output + outputTexel * 4);
+        }
+    }
+
+    // Filters rows of the image down to its output row OutputRow (rows are RowFloatsCount floats long)
+    static void DownsampleColumns(const float* Source, std::size_t RowFloatsCount, int SourceHeight, int OutputRow, float* Output, const FilterKernel& Kernel)
+    {
+        const int tapsCount = static_cast<int>(Kernel.Weights.size());
+        const float* sourceRows[8];
+        for (int tap = 0; tap < tapsCount; ++tap)
+        {
+            sourceRows[tap] = Source + std::clamp(OutputRow * 2 + Kernel.FirstTapOffset + tap, 0, SourceHeight - 1) * RowFloatsCount;
+        }
+
+        // every float of the row is filtered the same way, so the whole row is one wide vector
+        std::size_t floatIndex = 0;
+#ifdef MIP_CHAIN_GENERATOR_AVX
+        for (; floatIndex + 8 <= RowFloatsCount; floatIndex += 8)
+        {
+            __m256 sum = _mm256_setzero_ps();
+            for (int tap = 0; tap < tapsCount; ++tap)
+            {
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(Kernel.Weights[tap]), _mm256_loadu_ps(sourceRows[tap] + floatIndex)));
+            }
+            _mm256_storeu_ps(Output + floatIndex, sum);
+        }
+#endif
+#ifdef MIP_CHAIN_GENERATOR_SSE2
+        for (; floatIndex + 4 <= RowFloatsCount; floatIndex += 4)
+        {
+            __m128 sum = _mm_setzero_ps();
+            for (int tap = 0; tap < tapsCount; ++tap)
+            {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(Kernel.Weights[tap]), _mm_loadu_ps(sourceRows[tap] + floatIndex)));
+            }
+            _mm_storeu_ps(Output + floatIndex, sum);
+        }
+#endif
+        for (; floatIndex < RowFloatsCount; ++floatIndex)
+        {
+            float sum = 0.0f;
+            for (int tap = 0; tap < tapsCount; ++tap)
+            {
+                sum += Kernel.Weights[tap] * sourceRows[tap][floatIndex];
+            }
+            Output[floatIndex] = sum;
+        }
+    }
+};
+#endif
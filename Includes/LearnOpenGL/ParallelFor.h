@@ -0,0 +1,31 @@
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <functional>
+
+
+/*
+ * Splits [0, Count) into contiguous ranges of at least MinCountPerThread items, run on up to ThreadsCount threads (the calling
+ * one included); small counts stay on the calling thread. Function gets the first & past the last item of its range.
+ */
+inline void ParallelFor(int Count, unsigned int ThreadsCount, int MinCountPerThread, const std::function<void(int, int)>& Function)
+{
+    const int rangesCount = std::max(1, std::min(static_cast<int>(ThreadsCount), Count / std::max(MinCountPerThread, 1)));
+    const int rangeSize = (Count + rangesCount - 1) / rangesCount;
+
+    std::vector<std::thread> threads;
+    for (int rangeStart = rangeSize; rangeStart < Count; rangeStart += rangeSize)
+    {
+        threads.emplace_back(Function, rangeStart, std::min(rangeStart + rangeSize, Count));
+    }
+    Function(0, std::min(rangeSize, Count));
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+#endif
\ No newline at end of file
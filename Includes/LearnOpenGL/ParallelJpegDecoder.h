@@ -0,0 +1,39 @@
+#ifndef PARALLEL_JPEG_DECODER_H
+#define PARALLEL_JPEG_DECODER_H
+
+#include "Images/stb_image.h"
+#include "LearnOpenGL/MappedFile.h"
+
+#include <string>
+#include <climits>
+
+
+/*
+ * Multi-threaded decoding of large baseline JPEGs with stb_image's decoder (Huffman tables, kernels, error handling...), giving
+ * the very same pixels as stbi_load. Entropy coded data is split at its restart markers, each thread decoding (and IDCTing) its
+ * own range of restart intervals; without restart markers entropy decoding stays on the calling thread and IDCT is split by MCU
+ * rows afterwards. Upsampling & color conversion are split by rows of the image either way.
+ * Progressive JPEGs, ones with several scans, RGB/CMYK JPEGs, small images & any other format go through stb_image as usual.
+ * Everything stb_image would allocate is allocated on the calling thread, so ImageArena scopes work the same.
+ * Defined in stb_image.cpp, next to the stb_image internals it builds on.
+ */
+class ParallelJpegDecoder
+{
+public:
+    // Drop-in for stbi_load (same vertical flip & channel conversion, pixels freed with stbi_image_free); ThreadsCount 0 uses all cores
+    static unsigned char* Load(const std::string& FilePath, int* OutWidth, int* OutHeight, int* OutFileChannels, int DesiredChannels, unsigned int ThreadsCount = 0)
+    {
+        MappedFile file;
+        if (!file.Open(FilePath) || file.GetSize() > static_cast<std::size_t>(INT_MAX))
+        {
+            // stb_image reports why
+            return stbi_load(FilePath.c_str(), OutWidth, OutHeight, OutFileChannels, DesiredChannels);
+        }
+        return LoadFromMemory(file.GetData(), static_cast<int>(file.GetSize()), OutWidth, OutHeight, OutFileChannels, DesiredChannels, ThreadsCount);
+    }
+
+    // Drop-in for stbi_load_from_memory
+    static unsigned char* LoadFromMemory(const unsigned char* Buffer, int Length, int* OutWidth, int* OutHeight, int* OutFileChannels, int DesiredChannels,
+        unsigned int ThreadsCount = 0);
+};
+#endif
\ No newline at end of file
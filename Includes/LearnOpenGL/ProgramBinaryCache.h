@@ -0,0 +1,212 @@
+#ifndef PROGRAM_BINARY_CACHE_H
+#define PROGRAM_BINARY_CACHE_H
+
+#include <glad/glad.h>
+
+#include "LearnOpenGL/GLExtensions.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <filesystem>
+
+
+// Accumulated build time of a group of programs
+struct ProgramBuildStats
+{
+    unsigned int ProgramsCount = 0;
+    double TotalMilliseconds = 0.0;
+};
+
+/*
+ * Persistent on-disk cache of linked program binaries (glGetProgramBinary/glProgramBinary).
+ * Entries are keyed by a hash of the shader sources plus driver vendor/renderer/version strings, so a driver update
+ * or a source edit simply results in a different key. A binary the driver still rejects is deleted and the program
+ * is rebuilt from source by the caller.
+ */
+class ProgramBinaryCache
+{
+public:
+    static void SetCacheDirectory(const std::string& NewCacheDirectory)
+    {
+        CacheDirectory = NewCacheDirectory;
+    }
+
+    static void SetEnabled(bool bNewEnabled)
+    {
+        bEnabled = bNewEnabled;
+    }
+
+    // Cache is used only if it's enabled and the driver supports at least one program binary format
+    static bool IsAvailable()
+    {
+        return bEnabled && GLExtensions::bHasProgramBinary;
+    }
+
+    // Salt distinguishes programs built from the same sources in different ways (e.g. differently specialized SPIR-V)
+    static std::uint64_t ComputeKey(std::string_view VertexShaderSourceCode, std::string_view FragmentShaderSourceCode, std::uint64_t Salt = 0)
+    {
+        std::uint64_t key = 14695981039346656037ull;
+        HashBytes(key, VertexShaderSourceCode.data(), VertexShaderSourceCode.size());
+        HashBytes(key, FragmentShaderSourceCode.data(), FragmentShaderSourceCode.size());
+        HashBytes(key, reinterpret_cast<const char*>(&Salt), sizeof(Salt));
+
+        for (const GLenum driverStringName : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+        {
+            const char* driverString = reinterpret_cast<const char*>(glGetString(driverStringName));
+            if (driverString != nullptr)
+            {
+                HashBytes(key, driverString, std::char_traits<char>::length(driverString));
+            }
+        }
+
+        return key;
+    }
+
+    // Loads cached binary into given (freshly created) program; returns false if there's no usable binary for the key
+    static bool TryLoad(unsigned int ProgramID, std::uint64_t Key)
+    {
+        const std::filesystem::path entryPath = GetEntryPath(Key);
+        std::ifstream entryFile(entryPath, std::ios::binary);
+        if (!entryFile.is_open())
+        {
+            return false;
+        }
+
+        // the header is validated against the file size before allocating, so a truncated or corrupt entry can't ask for gigabytes
+        std::error_code errorCode;
+        const std::uintmax_t fileSize = std::filesystem::file_size(entryPath, errorCode);
+        EntryHeader header;
+        entryFile.read(reinterpret_cast<char*>(&header), sizeof(header));
+        std::vector<char> binary;
+        if (entryFile && !errorCode && header.Magic == ENTRY_MAGIC && header.Key == Key && header.BinaryLength > 0 &&
+            header.BinaryLength <= fileSize - sizeof(header))
+        {
+            binary.resize(header.BinaryLength);
+            entryFile.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+        }
+
+        if (!entryFile || binary.empty())
+        {
+            std::cout << "Discarding malformed program binary cache entry " << entryPath.string() << std::endl;
+            entryFile.close();
+            Evict(entryPath);
+            return false;
+        }
+
+        GLExtensions::ProgramBinary(ProgramID, header.BinaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+
+        // driver is free to reject binaries (e.g. after an update that didn't change version strings), so always verify
+        int linkedSuccessfully = 0;
+        glGetProgramiv(ProgramID, GL_LINK_STATUS, &linkedSuccessfully);
+        if (!linkedSuccessfully)
+        {
+            std::cout << "Driver rejected cached program binary " << entryPath.string() << ", falling back to source compilation." << std::endl;
+            Evict(entryPath);
+            return false;
+        }
+
+        return true;
+    }
+
+    // Must be called with a program that was linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set
+    static void Store(unsigned int ProgramID, std::uint64_t Key)
+    {
+        GLint binaryLength = 0;
+        glGetProgramiv(ProgramID, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+        if (binaryLength <= 0)
+        {
+            return;
+        }
+
+        EntryHeader header;
+        header.Key = Key;
+        std::vector<char> binary(static_cast<std::size_t>(binaryLength));
+        GLsizei retrievedLength = 0;
+        GLExtensions::GetProgramBinary(ProgramID, binaryLength, &retrievedLength, &header.BinaryFormat, binary.data());
+        header.BinaryLength = static_cast<std::uint32_t>(retrievedLength);
+
+        std::error_code errorCode;
+        std::filesystem::create_directories(CacheDirectory, errorCode);
+
+        // write to a temporary file first, so an interrupted write never leaves a truncated entry under the real name
+        const std::filesystem::path entryPath = GetEntryPath(Key);
+        std::filesystem::path temporaryEntryPath = entryPath;
+        temporaryEntryPath += ".tmp";
+        {
+            std::ofstream entryFile(temporaryEntryPath, std::ios::binary | std::ios::trunc);
+            entryFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            entryFile.write(binary.data(), retrievedLength);
+            if (!entryFile)
+            {
+                std::cout << "Failed to write program binary cache entry " << temporaryEntryPath.string() << std::endl;
+                return;
+            }
+        }
+        std::filesystem::rename(temporaryEntryPath, entryPath, errorCode);
+    }
+
+    // Accumulates program build time, split into warm (loaded from cache) & cold (compiled from source) builds
+    static void RecordProgramBuild(bool bLoadedFromCache, double BuildTimeMilliseconds)
+    {
+        ProgramBuildStats& stats = bLoadedFromCache ? WarmBuilds : ColdBuilds;
+        ++stats.ProgramsCount;
+        stats.TotalMilliseconds += BuildTimeMilliseconds;
+    }
+
+    static void PrintStartupReport()
+    {
+        std::cout << "Program binary cache " << (IsAvailable() ? "enabled" : "unavailable") << ":\n" <<
+            "  cold (compiled from source): " << ColdBuilds.ProgramsCount << " programs, " << ColdBuilds.TotalMilliseconds << " ms\n" <<
+            "  warm (loaded from cache):    " << WarmBuilds.ProgramsCount << " programs, " << WarmBuilds.TotalMilliseconds << " ms" << std::endl;
+    }
+
+private:
+    static constexpr std::uint32_t ENTRY_MAGIC = 0x4E49424Cu; // "LBIN"
+
+    struct EntryHeader
+    {
+        std::uint32_t Magic = ENTRY_MAGIC;
+        GLenum BinaryFormat = 0;
+        std::uint64_t Key = 0;
+        std::uint32_t BinaryLength = 0;
+    };
+
+    static void HashBytes(std::uint64_t& InOutHash, const char* Bytes, std::size_t BytesCount)
+    {
+        for (std::size_t byteIndex = 0; byteIndex < BytesCount; ++byteIndex)
+        {
+            InOutHash ^= static_cast<unsigned char>(Bytes[byteIndex]);
+            InOutHash *= 1099511628211ull;
+        }
+
+        // separator, so that moving text from one string into the next one changes the key
+        InOutHash ^= 0xFF;
+        InOutHash *= 1099511628211ull;
+    }
+
+    static std::filesystem::path GetEntryPath(std::uint64_t Key)
+    {
+        std::ostringstream entryName;
+        entryName << std::hex << std::setw(16) << std::setfill('0') << Key << ".bin";
+        return std::filesystem::path(CacheDirectory) / entryName.str();
+    }
+
+    static void Evict(const std::filesystem::path& EntryPath)
+    {
+        std::error_code errorCode;
+        std::filesystem::remove(EntryPath, errorCode);
+    }
+
+private:
+    inline static std::string CacheDirectory = "ShaderCache";
+    inline static bool bEnabled = true;
+    inline static ProgramBuildStats ColdBuilds;
+    inline static ProgramBuildStats WarmBuilds;
+};
+#endif
@@ -0,0 +1,275 @@
+#ifndef PROGRAM_PIPELINE_H
+#define PROGRAM_PIPELINE_H
+
+#include <glad/glad.h>
+
+#include "LearnOpenGL/GLExtensions.h"
+#include "LearnOpenGL/GLStateCache.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iostream>
+#include <unordered_map>
+
+
+struct ShaderStageCacheStats
+{
+    unsigned int CompiledStages = 0;
+    unsigned int ReusedStages = 0;
+    // monolithic programs linked on the fallback path (always 0 with separate shader objects)
+    unsigned int LinkedPrograms = 0;
+};
+
+/*
+ * Compiled shader stages keyed by stage type + source code hash (and told apart by their full source on a hit), so every
+ * distinct stage is compiled once no matter how many pipelines use it. With ARB_separate_shader_objects a stage is a separable single-stage program (ready to be
+ * combined in program pipelines without any linking), otherwise it's a plain shader object to link monolithic programs with.
+ */
+class ShaderStageCache
+{
+public:
+    // Returns cached stage, compiling it on first request; 0 if it failed to compile (failures are cached too, so they're reported once)
+    static GLuint GetStage(GLenum StageType, std::string_view SourceCode)
+    {
+        std::vector<CachedStage>& stagesWithKey = Stages[ComputeStageKey(StageType, SourceCode)];
+        for (const CachedStage& stage : stagesWithKey)
+        {
+            if (stage.StageType == StageType && stage.SourceCode == SourceCode)
+            {
+                ++Stats.ReusedStages;
+                return stage.StageID;
+            }
+        }
+
+        ++Stats.CompiledStages;
+        const GLuint stageID = UsesSeparablePrograms() ? CompileSeparableStage(StageType, SourceCode) : CompileShaderStage(StageType, SourceCode);
+        stagesWithKey.push_back({ StageType, std::string(SourceCode), stageID });
+        return stageID;
+    }
+
+    static bool UsesSeparablePrograms()
+    {
+        return GLExtensions::bHasSeparateShaderObjects;
+    }
+
+    static void RecordProgramLink()
+    {
+        ++Stats.LinkedPrograms;
+    }
+
+    static ShaderStageCacheStats GetStats()
+    {
+        return Stats;
+    }
+
+    // Deletes all cached stages; pipelines (and fallback programs) built from them keep working
+    static void DeleteAll()
+    {
+        for (const auto& stagesWithKey : Stages)
+        {
+            for (const CachedStage& stage : stagesWithKey.second)
+            {
+                if (UsesSeparablePrograms())
+                {
+                    glDeleteProgram(stage.StageID);
+                    GLStateCache::OnProgramDeleted(stage.StageID);
+                }
+                else
+                {
+                    glDeleteShader(stage.StageID);
+                }
+            }
+        }
+        Stages.clear();
+    }
+
+private:
+    struct CachedStage
+    {
+        GLenum StageType;
+        // kept to tell stages with colliding keys apart
+        std::string SourceCode;
+        GLuint StageID;
+    };
+
+    static std::uint64_t ComputeStageKey(GLenum StageType, std::string_view SourceCode)
+    {
+        // FNV-1a
+        std::uint64_t stageKey = (14695981039346656037ull ^ StageType) * 1099511628211ull;
+        for (const char character : SourceCode)
+        {
+            stageKey = (stageKey ^ static_cast<unsigned char>(character)) * 1099511628211ull;
+        }
+        return stageKey;
+    }
+
+    static GLuint CompileSeparableStage(GLenum StageType, std::string_view SourceCode)
+    {
+        // glCreateShaderProgramv compiles & links in one go, and only takes null-terminated sources
+        const std::string sourceCode(SourceCode);
+        const GLchar* sourceCodeData = sourceCode.c_str();
+        const GLuint stageProgramID = GLExtensions::CreateShaderProgramv(StageType, 1, &sourceCodeData);
+
+        GLint bLinked = GL_FALSE;
+        glGetProgramiv(stageProgramID, GL_LINK_STATUS, &bLinked);
+        if (!bLinked)
+        {
+            char infoLog[1024] = {};
+            glGetProgramInfoLog(stageProgramID, 1024, nullptr, infoLog);
+            std::cout << StageTypeToString(StageType) << " stage failed to build successfully.\n" <<
+                infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+
+            glDeleteProgram(stageProgramID);
+            return 0;
+        }
+
+        return stageProgramID;
+    }
+
+    static GLuint CompileShaderStage(GLenum StageType, std::string_view SourceCode)
+    {
+        const GLuint shaderID = glCreateShader(StageType);
+        const GLchar* sourceCodeData = SourceCode.data();
+        const GLint sourceCodeLength = static_cast<GLint>(SourceCode.size());
+        glShaderSource(shaderID, 1, &sourceCodeData, &sourceCodeLength);
+        glCompileShader(shaderID);
+
+        GLint bCompiled = GL_FALSE;
+        glGetShaderiv(shaderID, GL_COMPILE_STATUS, &bCompiled);
+        if (!bCompiled)
+        {
+            char infoLog[1024] = {};
+            glGetShaderInfoLog(shaderID, 1024, nullptr, infoLog);
+            std::cout << StageTypeToString(StageType) << " failed to compile successfully.\n" <<
+                infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+
+            glDeleteShader(shaderID);
+            return 0;
+        }
+
+        return shaderID;
+    }
+
+    static const char* StageTypeToString(GLenum StageType)
+    {
+        return StageType == GL_VERTEX_SHADER ? "VertexShader" : StageType == GL_FRAGMENT_SHADER ? "FragmentShader" : "Shader";
+    }
+
+private:
+    inline static std::unordered_map<std::uint64_t, std::vector<CachedStage>> Stages;
+    inline static ShaderStageCacheStats Stats;
+};
+
+/*
+ * Vertex + fragment stage combination. With separate shader objects the stages come from ShaderStageCache as separable
+ * programs and are combined by a program pipeline object, so N vertex x M fragment combinations cost N + M compiles and
+ * no linking at all. Without them the cached shader objects are linked into a regular program per combination (still
+ * N + M compiles, but N x M links).
+ */
+class ProgramPipeline
+{
+public:
+    ProgramPipeline(std::string_view VertexShaderSourceCode, std::string_view FragmentShaderSourceCode)
+    {
+        VertexStageID = ShaderStageCache::GetStage(GL_VERTEX_SHADER, VertexShaderSourceCode);
+        FragmentStageID = ShaderStageCache::GetStage(GL_FRAGMENT_SHADER, FragmentShaderSourceCode);
+        if (VertexStageID == 0 || FragmentStageID == 0)
+        {
+            return;
+        }
+
+        if (ShaderStageCache::UsesSeparablePrograms())
+        {
+            GLExtensions::GenProgramPipelines(1, &PipelineID);
+            GLExtensions::UseProgramStages(PipelineID, GL_VERTEX_SHADER_BIT, VertexStageID);
+            GLExtensions::UseProgramStages(PipelineID, GL_FRAGMENT_SHADER_BIT, FragmentStageID);
+            bValid = true;
+            return;
+        }
+
+        LinkFallbackProgram();
+    }
+
+    // Makes the pipeline current (program pipelines only take effect while no program is in use)
+    void Bind() const
+    {
+        if (PipelineID != 0)
+        {
+            GLStateCache::UseProgram(0);
+            GLStateCache::BindProgramPipeline(PipelineID);
+        }
+        else
+        {
+            GLStateCache::UseProgram(LinkedProgramID);
+        }
+    }
+
+    bool IsValid() const
+    {
+        return bValid;
+    }
+
+    // Program object holding uniforms of the given stage (separable stage program, or the single linked program on the fallback path)
+    GLuint GetStageProgramID(GLenum StageType) const
+    {
+        if (PipelineID == 0)
+        {
+            return LinkedProgramID;
+        }
+        return StageType == GL_VERTEX_SHADER ? VertexStageID : FragmentStageID;
+    }
+
+    // Deletes pipeline (or fallback program); shared stages stay in ShaderStageCache
+    void DeletePipeline()
+    {
+        if (PipelineID != 0)
+        {
+            GLExtensions::DeleteProgramPipelines(1, &PipelineID);
+            GLStateCache::OnProgramPipelineDeleted(PipelineID);
+            PipelineID = 0;
+        }
+
+        if (LinkedProgramID != 0)
+        {
+            glDeleteProgram(LinkedProgramID);
+            GLStateCache::OnProgramDeleted(LinkedProgramID);
+            LinkedProgramID = 0;
+        }
+        bValid = false;
+    }
+
+private:
+    void LinkFallbackProgram()
+    {
+        ShaderStageCache::RecordProgramLink();
+
+        LinkedProgramID = glCreateProgram();
+        glAttachShader(LinkedProgramID, VertexStageID);
+        glAttachShader(LinkedProgramID, FragmentStageID);
+        glLinkProgram(LinkedProgramID);
+        // detach, so deleting the cached shader objects later actually frees them
+        glDetachShader(LinkedProgramID, VertexStageID);
+        glDetachShader(LinkedProgramID, FragmentStageID);
+
+        GLint bLinked = GL_FALSE;
+        glGetProgramiv(LinkedProgramID, GL_LINK_STATUS, &bLinked);
+        if (!bLinked)
+        {
+            char infoLog[1024] = {};
+            glGetProgramInfoLog(LinkedProgramID, 1024, nullptr, infoLog);
+            std::cout << "ShaderProgram failed to link successfully.\n" <<
+                infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+        }
+        bValid = bLinked == GL_TRUE;
+    }
+
+private:
+    GLuint PipelineID = 0;
+    GLuint LinkedProgramID = 0;
+    GLuint VertexStageID = 0;
+    GLuint FragmentStageID = 0;
+    bool bValid = false;
+};
+#endif
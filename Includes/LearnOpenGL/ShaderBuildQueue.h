@@ -0,0 +1,84 @@
+#ifndef SHADER_BUILD_QUEUE_H
+#define SHADER_BUILD_QUEUE_H
+
+#include "LearnOpenGL/ShaderProgram.h"
+
+#include <vector>
+#include <chrono>
+#include <thread>
+
+
+/*
+ * Finishes a batch of programs constructed with ShaderProgram::EBuildMode::Deferred. Submitting all of them up front
+ * lets the driver compile them in parallel (KHR_parallel_shader_compile); the status & info log queries that would
+ * otherwise serialize compilation happen only once a program is done (Poll) or at the very end (WaitAll). Submit as early as
+ * possible & do other setup (buffers, texture loads...) before waiting, so that work overlaps compilation.
+ */
+class ShaderBuildQueue
+{
+public:
+    // Program must outlive the queue (or at least until it's finished)
+    void Submit(ShaderProgram& Program)
+    {
+        PendingPrograms.push_back(&Program);
+    }
+
+    // Finishes programs whose compilation is already complete without stalling; returns number of still pending programs
+    std::size_t Poll()
+    {
+        std::size_t pendingProgramsCount = 0;
+        for (ShaderProgram* program : PendingPrograms)
+        {
+            if (program->IsBuildComplete())
+            {
+                FinishProgramBuild(*program);
+            }
+            else
+            {
+                PendingPrograms[pendingProgramsCount++] = program;
+            }
+        }
+
+        PendingPrograms.resize(pendingProgramsCount);
+        return pendingProgramsCount;
+    }
+
+    // Blocks until every submitted program is built; returns number of programs that failed to compile/link
+    unsigned int WaitAll()
+    {
+        // finish whatever is ready first, sleeping between polls (rather than spinning) so the driver's compiler threads get the cores
+        while (GLExtensions::bHasParallelShaderCompile && Poll() > 0)
+        {
+            std::this_thread::sleep_for(POLL_INTERVAL);
+        }
+
+        for (ShaderProgram* program : PendingPrograms)
+        {
+            FinishProgramBuild(*program);
+        }
+        PendingPrograms.clear();
+
+        return FailedProgramsCount;
+    }
+
+    std::size_t GetPendingProgramsCount() const
+    {
+        return PendingPrograms.size();
+    }
+
+private:
+    static constexpr std::chrono::milliseconds POLL_INTERVAL = std::chrono::milliseconds(1);
+
+    void FinishProgramBuild(ShaderProgram& Program)
+    {
+        if (!Program.FinishBuild())
+        {
+            ++FailedProgramsCount;
+        }
+    }
+
+private:
+    std::vector<ShaderProgram*> PendingPrograms;
+    unsigned int FailedProgramsCount = 0;
+};
+#endif
@@ -0,0 +1,188 @@
+#ifndef SHADER_BUILD_TELEMETRY_H
+#define SHADER_BUILD_TELEMETRY_H
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+
+
+// Timings & inputs of a single program build (all times are spent blocking on the calling thread, in milliseconds)
+struct ShaderBuildRecord
+{
+    std::string VertexShaderFilePath;
+    std::string FragmentShaderFilePath;
+    // defines & specialization constants of the variant (empty for the plain program)
+    std::string VariantKey;
+    std::size_t VertexSourceBytes = 0;
+    std::size_t FragmentSourceBytes = 0;
+    bool bFromSpirV = false;
+    bool bCacheHit = false;
+    bool bLinked = false;
+    // submission of the compile/link call plus the wait for its status
+    double VertexCompileMilliseconds = 0.0;
+    double FragmentCompileMilliseconds = 0.0;
+    double LinkMilliseconds = 0.0;
+    // loading (and driver validation) of the cached program binary
+    double CacheLoadMilliseconds = 0.0;
+    // everything the build cost, including the above, preprocessing & uniform reflection
+    double TotalMilliseconds = 0.0;
+};
+
+/*
+ * Per program build telemetry recorded by ShaderProgram, to find out which shaders dominate the cold start.
+ * Builds are listed from the slowest by PrintSlowestPrograms, and dumped as JSON by WriteJson (see ReportAtExit for both).
+ * Deferred builds only count the time actually spent waiting on the driver, not the time the build was in flight.
+ */
+class ShaderBuildTelemetry
+{
+public:
+    static double MillisecondsSince(std::chrono::steady_clock::time_point StartTime)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTime).count();
+    }
+
+    static void Record(const ShaderBuildRecord& BuildRecord)
+    {
+        Records.push_back(BuildRecord);
+    }
+
+    static const std::vector<ShaderBuildRecord>& GetRecords()
+    {
+        return Records;
+    }
+
+    static void PrintSlowestPrograms(std::size_t MaxProgramsCount = 10)
+    {
+        const std::vector<ShaderBuildRecord> sortedRecords = GetRecordsSortedByTotalTime();
+
+        double totalMilliseconds = 0.0;
+        for (const ShaderBuildRecord& buildRecord : sortedRecords)
+        {
+            totalMilliseconds += buildRecord.TotalMilliseconds;
+        }
+
+        std::cout << "Slowest shader programs (" << sortedRecords.size() << " builds, " << totalMilliseconds << " ms in total):\n";
+        for (std::size_t recordIndex = 0; recordIndex < sortedRecords.size() && recordIndex < MaxProgramsCount; ++recordIndex)
+        {
+            const ShaderBuildRecord& buildRecord = sortedRecords[recordIndex];
+            std::cout << "  " << buildRecord.TotalMilliseconds << " ms: " << buildRecord.VertexShaderFilePath << " + " << buildRecord.FragmentShaderFilePath <<
+                (buildRecord.VariantKey.empty() ? "" : " [" + buildRecord.VariantKey + "]") <<
+                (buildRecord.bCacheHit ? " (cached binary)" : buildRecord.bFromSpirV ? " (SPIR-V)" : "") <<
+                " - vs " << buildRecord.VertexCompileMilliseconds << " ms, fs " << buildRecord.FragmentCompileMilliseconds <<
+                " ms, link " << buildRecord.LinkMilliseconds << " ms" << (buildRecord.bLinked ? "" : ", FAILED") << "\n";
+        }
+        std::cout << std::flush;
+    }
+
+    // Writes all the records, slowest first, as a JSON array of objects (field names match ShaderBuildRecord ones); creates missing directories
+    static bool WriteJson(const std::string& FilePath)
+    {
+        std::error_code errorCode;
+        const std::filesystem::path directoryPath = std::filesystem::path(FilePath).parent_path();
+        if (!directoryPath.empty())
+        {
+            std::filesystem::create_directories(directoryPath, errorCode);
+        }
+
+        std::ofstream jsonFile(FilePath, std::ios::trunc);
+        if (!jsonFile.is_open())
+        {
+            std::cout << "Failed to write shader build telemetry to " << FilePath << std::endl;
+            return false;
+        }
+
+        const std::vector<ShaderBuildRecord> sortedRecords = GetRecordsSortedByTotalTime();
+        jsonFile << "[\n";
+        for (std::size_t recordIndex = 0; recordIndex < sortedRecords.size(); ++recordIndex)
+        {
+            const ShaderBuildRecord& buildRecord = sortedRecords[recordIndex];
+            jsonFile << "  {" <<
+                "\"VertexShaderFilePath\": " << ToJsonString(buildRecord.VertexShaderFilePath) <<
+                ", \"FragmentShaderFilePath\": " << ToJsonString(buildRecord.FragmentShaderFilePath) <<
+                ", \"VariantKey\": " << ToJsonString(buildRecord.VariantKey) <<
+                ", \"VertexSourceBytes\": " << buildRecord.VertexSourceBytes <<
+                ", \"FragmentSourceBytes\": " << buildRecord.FragmentSourceBytes <<
+                ", \"FromSpirV\": " << (buildRecord.bFromSpirV ? "true" : "false") <<
+                ", \"CacheHit\": " << (buildRecord.bCacheHit ? "true" : "false") <<
+                ", \"Linked\": " << (buildRecord.bLinked ? "true" : "false") <<
+                ", \"VertexCompileMilliseconds\": " << buildRecord.VertexCompileMilliseconds <<
+                ", \"FragmentCompileMilliseconds\": " << buildRecord.FragmentCompileMilliseconds <<
+                ", \"LinkMilliseconds\": " << buildRecord.LinkMilliseconds <<
+                ", \"CacheLoadMilliseconds\": " << buildRecord.CacheLoadMilliseconds <<
+                ", \"TotalMilliseconds\": " << buildRecord.TotalMilliseconds <<
+                "}" << (recordIndex + 1 < sortedRecords.size() ? "," : "") << "\n";
+        }
+        jsonFile << "]\n";
+
+        return static_cast<bool>(jsonFile);
+    }
+
+    /*
+     * Prints the slowest programs & writes the JSON dump when the application exits (registered once, later calls only change the path).
+     * The dump goes next to the program binary cache by default, so it stays out of the source tree.
+     */
+    static void ReportAtExit(const std::string& JsonFilePath = "ShaderCache/ShaderBuildTelemetry.json")
+    {
+        const bool bRegistered = !ExitReportJsonFilePath.empty();
+        ExitReportJsonFilePath = JsonFilePath;
+        if (!bRegistered)
+        {
+            std::atexit([]()
+            {
+                PrintSlowestPrograms();
+                WriteJson(ExitReportJsonFilePath);
+            });
+        }
+    }
+
+private:
+    static std::vector<ShaderBuildRecord> GetRecordsSortedByTotalTime()
+    {
+        std::vector<ShaderBuildRecord> sortedRecords = Records;
+        std::stable_sort(sortedRecords.begin(), sortedRecords.end(), [](const ShaderBuildRecord& First, const ShaderBuildRecord& Second)
+        {
+            return First.TotalMilliseconds > Second.TotalMilliseconds;
+        });
+        return sortedRecords;
+    }
+
+    static std::string ToJsonString(const std::string& Value)
+    {
+        std::string jsonString = "\"";
+        for (const char character : Value)
+        {
+            switch (character)
+            {
+                case '"': jsonString += "\\\""; break;
+                case '\\': jsonString += "\\\\"; break;
+                case '\n': jsonString += "\\n"; break;
+                case '\t': jsonString += "\\t"; break;
+                default:
+                {
+                    if (static_cast<unsigned char>(character) < 0x20)
+                    {
+                        char escapedCharacter[8];
+                        std::snprintf(escapedCharacter, sizeof(escapedCharacter), "\\u%04x", static_cast<unsigned int>(character));
+                        jsonString += escapedCharacter;
+                    }
+                    else
+                    {
+                        jsonString += character;
+                    }
+                }
+            }
+        }
+        return jsonString + "\"";
+    }
+
+private:
+    inline static std::vector<ShaderBuildRecord> Records;
+    inline static std::string ExitReportJsonFilePath;
+};
+#endif
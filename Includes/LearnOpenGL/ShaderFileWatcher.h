@@ -0,0 +1,162 @@
+#ifndef SHADER_FILE_WATCHER_H
+#define SHADER_FILE_WATCHER_H
+
+#include "LearnOpenGL/FilePaths.h"
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <iostream>
+#include <unordered_map>
+#include <unordered_set>
+#include <filesystem>
+
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+
+
+/*
+ * Watches shader files for modifications on a background thread (Linux inotify). Parent directories are watched rather
+ * than the files themselves, so editors that save by writing a temporary file and renaming it over the original are caught too.
+ * Only Linux is supported: on other platforms (Windows & macOS included) the watcher is inert, Watch is accepted but no changes
+ * are ever reported, so hot reloading doesn't work there.
+ */
+class ShaderFileWatcher
+{
+public:
+    ShaderFileWatcher()
+    {
+#ifdef __linux__
+        InotifyFileDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (InotifyFileDescriptor < 0 || pipe(WakeUpPipe) != 0)
+        {
+            std::cout << "Failed to initialize inotify, shader files won't be watched for changes." << std::endl;
+            return;
+        }
+
+        WatcherThread = std::thread(&ShaderFileWatcher::Run, this);
+#else
+        std::cout << "Shader file watching relies on inotify, shader files won't be watched for changes on this platform." << std::endl;
+#endif
+    }
+
+    ~ShaderFileWatcher()
+    {
+#ifdef __linux__
+        if (WatcherThread.joinable())
+        {
+            // any byte written into the pipe wakes the thread up & makes it exit
+            const char wakeUpByte = 0;
+            [[maybe_unused]] const ssize_t writtenBytesCount = write(WakeUpPipe[1], &wakeUpByte, 1);
+            WatcherThread.join();
+            close(WakeUpPipe[0]);
+            close(WakeUpPipe[1]);
+        }
+
+        if (InotifyFileDescriptor >= 0)
+        {
+            close(InotifyFileDescriptor);
+        }
+#endif
+    }
+
+    ShaderFileWatcher(const ShaderFileWatcher&) = delete;
+    ShaderFileWatcher& operator=(const ShaderFileWatcher&) = delete;
+
+    // Files are identified by their NormalizePath
+    void Watch(const std::string& FilePath)
+    {
+        const std::filesystem::path normalizedFilePath = NormalizePath(FilePath);
+
+        std::lock_guard<std::mutex> lock(Mutex);
+        if (!WatchedFiles.insert(normalizedFilePath.string()).second)
+        {
+            return;
+        }
+
+#ifdef __linux__
+        const std::string directoryPath = normalizedFilePath.parent_path().string();
+        for (const auto& watchedDirectory : WatchedDirectories)
+        {
+            if (watchedDirectory.second == directoryPath)
+            {
+                return;
+            }
+        }
+
+        const int watchDescriptor = inotify_add_watch(InotifyFileDescriptor, directoryPath.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (watchDescriptor < 0)
+        {
+            std::cout << "Failed to watch shader directory " << directoryPath << std::endl;
+            return;
+        }
+        WatchedDirectories[watchDescriptor] = directoryPath;
+#endif
+    }
+
+    // Returns normalized paths of watched files modified since the previous call (each file reported once)
+    std::vector<std::string> ConsumeChangedFiles()
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        std::vector<std::string> changedFiles(ChangedFiles.begin(), ChangedFiles.end());
+        ChangedFiles.clear();
+        return changedFiles;
+    }
+
+private:
+#ifdef __linux__
+    void Run()
+    {
+        alignas(inotify_event) char eventsBuffer[4096];
+
+        pollfd polledFileDescriptors[2] = { { InotifyFileDescriptor, POLLIN, 0 }, { WakeUpPipe[0], POLLIN, 0 } };
+        while (true)
+        {
+            if (poll(polledFileDescriptors, 2, -1) < 0 || (polledFileDescriptors[1].revents & POLLIN) != 0)
+            {
+                return;
+            }
+
+            ssize_t readBytesCount;
+            while ((readBytesCount = read(InotifyFileDescriptor, eventsBuffer, sizeof(eventsBuffer))) > 0)
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                for (ssize_t eventOffset = 0; eventOffset < readBytesCount; )
+                {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(eventsBuffer + eventOffset);
+                    eventOffset += sizeof(inotify_event) + event->len;
+
+                    const auto watchedDirectory = WatchedDirectories.find(event->wd);
+                    if (event->len == 0 || watchedDirectory == WatchedDirectories.end())
+                    {
+                        continue;
+                    }
+
+                    const std::string changedFilePath = (std::filesystem::path(watchedDirectory->second) / event->name).string();
+                    if (WatchedFiles.count(changedFilePath) != 0)
+                    {
+                        ChangedFiles.insert(changedFilePath);
+                    }
+                }
+            }
+        }
+    }
+#endif
+
+private:
+    std::mutex Mutex;
+    std::unordered_set<std::string> WatchedFiles;
+    std::unordered_set<std::string> ChangedFiles;
+
+#ifdef __linux__
+    int InotifyFileDescriptor = -1;
+    int WakeUpPipe[2] = { -1, -1 };
+    std::unordered_map<int, std::string> WatchedDirectories;
+    std::thread WatcherThread;
+#endif
+};
+#endif
@@ -0,0 +1,138 @@
+#ifndef SHADER_HOT_RELOADER_H
+#define SHADER_HOT_RELOADER_H
+
+#include "LearnOpenGL/ShaderProgram.h"
+#include "LearnOpenGL/ShaderFileWatcher.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+
+/*
+ * Rebuilds registered programs whenever their source files (or files they #include) change on disk, without restarting
+ * the application. Only programs depending on a changed file are rebuilt; rebuilds are deferred (compiled by the driver
+ * in the background when parallel shader compilation is available) and swapped in by Update, which is meant to be called
+ * once per frame, at the frame boundary. A rebuild that fails to compile or link is dropped, and the last good program stays active.
+ */
+class ShaderHotReloader
+{
+public:
+    // Program must outlive the reloader
+    void Register(ShaderProgram& Program)
+    {
+        Programs.push_back(&Program);
+        WatchDependencies(Program);
+    }
+
+    // Starts rebuilds of programs affected by changed files & swaps in finished ones; returns number of swapped programs
+    unsigned int Update()
+    {
+        // dependency graph tells which root shader files (and so programs) are affected by each changed file
+        std::vector<std::string> affectedRootFiles;
+        for (const std::string& changedFile : Watcher.ConsumeChangedFiles())
+        {
+            const std::vector<std::string> changedFileDependents = ShaderProgram::GetPreprocessor().Invalidate(changedFile);
+            affectedRootFiles.insert(affectedRootFiles.end(), changedFileDependents.begin(), changedFileDependents.end());
+        }
+
+        for (ShaderProgram* program : Programs)
+        {
+            if (UsesAnyOf(*program, affectedRootFiles))
+            {
+                BeginReload(*program);
+            }
+        }
+
+        unsigned int swappedProgramsCount = 0;
+        for (auto pendingReload = PendingReloads.begin(); pendingReload != PendingReloads.end(); )
+        {
+            ShaderProgram& rebuiltProgram = *pendingReload->RebuiltProgram;
+            if (!rebuiltProgram.IsBuildComplete())
+            {
+                ++pendingReload;
+                continue;
+            }
+
+            if (rebuiltProgram.FinishBuild())
+            {
+                pendingReload->TargetProgram->AdoptRebuiltProgram(rebuiltProgram);
+                ++swappedProgramsCount;
+
+                // edit might have added new includes
+                WatchDependencies(*pendingReload->TargetProgram);
+                std::cout << "Reloaded shader program " << pendingReload->TargetProgram->GetVertexShaderFilePath() << " + " <<
+                    pendingReload->TargetProgram->GetFragmentShaderFilePath() << std::endl;
+            }
+            else
+            {
+                rebuiltProgram.DeleteProgram();
+                std::cout << "Shader program reload failed, keeping the last good one active." << std::endl;
+            }
+
+            pendingReload = PendingReloads.erase(pendingReload);
+        }
+
+        return swappedProgramsCount;
+    }
+
+private:
+    struct PendingReload
+    {
+        ShaderProgram* TargetProgram;
+        std::unique_ptr<ShaderProgram> RebuiltProgram;
+    };
+
+    void BeginReload(ShaderProgram& Program)
+    {
+        // a file saved again before the previous rebuild finished makes that rebuild obsolete
+        for (PendingReload& pendingReload : PendingReloads)
+        {
+            if (pendingReload.TargetProgram == &Program)
+            {
+                pendingReload.RebuiltProgram->DeleteProgram();
+                pendingReload.RebuiltProgram = CreateRebuiltProgram(Program);
+                return;
+            }
+        }
+
+        PendingReloads.push_back({ &Program, CreateRebuiltProgram(Program) });
+    }
+
+    static std::unique_ptr<ShaderProgram> CreateRebuiltProgram(const ShaderProgram& Program)
+    {
+        return std::make_unique<ShaderProgram>(Program.GetVertexShaderFilePath().c_str(), Program.GetFragmentShaderFilePath().c_str(),
+            Program.GetDefines(), Program.GetSpecialization(), ShaderProgram::EBuildMode::Deferred);
+    }
+
+    void WatchDependencies(const ShaderProgram& Program)
+    {
+        for (const std::string* rootFilePath : { &Program.GetVertexShaderFilePath(), &Program.GetFragmentShaderFilePath() })
+        {
+            Watcher.Watch(*rootFilePath);
+            for (const std::string& dependency : ShaderProgram::GetPreprocessor().GetDependencies(*rootFilePath))
+            {
+                Watcher.Watch(dependency);
+            }
+        }
+    }
+
+    static bool UsesAnyOf(const ShaderProgram& Program, const std::vector<std::string>& RootFiles)
+    {
+        const std::string vertexShaderFilePath = NormalizePath(Program.GetVertexShaderFilePath()).string();
+        const std::string fragmentShaderFilePath = NormalizePath(Program.GetFragmentShaderFilePath()).string();
+
+        return std::any_of(RootFiles.begin(), RootFiles.end(), [&](const std::string& RootFile)
+        {
+            return RootFile == vertexShaderFilePath || RootFile == fragmentShaderFilePath;
+        });
+    }
+
+private:
+    ShaderFileWatcher Watcher;
+    std::vector<ShaderProgram*> Programs;
+    std::vector<PendingReload> PendingReloads;
+};
+#endif
@@ -0,0 +1,336 @@
+#ifndef SHADER_PREPROCESSOR_H
+#define SHADER_PREPROCESSOR_H
+
+#include "LearnOpenGL/ShaderSourceLoader.h"
+#include "LearnOpenGL/FilePaths.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iostream>
+#include <unordered_map>
+#include <unordered_set>
+#include <filesystem>
+
+
+/*
+ * Resolves #include "file" (relative to the including file, then include directories) and #include <file> (include
+ * directories only) in GLSL sources. Every file is included at most once per expansion, so shared chunks may include each
+ * other freely, and #line directives keep compiler messages pointing at the original file & line: file N in messages is
+ * the N-th file of GetDependencies.
+ *
+ * Files are read once and cached, and so are expansions, which are additionally shared by content hash (identical
+ * expansions, e.g. of copy-pasted shaders, are stored once). The include dependency graph makes Invalidate drop only
+ * the expansions of root files that actually depend on the changed file.
+ */
+class ShaderPreprocessor
+{
+public:
+    void AddIncludeDirectory(const std::string& IncludeDirectory)
+    {
+        IncludeDirectories.push_back(NormalizePath(IncludeDirectory));
+    }
+
+    // Expanded source of the given root file (stays valid until an Invalidate affecting it); invalid view if root can't be read
+    ShaderSourceView Expand(const std::string& RootFilePath)
+    {
+        const std::string rootFileKey = NormalizePath(RootFilePath).string();
+
+        Expansion& expansion = Expansions[rootFileKey];
+        if (expansion.ExpandedSourceCode == nullptr)
+        {
+            const SourceFile& rootFile = LoadSourceFile(rootFileKey);
+            if (!rootFile.bLoaded)
+            {
+                Expansions.erase(rootFileKey);
+                return {};
+            }
+
+            // gather the files the root is made of first, as their content hashes identify the expansion
+            expansion.Dependencies.clear();
+            CollectDependencies(rootFileKey, expansion.Dependencies);
+
+            std::uint64_t contentHash = 14695981039346656037ull;
+            for (const std::string& dependency : expansion.Dependencies)
+            {
+                contentHash = (contentHash ^ SourceFiles[dependency].ContentHash) * 1099511628211ull;
+                Dependents[dependency].insert(rootFileKey);
+            }
+
+            std::weak_ptr<const std::string>& sharedExpansion = ExpansionsByContentHash[contentHash];
+            expansion.ExpandedSourceCode = sharedExpansion.lock();
+            if (expansion.ExpandedSourceCode == nullptr)
+            {
+                expansion.ExpandedSourceCode = std::make_shared<const std::string>(BuildExpansion(expansion.Dependencies));
+                sharedExpansion = expansion.ExpandedSourceCode;
+            }
+        }
+
+        return { expansion.ExpandedSourceCode->c_str(), static_cast<GLint>(expansion.ExpandedSourceCode->size()) };
+    }
+
+    /*
+     * Copy of the source with "#define NAME VALUE" lines (from "NAME" or "NAME=VALUE" entries) inserted right after the
+     * #version directive, which has to stay the first one. A #line directive keeps following line numbers intact.
+     */
+    static std::string InjectDefines(std::string_view SourceCode, const std::vector<std::string>& Defines)
+    {
+        std::size_t insertionPosition = 0;
+        int insertionLineNumber = 1;
+
+        const std::size_t versionDirectivePosition = SourceCode.find("#version");
+        if (versionDirectivePosition != std::string_view::npos)
+        {
+            const std::size_t versionLineEnd = SourceCode.find('\n', versionDirectivePosition);
+            insertionPosition = versionLineEnd == std::string_view::npos ? SourceCode.size() : versionLineEnd + 1;
+            for (std::size_t characterIndex = 0; characterIndex < insertionPosition; ++characterIndex)
+            {
+                insertionLineNumber += SourceCode[characterIndex] == '\n' ? 1 : 0;
+            }
+        }
+
+        std::string injectedSourceCode(SourceCode.substr(0, insertionPosition));
+        if (!injectedSourceCode.empty() && injectedSourceCode.back() != '\n')
+        {
+            injectedSourceCode += '\n';
+        }
+
+        for (const std::string& define : Defines)
+        {
+            const std::size_t valueSeparatorPosition = define.find('=');
+            injectedSourceCode += "#define " + (valueSeparatorPosition == std::string::npos ? define :
+                define.substr(0, valueSeparatorPosition) + " " + define.substr(valueSeparatorPosition + 1)) + "\n";
+        }
+
+        injectedSourceCode += "#line " + std::to_string(insertionLineNumber) + " 0\n";
+        injectedSourceCode.append(SourceCode.substr(insertionPosition));
+        return injectedSourceCode;
+    }
+
+    // Normalized paths of all files the (already expanded) root file is made of, the root itself being the first one
+    std::vector<std::string> GetDependencies(const std::string& RootFilePath) const
+    {
+        const auto expansion = Expansions.find(NormalizePath(RootFilePath).string());
+        return expansion != Expansions.end() ? expansion->second.Dependencies : std::vector<std::string>();
+    }
+
+    // Drops cached content of the changed file & expansions depending on it; returns normalized paths of affected root files
+    std::vector<std::string> Invalidate(const std::string& ChangedFilePath)
+    {
+        const std::string changedFileKey = NormalizePath(ChangedFilePath).string();
+        SourceFiles.erase(changedFileKey);
+
+        std::vector<std::string> affectedRootFiles;
+        const auto dependents = Dependents.find(changedFileKey);
+        if (dependents != Dependents.end())
+        {
+            for (const std::string& rootFileKey : dependents->second)
+            {
+                // dependency graph of the root gets rebuilt by the next expansion, as the edit may have changed its includes
+                Expansions.erase(rootFileKey);
+                affectedRootFiles.push_back(rootFileKey);
+            }
+            Dependents.erase(dependents);
+        }
+
+        return affectedRootFiles;
+    }
+
+private:
+    struct IncludeDirective
+    {
+        // byte range of the directive line (including its line break) within the including file
+        std::size_t LineStart;
+        std::size_t LineEnd;
+        // 1-based number of the directive line
+        int LineNumber;
+        // normalized path of resolved file, empty if it couldn't be resolved
+        std::string ResolvedFilePath;
+        std::string RequestedFilePath;
+    };
+
+    struct SourceFile
+    {
+        std::string SourceCode;
+        std::uint64_t ContentHash = 0;
+        std::vector<IncludeDirective> Includes;
+        bool bLoaded = false;
+    };
+
+    struct Expansion
+    {
+        std::shared_ptr<const std::string> ExpandedSourceCode;
+        std::vector<std::string> Dependencies;
+    };
+
+    const SourceFile& LoadSourceFile(const std::string& FileKey)
+    {
+        SourceFile& sourceFile = SourceFiles[FileKey];
+        if (sourceFile.bLoaded)
+        {
+            return sourceFile;
+        }
+
+        sourceFile.bLoaded = ReadShaderSourceFile(FileKey.c_str(), sourceFile.SourceCode);
+        if (!sourceFile.bLoaded)
+        {
+            std::cout << "Failed to properly read shader source code file: " << FileKey << std::endl;
+            return sourceFile;
+        }
+
+        sourceFile.ContentHash = 14695981039346656037ull;
+        for (const char character : sourceFile.SourceCode)
+        {
+            sourceFile.ContentHash = (sourceFile.ContentHash ^ static_cast<unsigned char>(character)) * 1099511628211ull;
+        }
+
+        ParseIncludes(FileKey, sourceFile);
+        return sourceFile;
+    }
+
+    void ParseIncludes(const std::string& FileKey, SourceFile& InOutSourceFile) const
+    {
+        const std::string& sourceCode = InOutSourceFile.SourceCode;
+        const std::filesystem::path includingDirectory = std::filesystem::path(FileKey).parent_path();
+
+        int lineNumber = 1;
+        for (std::size_t lineStart = 0; lineStart < sourceCode.size(); ++lineNumber)
+        {
+            std::size_t lineEnd = sourceCode.find('\n', lineStart);
+            lineEnd = lineEnd == std::string::npos ? sourceCode.size() : lineEnd + 1;
+
+            const std::string_view line(sourceCode.data() + lineStart, lineEnd - lineStart);
+            const std::size_t directiveStart = line.find_first_not_of(" \t");
+            if (directiveStart != std::string_view::npos && line.compare(directiveStart, 8, "#include") == 0)
+            {
+                const std::size_t openingDelimiter = line.find_first_of("\"<", directiveStart + 8);
+                const std::size_t closingDelimiter = openingDelimiter == std::string_view::npos ? std::string_view::npos :
+                    line.find(line[openingDelimiter] == '"' ? '"' : '>', openingDelimiter + 1);
+
+                IncludeDirective include;
+                include.LineStart = lineStart;
+                include.LineEnd = lineEnd;
+                include.LineNumber = lineNumber;
+                if (closingDelimiter != std::string_view::npos)
+                {
+                    include.RequestedFilePath = std::string(line.substr(openingDelimiter + 1, closingDelimiter - openingDelimiter - 1));
+                    include.ResolvedFilePath = ResolveInclude(include.RequestedFilePath, line[openingDelimiter] == '"' ? &includingDirectory : nullptr);
+                }
+                InOutSourceFile.Includes.push_back(std::move(include));
+            }
+
+            lineStart = lineEnd;
+        }
+    }
+
+    std::string ResolveInclude(const std::string& RequestedFilePath, const std::filesystem::path* IncludingDirectory) const
+    {
+        std::error_code errorCode;
+        if (IncludingDirectory != nullptr && std::filesystem::is_regular_file(*IncludingDirectory / RequestedFilePath, errorCode))
+        {
+            return (*IncludingDirectory / RequestedFilePath).lexically_normal().string();
+        }
+
+        for (const std::filesystem::path& includeDirectory : IncludeDirectories)
+        {
+            if (std::filesystem::is_regular_file(includeDirectory / RequestedFilePath, errorCode))
+            {
+                return (includeDirectory / RequestedFilePath).lexically_normal().string();
+            }
+        }
+
+        return {};
+    }
+
+    // Appends files the given one is made of in the order of their first inclusion (each file at most once)
+    void CollectDependencies(const std::string& FileKey, std::vector<std::string>& InOutDependencies)
+    {
+        for (const std::string& dependency : InOutDependencies)
+        {
+            if (dependency == FileKey)
+            {
+                return;
+            }
+        }
+        InOutDependencies.push_back(FileKey);
+
+        const SourceFile& sourceFile = LoadSourceFile(FileKey);
+        for (const IncludeDirective& include : sourceFile.Includes)
+        {
+            if (!include.ResolvedFilePath.empty() && LoadSourceFile(include.ResolvedFilePath).bLoaded)
+            {
+                CollectDependencies(include.ResolvedFilePath, InOutDependencies);
+            }
+        }
+    }
+
+    std::string BuildExpansion(const std::vector<std::string>& Dependencies)
+    {
+        std::string expandedSourceCode;
+        std::unordered_set<std::string> includedFiles;
+        AppendExpandedFile(Dependencies.front(), Dependencies, includedFiles, expandedSourceCode);
+        return expandedSourceCode;
+    }
+
+    void AppendExpandedFile(const std::string& FileKey, const std::vector<std::string>& Dependencies,
+        std::unordered_set<std::string>& InOutIncludedFiles, std::string& OutExpandedSourceCode)
+    {
+        InOutIncludedFiles.insert(FileKey);
+
+        const SourceFile& sourceFile = SourceFiles[FileKey];
+        const int fileIndex = GetFileIndex(FileKey, Dependencies);
+
+        std::size_t copiedUntil = 0;
+        for (const IncludeDirective& include : sourceFile.Includes)
+        {
+            OutExpandedSourceCode.append(sourceFile.SourceCode, copiedUntil, include.LineStart - copiedUntil);
+            copiedUntil = include.LineEnd;
+
+            if (include.ResolvedFilePath.empty() || !SourceFiles[include.ResolvedFilePath].bLoaded)
+            {
+                // let the compiler report it, along with the rest of compilation errors
+                OutExpandedSourceCode += "#error cannot open include file \"" + include.RequestedFilePath + "\"\n";
+                continue;
+            }
+
+            if (InOutIncludedFiles.count(include.ResolvedFilePath) == 0)
+            {
+                OutExpandedSourceCode += "#line 1 " + std::to_string(GetFileIndex(include.ResolvedFilePath, Dependencies)) + "\n";
+                AppendExpandedFile(include.ResolvedFilePath, Dependencies, InOutIncludedFiles, OutExpandedSourceCode);
+                if (!OutExpandedSourceCode.empty() && OutExpandedSourceCode.back() != '\n')
+                {
+                    OutExpandedSourceCode += '\n';
+                }
+            }
+
+            // resume numbering at the line following the directive
+            OutExpandedSourceCode += "#line " + std::to_string(include.LineNumber + 1) + " " + std::to_string(fileIndex) + "\n";
+        }
+
+        OutExpandedSourceCode.append(sourceFile.SourceCode, copiedUntil, std::string::npos);
+    }
+
+    static int GetFileIndex(const std::string& FileKey, const std::vector<std::string>& Dependencies)
+    {
+        for (std::size_t dependencyIndex = 0; dependencyIndex < Dependencies.size(); ++dependencyIndex)
+        {
+            if (Dependencies[dependencyIndex] == FileKey)
+            {
+                return static_cast<int>(dependencyIndex);
+            }
+        }
+
+        return 0;
+    }
+
+private:
+    std::vector<std::filesystem::path> IncludeDirectories;
+    std::unordered_map<std::string, SourceFile> SourceFiles;
+    std::unordered_map<std::string, Expansion> Expansions;
+    std::unordered_map<std::uint64_t, std::weak_ptr<const std::string>> ExpansionsByContentHash;
+    // reversed include graph: file -> root files whose expansions include it
+    std::unordered_map<std::string, std::unordered_set<std::string>> Dependents;
+};
+#endif
@@ -3,110 +3,755 @@
 
 #include <glad/glad.h>
 
+#include "LearnOpenGL/UniformLocationTable.h"
+#include "LearnOpenGL/UniformBlock.h"
+#include "LearnOpenGL/GLStateCache.h"
+#include "LearnOpenGL/ProgramBinaryCache.h"
+#include "LearnOpenGL/ShaderSourceLoader.h"
+#include "LearnOpenGL/ShaderPreprocessor.h"
+#include "LearnOpenGL/SpirVShaderLoader.h"
+#include "LearnOpenGL/ShaderSpecialization.h"
+#include "LearnOpenGL/ShaderBuildTelemetry.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
 #include <string>
-#include <fstream>
-#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <initializer_list>
 #include <iostream>
+#include <chrono>
 #include <filesystem>
 #include <experimental/filesystem>
 
 
+// Matrix uniform & its new value, for setting several of them at once (see ShaderProgram::SetProgramUniforms)
+struct UniformMatrixValue
+{
+    UniformKey Key;
+    const glm::mat4& Value;
+};
+
 class ShaderProgram
 {
 public:
+    enum class EBuildMode : unsigned int
+    {
+        // compile & link right in the constructor, reporting errors immediately
+        Immediate,
+        // only submit compilation & linkage, so the driver can compile many programs in parallel; finish with FinishBuild (or ShaderBuildQueue)
+        Deferred
+    };
+
     // Constructor generates shader program on the fly
-    ShaderProgram(const char* VertexShaderSourceFilePath, const char* FragmentShaderSourceFilePath)
+    ShaderProgram(const char* VertexShaderSourceFilePath, const char* FragmentShaderSourceFilePath, EBuildMode BuildMode = EBuildMode::Immediate)
+        : ShaderProgram(VertexShaderSourceFilePath, FragmentShaderSourceFilePath, {}, BuildMode)
     {
-        // 1. retrieve the vertex & fragment shaders source code from files
-        std::string vertexShaderSourceCode;
-        std::string fragmentShaderSourceCode;
-        std::ifstream vertexShaderSourceFile;
-        std::ifstream fragmentShaderSourceFile;
+    }
 
-        // ensure ifstream objects can throw exceptions:
-        vertexShaderSourceFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-        fragmentShaderSourceFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-        
-        try 
+    // Same as above, but with the given defines ("NAME" or "NAME=VALUE") injected into both stages right after #version
+    ShaderProgram(const char* VertexShaderSourceFilePath, const char* FragmentShaderSourceFilePath, const std::vector<std::string>& ShaderDefines,
+        EBuildMode BuildMode = EBuildMode::Immediate)
+        : ShaderProgram(VertexShaderSourceFilePath, FragmentShaderSourceFilePath, ShaderDefines, ShaderSpecialization(), BuildMode)
+    {
+    }
+
+    // Same as above, with uniforms of both stages named in Constants baked in as compile-time constants (see ShaderSpecialization)
+    ShaderProgram(const char* VertexShaderSourceFilePath, const char* FragmentShaderSourceFilePath, const std::vector<std::string>& ShaderDefines,
+        const ShaderSpecialization& Constants, EBuildMode BuildMode = EBuildMode::Immediate)
+        : VertexShaderFilePath(VertexShaderSourceFilePath), FragmentShaderFilePath(FragmentShaderSourceFilePath), Defines(ShaderDefines),
+        Specialization(Constants)
+    {
+        const std::chrono::steady_clock::time_point constructionStartTime = std::chrono::steady_clock::now();
+        SubmitBuild(true);
+        BuildRecord.TotalMilliseconds = ShaderBuildTelemetry::MillisecondsSince(constructionStartTime);
+        if (BuildMode == EBuildMode::Immediate)
         {
-            vertexShaderSourceFile.open(VertexShaderSourceFilePath);
-            fragmentShaderSourceFile.open(FragmentShaderSourceFilePath);
+            FinishBuild();
+        }
+    }
 
-            // read file's buffer contents into streams
-            std::stringstream vertexShaderStream, fragmentShaderStream;
-            vertexShaderStream << vertexShaderSourceFile.rdbuf();
-            fragmentShaderStream << fragmentShaderSourceFile.rdbuf();
-            
-            // close file handlers
-            vertexShaderSourceFile.close();
-            fragmentShaderSourceFile.close();
-            
-            // convert streams into strings
-            vertexShaderSourceCode = vertexShaderStream.str();
-            fragmentShaderSourceCode = fragmentShaderStream.str();
+    // Activate shader program (waits for its build to complete first, if it's still in flight); no driver call if it's already active
+    void UseProgram() 
+    { 
+        FinishBuild();
+        GLStateCache::UseProgram(ProgramID); 
+    }
+
+    // Non-blocking check whether deferred build can be finished without stalling (always true without parallel compile support)
+    bool IsBuildComplete() const
+    {
+        if (!bBuildPending || !GLExtensions::bHasParallelShaderCompile)
+        {
+            return true;
+        }
+
+        GLint bCompletionStatus = GL_FALSE;
+        glGetProgramiv(ProgramID, GL_COMPLETION_STATUS_KHR, &bCompletionStatus);
+        return bCompletionStatus == GL_TRUE;
+    }
+
+    /*
+     * Waits for the pending build (if any), reports compilation/linkage errors and prepares program for use.
+     * Returns whether program was linked successfully; calling it again once the build is finished is cheap.
+     */
+    bool FinishBuild()
+    {
+        if (!bBuildPending)
+        {
+            return bLinked;
         }
-        catch (std::ifstream::failure& e)
+        bBuildPending = false;
+        const std::chrono::steady_clock::time_point finishStartTime = std::chrono::steady_clock::now();
+
+        if (bLoadedFromCache)
         {
-            std::cout << "Failed to properly read shader source code file: " << e.what() << std::endl;
+            bLinked = true;
         }
-        
-        // 2. compile shaders
-        unsigned int vertexShader, fragmentShader;
-        const char* vertexShaderSourceCodePtr = vertexShaderSourceCode.c_str();
-        const char * fragmentShaderSourceCodePtr = fragmentShaderSourceCode.c_str();
-
-        // vertex shader
-        vertexShader = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertexShader, 1, &vertexShaderSourceCodePtr, nullptr);
-        glCompileShader(vertexShader);
-        CheckEntityCompilationErrors(vertexShader, EEntityType::VertexShader);
-
-        // fragment Shader
-        fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragmentShader, 1, &fragmentShaderSourceCodePtr, nullptr);
-        glCompileShader(fragmentShader);
-        CheckEntityCompilationErrors(fragmentShader, EEntityType::FragmentShader);
-
-        // shader Program
-        ProgramID = glCreateProgram();
-        glAttachShader(ProgramID, vertexShader);
-        glAttachShader(ProgramID, fragmentShader);
-        glLinkProgram(ProgramID);
-        CheckEntityCompilationErrors(ProgramID, EEntityType::ShaderProgram);
+        else
+        {
+            // all status & info log queries are issued only now, so they don't serialize the driver's compilation
+            // (each of them waits for its job, so their timings tell how long the compiler worked on every stage)
+            std::chrono::steady_clock::time_point waitStartTime = std::chrono::steady_clock::now();
+            CheckEntityCompilationErrors(PendingVertexShaderID, EEntityType::VertexShader);
+            BuildRecord.VertexCompileMilliseconds += ShaderBuildTelemetry::MillisecondsSince(waitStartTime);
+
+            waitStartTime = std::chrono::steady_clock::now();
+            CheckEntityCompilationErrors(PendingFragmentShaderID, EEntityType::FragmentShader);
+            BuildRecord.FragmentCompileMilliseconds += ShaderBuildTelemetry::MillisecondsSince(waitStartTime);
+
+            waitStartTime = std::chrono::steady_clock::now();
+            bLinked = CheckEntityCompilationErrors(ProgramID, EEntityType::ShaderProgram);
+            BuildRecord.LinkMilliseconds += ShaderBuildTelemetry::MillisecondsSince(waitStartTime);
 
-        // delete the shaders as they're linked into our program now and no longer necessary
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
+            // delete the shaders as they're linked into our program now and no longer necessary
+            glDeleteShader(PendingVertexShaderID);
+            glDeleteShader(PendingFragmentShaderID);
+            PendingVertexShaderID = 0;
+            PendingFragmentShaderID = 0;
+        }
+
+        // uniforms & blocks are set up by name, so a SPIR-V program the driver didn't keep the names of is useless as is
+        if (bFromSpirV && bLinked)
+        {
+            const int unresolvedNamesCount = SpirVShaderLoader::CountUnresolvedNames(ProgramID);
+            if (unresolvedNamesCount > 0)
+            {
+                std::cout << "Baked SPIR-V program failed name lookups: " << unresolvedNamesCount << " uniforms/uniform blocks of " << VertexShaderFilePath <<
+                    " + " << FragmentShaderFilePath << " can't be found by name, building it from GLSL instead" << std::endl;
+
+                glDeleteProgram(ProgramID);
+                GLStateCache::OnProgramDeleted(ProgramID);
+                SubmitBuild(false);
+                BuildRecord.TotalMilliseconds += ShaderBuildTelemetry::MillisecondsSince(finishStartTime);
+                return FinishBuild();
+            }
+        }
+
+        // store linked program, so next launches can skip compilation
+        if (bUseBinaryCache && bLinked && !bLoadedFromCache)
+        {
+            ProgramBinaryCache::Store(ProgramID, BinaryCacheKey);
+        }
+
+        // look up all active uniforms once, so uniform setters never have to query the driver
+        UniformLocations.Build(ProgramID);
+
+        // uniform blocks read from the binding points shared by all programs (binding isn't part of the program binary, so it's set after every build)
+        if (bLinked)
+        {
+            UniformBlockBindings::BindProgramBlocks(ProgramID);
+        }
+
+        const std::chrono::duration<double, std::milli> buildTime = std::chrono::steady_clock::now() - BuildStartTime;
+        ProgramBinaryCache::RecordProgramBuild(bLoadedFromCache, buildTime.count());
+
+        BuildRecord.bCacheHit = bLoadedFromCache;
+        BuildRecord.bLinked = bLinked;
+        BuildRecord.TotalMilliseconds += ShaderBuildTelemetry::MillisecondsSince(finishStartTime);
+        ShaderBuildTelemetry::Record(BuildRecord);
+
+        return bLinked;
     }
 
-    // Activate shader program
-    void UseProgram() 
-    { 
-        glUseProgram(ProgramID); 
+    bool IsLinked() const
+    {
+        return bLinked;
+    }
+
+    // Whether program was built from baked SPIR-V binaries rather than GLSL sources
+    bool IsBuiltFromSpirV() const
+    {
+        return bFromSpirV;
+    }
+
+    const std::string& GetVertexShaderFilePath() const
+    {
+        return VertexShaderFilePath;
+    }
+
+    const std::string& GetFragmentShaderFilePath() const
+    {
+        return FragmentShaderFilePath;
+    }
+
+    const std::vector<std::string>& GetDefines() const
+    {
+        return Defines;
+    }
+
+    const ShaderSpecialization& GetSpecialization() const
+    {
+        return Specialization;
+    }
+
+    /*
+     * Takes over GL program of successfully built Rebuilt program (e.g. after a hot reload) and deletes the current one.
+     * Values of uniforms present in both programs are carried over, and the program stays bound if it was the current one.
+     */
+    void AdoptRebuiltProgram(ShaderProgram& Rebuilt)
+    {
+        GLint currentProgramID = 0;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgramID);
+
+        CopyUniformValues(ProgramID, Rebuilt.ProgramID);
+
+        // uniforms copying switched programs behind the state cache's back
+        GLStateCache::InvalidateProgram();
+        GLStateCache::UseProgram(static_cast<unsigned int>(currentProgramID) == ProgramID ? Rebuilt.ProgramID : static_cast<unsigned int>(currentProgramID));
+
+        glDeleteProgram(ProgramID);
+        GLStateCache::OnProgramDeleted(ProgramID);
+        ProgramID = Rebuilt.ProgramID;
+        UniformLocations = std::move(Rebuilt.UniformLocations);
+        bLinked = Rebuilt.bLinked;
+        bFromSpirV = Rebuilt.bFromSpirV;
+        Rebuilt.ProgramID = 0;
+    }
+
+    // Deletes GL program, dropping its build if it's still in flight (there's no destructor doing that, as programs are copied around by value)
+    void DeleteProgram()
+    {
+        if (bBuildPending)
+        {
+            glDeleteShader(PendingVertexShaderID);
+            glDeleteShader(PendingFragmentShaderID);
+            PendingVertexShaderID = 0;
+            PendingFragmentShaderID = 0;
+            bBuildPending = false;
+        }
+
+        glDeleteProgram(ProgramID);
+        GLStateCache::OnProgramDeleted(ProgramID);
+        ProgramID = 0;
+        bLinked = false;
     }
 
 // utility uniform functions
+// (uniforms are set straight on the program with glProgramUniform* where available, so it doesn't have to be in use;
+// otherwise the program is made current first)
 
     void SetProgramUniform(const std::string& UniformName, bool NewValue) const
     {         
-        glUniform1i(glGetUniformLocation(ProgramID, UniformName.c_str()), (int)NewValue); 
+        SetProgramUniform(UniformName, (int)NewValue); 
     }
 
     void SetProgramUniform(const std::string& UniformName, int NewValue) const
     { 
-        glUniform1i(glGetUniformLocation(ProgramID, UniformName.c_str()), NewValue); 
+        UploadUniform(FindUniformLocation(UniformName), 1, &NewValue); 
     }
 
     void SetProgramUniform(const std::string& UniformName, float NewValue) const
     { 
-        glUniform1f(glGetUniformLocation(ProgramID, UniformName.c_str()), NewValue); 
+        UploadUniform(FindUniformLocation(UniformName), 1, &NewValue); 
+    }
+
+    void SetProgramUniform(const std::string& UniformName, const glm::vec2& NewValue) const
+    {
+        UploadUniform(FindUniformLocation(UniformName), 1, &NewValue);
+    }
+
+    void SetProgramUniform(const std::string& UniformName, const glm::vec3& NewValue) const
+    {
+        UploadUniform(FindUniformLocation(UniformName), 1, &NewValue);
+    }
+
+    void SetProgramUniform(const std::string& UniformName, const glm::vec4& NewValue) const
+    {
+        UploadUniform(FindUniformLocation(UniformName), 1, &NewValue);
+    }
+
+    void SetProgramUniform(const std::string& UniformName, const glm::mat3& NewValue) const
+    {
+        UploadUniform(FindUniformLocation(UniformName), 1, &NewValue);
+    }
+
+    void SetProgramUniform(const std::string& UniformName, const glm::mat4& NewValue) const
+    {
+        UploadUniform(FindUniformLocation(UniformName), 1, &NewValue);
+    }
+
+    // Sets Count consecutive elements of a uniform array (int, float, glm vectors & matrices) in a single call, e.g. per-object transforms
+    template <typename ValueType>
+    void SetProgramUniformArray(const std::string& UniformName, const ValueType* NewValues, GLsizei Count) const
+    {
+        UploadUniform(FindUniformLocation(UniformName), Count, NewValues);
+    }
+
+    // precomputed key overloads, preferable in hot loops, as they skip string hashing & comparison altogether
+
+    void SetProgramUniform(UniformKey Key, bool NewValue) const
+    {
+        SetProgramUniform(Key, (int)NewValue);
+    }
+
+    void SetProgramUniform(UniformKey Key, int NewValue) const
+    {
+        UploadUniform(FindUniformLocation(Key), 1, &NewValue);
+    }
+
+    void SetProgramUniform(UniformKey Key, float NewValue) const
+    {
+        UploadUniform(FindUniformLocation(Key), 1, &NewValue);
+    }
+
+    void SetProgramUniform(UniformKey Key, const glm::vec2& NewValue) const
+    {
+        UploadUniform(FindUniformLocation(Key), 1, &NewValue);
+    }
+
+    void SetProgramUniform(UniformKey Key, const glm::vec3& NewValue) const
+    {
+        UploadUniform(FindUniformLocation(Key), 1, &NewValue);
+    }
+
+    void SetProgramUniform(UniformKey Key, const glm::vec4& NewValue) const
+    {
+        UploadUniform(FindUniformLocation(Key), 1, &NewValue);
+    }
+
+    void SetProgramUniform(UniformKey Key, const glm::mat3& NewValue) const
+    {
+        UploadUniform(FindUniformLocation(Key), 1, &NewValue);
+    }
+
+    void SetProgramUniform(UniformKey Key, const glm::mat4& NewValue) const
+    {
+        UploadUniform(FindUniformLocation(Key), 1, &NewValue);
+    }
+
+    template <typename ValueType>
+    void SetProgramUniformArray(UniformKey Key, const ValueType* NewValues, GLsizei Count) const
+    {
+        UploadUniform(FindUniformLocation(Key), Count, NewValues);
+    }
+
+    // Batch form: sets several matrix uniforms (e.g. model/view/projection) at once, making the program current at most once on the fallback path
+    void SetProgramUniforms(std::initializer_list<UniformMatrixValue> NewValues) const
+    {
+        for (const UniformMatrixValue& newValue : NewValues)
+        {
+            UploadUniform(FindUniformLocation(newValue.Key), 1, &newValue.Value);
+        }
+    }
+
+    // Preprocessor shared by all programs (add include directories to it, invalidate changed files in it)
+    static ShaderPreprocessor& GetPreprocessor()
+    {
+        return Preprocessor;
+    }
+
+    // Returns uniform lookup counters accumulated since the last call and starts counting anew (call it once per frame)
+    static UniformLookupStats ConsumeUniformLookupStats()
+    {
+        const UniformLookupStats frameStats = FrameUniformLookupStats;
+        FrameUniformLookupStats = UniformLookupStats();
+        return frameStats;
     }
 
 private:
 
-    // utility function for checking shader/shader program compilation/linking errors (respectively)
+    /*
+     * Retrieves source code of both stages & submits their build (see BeginBuild). Baked SPIR-V binaries are only considered
+     * if bAllowSpirV is set; it's cleared when rebuilding a SPIR-V program from GLSL.
+     */
+    void SubmitBuild(bool bAllowSpirV)
+    {
+        // 1. retrieve the vertex & fragment shaders source code from files, with #includes expanded (both are cached by the preprocessor)
+        ShaderSourceView vertexShaderSourceCode = Preprocessor.Expand(VertexShaderFilePath);
+        ShaderSourceView fragmentShaderSourceCode = Preprocessor.Expand(FragmentShaderFilePath);
+
+        for (ShaderSourceView* sourceCode : { &vertexShaderSourceCode, &fragmentShaderSourceCode })
+        {
+            if (!sourceCode->IsValid())
+            {
+                // compile empty source instead, so the failure still surfaces as a regular compilation error
+                *sourceCode = { "", 0 };
+            }
+        }
+
+        // up to date baked SPIR-V skips the driver's GLSL front end altogether (variants aren't baked, as defines are GLSL only;
+        // specialization is applied to SPIR-V by the driver instead); only used by shaders which don't look their uniforms up by name
+        std::string vertexShaderBinary;
+        std::string fragmentShaderBinary;
+        bFromSpirV = false;
+        if (bAllowSpirV && Defines.empty() && SpirVShaderLoader::IsAvailable() &&
+            SpirVShaderLoader::DeclaresExplicitUniformLayouts(vertexShaderSourceCode.ToStringView()) &&
+            SpirVShaderLoader::DeclaresExplicitUniformLayouts(fragmentShaderSourceCode.ToStringView()) &&
+            SpirVShaderLoader::LoadUpToDateBinary(VertexShaderFilePath, Preprocessor.GetDependencies(VertexShaderFilePath), vertexShaderBinary) &&
+            SpirVShaderLoader::LoadUpToDateBinary(FragmentShaderFilePath, Preprocessor.GetDependencies(FragmentShaderFilePath), fragmentShaderBinary))
+        {
+            bFromSpirV = true;
+            vertexShaderSourceCode = { vertexShaderBinary.data(), static_cast<GLint>(vertexShaderBinary.size()) };
+            fragmentShaderSourceCode = { fragmentShaderBinary.data(), static_cast<GLint>(fragmentShaderBinary.size()) };
+        }
+
+        // defined & specialized variants need their own copy of the (otherwise shared) expanded source
+        std::string vertexShaderVariantSourceCode;
+        std::string fragmentShaderVariantSourceCode;
+        if (!bFromSpirV && (!Defines.empty() || !Specialization.IsEmpty()))
+        {
+            std::vector<std::string> specializedNames;
+            vertexShaderVariantSourceCode = MakeVariantSourceCode(vertexShaderSourceCode.ToStringView(), specializedNames);
+            fragmentShaderVariantSourceCode = MakeVariantSourceCode(fragmentShaderSourceCode.ToStringView(), specializedNames);
+            vertexShaderSourceCode = { vertexShaderVariantSourceCode.c_str(), static_cast<GLint>(vertexShaderVariantSourceCode.size()) };
+            fragmentShaderSourceCode = { fragmentShaderVariantSourceCode.c_str(), static_cast<GLint>(fragmentShaderVariantSourceCode.size()) };
+
+            for (const std::string& constantName : Specialization.GetNames())
+            {
+                if (std::find(specializedNames.begin(), specializedNames.end(), constantName) == specializedNames.end())
+                {
+                    std::cout << "Specialization constant " << constantName << " matches no uniform declaration of " << VertexShaderFilePath <<
+                        " + " << FragmentShaderFilePath << std::endl;
+                }
+            }
+        }
+
+        // 2. submit compilation & linkage
+        BuildRecord.VertexShaderFilePath = VertexShaderFilePath;
+        BuildRecord.FragmentShaderFilePath = FragmentShaderFilePath;
+        BuildRecord.VariantKey = MakeVariantKey();
+        BuildRecord.VertexSourceBytes = static_cast<std::size_t>(vertexShaderSourceCode.Length);
+        BuildRecord.FragmentSourceBytes = static_cast<std::size_t>(fragmentShaderSourceCode.Length);
+        BuildRecord.bFromSpirV = bFromSpirV;
+
+        BeginBuild(vertexShaderSourceCode, fragmentShaderSourceCode);
+    }
+
+    /*
+     * Issues compilation & linkage (or loads cached binary) without querying any status, which would stall until driver is done.
+     * Shader "source code" views hold SPIR-V modules instead of GLSL when bFromSpirV is set.
+     */
+    void BeginBuild(ShaderSourceView VertexShaderSourceCode, ShaderSourceView FragmentShaderSourceCode)
+    {
+        BuildStartTime = std::chrono::steady_clock::now();
+        bBuildPending = true;
+
+        // try to skip compilation altogether by loading previously linked program binary
+        ProgramID = glCreateProgram();
+        bUseBinaryCache = ProgramBinaryCache::IsAvailable();
+        // specialization of SPIR-V modules happens in the driver, so it isn't part of their bytes
+        BinaryCacheKey = bUseBinaryCache ? ProgramBinaryCache::ComputeKey(VertexShaderSourceCode.ToStringView(), FragmentShaderSourceCode.ToStringView(),
+            bFromSpirV ? Specialization.ComputeKey() : 0) : 0;
+        const std::chrono::steady_clock::time_point cacheLoadStartTime = std::chrono::steady_clock::now();
+        bLoadedFromCache = bUseBinaryCache && ProgramBinaryCache::TryLoad(ProgramID, BinaryCacheKey);
+        BuildRecord.CacheLoadMilliseconds = bUseBinaryCache ? ShaderBuildTelemetry::MillisecondsSince(cacheLoadStartTime) : 0.0;
+        if (bLoadedFromCache)
+        {
+            return;
+        }
+
+        if (bUseBinaryCache)
+        {
+            // program object is left in unspecified state by rejected binary, so start over with a fresh one
+            glDeleteProgram(ProgramID);
+            ProgramID = glCreateProgram();
+        }
+
+        std::chrono::steady_clock::time_point submitStartTime = std::chrono::steady_clock::now();
+        if (bFromSpirV)
+        {
+            std::vector<GLuint> constantIDs;
+            std::vector<GLuint> constantValues;
+            Specialization.GetSpirVConstants(constantIDs, constantValues);
+            PendingVertexShaderID = SpirVShaderLoader::CreateShader(GL_VERTEX_SHADER, VertexShaderSourceCode.ToStringView(), constantIDs, constantValues);
+            BuildRecord.VertexCompileMilliseconds = ShaderBuildTelemetry::MillisecondsSince(submitStartTime);
+
+            submitStartTime = std::chrono::steady_clock::now();
+            PendingFragmentShaderID = SpirVShaderLoader::CreateShader(GL_FRAGMENT_SHADER, FragmentShaderSourceCode.ToStringView(), constantIDs, constantValues);
+            BuildRecord.FragmentCompileMilliseconds = ShaderBuildTelemetry::MillisecondsSince(submitStartTime);
+        }
+        else
+        {
+            // vertex shader
+            PendingVertexShaderID = glCreateShader(GL_VERTEX_SHADER);
+            glShaderSource(PendingVertexShaderID, 1, &VertexShaderSourceCode.Data, &VertexShaderSourceCode.Length);
+            glCompileShader(PendingVertexShaderID);
+            BuildRecord.VertexCompileMilliseconds = ShaderBuildTelemetry::MillisecondsSince(submitStartTime);
+
+            // fragment Shader
+            submitStartTime = std::chrono::steady_clock::now();
+            PendingFragmentShaderID = glCreateShader(GL_FRAGMENT_SHADER);
+            glShaderSource(PendingFragmentShaderID, 1, &FragmentShaderSourceCode.Data, &FragmentShaderSourceCode.Length);
+            glCompileShader(PendingFragmentShaderID);
+            BuildRecord.FragmentCompileMilliseconds = ShaderBuildTelemetry::MillisecondsSince(submitStartTime);
+        }
+
+        // shader Program (linkage of not yet compiled shaders is fine, driver just chains the jobs)
+        glAttachShader(ProgramID, PendingVertexShaderID);
+        glAttachShader(ProgramID, PendingFragmentShaderID);
+        if (bUseBinaryCache)
+        {
+            GLExtensions::ProgramParameteri(ProgramID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+        submitStartTime = std::chrono::steady_clock::now();
+        glLinkProgram(ProgramID);
+        BuildRecord.LinkMilliseconds = ShaderBuildTelemetry::MillisecondsSince(submitStartTime);
+    }
+
+    // Defines & specialization constants of the program, e.g. "FLIP_SECOND_TEXTURE_X;blendingScale=0.2"
+    std::string MakeVariantKey() const
+    {
+        std::string variantKey;
+        for (const std::string& define : Defines)
+        {
+            variantKey += (variantKey.empty() ? "" : ";") + define;
+        }
+
+        const std::string constants = Specialization.ToString();
+        return variantKey.empty() || constants.empty() ? variantKey + constants : variantKey + ";" + constants;
+    }
+
+    // Expanded source with defines injected & specialization constants applied
+    std::string MakeVariantSourceCode(std::string_view SourceCode, std::vector<std::string>& OutSpecializedNames) const
+    {
+        std::string variantSourceCode = Defines.empty() ? std::string(SourceCode) : ShaderPreprocessor::InjectDefines(SourceCode, Defines);
+        return Specialization.IsEmpty() ? variantSourceCode : Specialization.SpecializeSource(variantSourceCode, OutSpecializedNames);
+    }
+
+    // Copies values of active uniforms of Source program into uniforms of the same name & type in Destination (binds Destination)
+    static void CopyUniformValues(unsigned int SourceProgramID, unsigned int DestinationProgramID)
+    {
+        GLint activeUniformsCount = 0;
+        GLint maxUniformNameLength = 0;
+        glGetProgramiv(SourceProgramID, GL_ACTIVE_UNIFORMS, &activeUniformsCount);
+        glGetProgramiv(SourceProgramID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxUniformNameLength);
+
+        glUseProgram(DestinationProgramID);
+
+        std::string uniformName(static_cast<std::size_t>(maxUniformNameLength > 0 ? maxUniformNameLength : 1), '\0');
+        for (GLint uniformIndex = 0; uniformIndex < activeUniformsCount; ++uniformIndex)
+        {
+            GLsizei uniformNameLength = 0;
+            GLint uniformArraySize = 0;
+            GLenum uniformType = 0;
+            glGetActiveUniform(SourceProgramID, uniformIndex, maxUniformNameLength, &uniformNameLength, &uniformArraySize, &uniformType, &uniformName[0]);
+
+            // arrays are copied element by element, as "name[0]", "name[1]" etc.
+            std::string elementName = uniformName.substr(0, uniformNameLength);
+            const std::string::size_type arraySubscriptPosition = elementName.rfind("[0]");
+            const std::string arrayBaseName = elementName.substr(0, arraySubscriptPosition);
+
+            for (GLint elementIndex = 0; elementIndex < uniformArraySize; ++elementIndex)
+            {
+                if (elementIndex > 0)
+                {
+                    elementName = arrayBaseName + "[" + std::to_string(elementIndex) + "]";
+                }
+
+                const GLint sourceLocation = glGetUniformLocation(SourceProgramID, elementName.c_str());
+                const GLint destinationLocation = glGetUniformLocation(DestinationProgramID, elementName.c_str());
+                if (sourceLocation >= 0 && destinationLocation >= 0)
+                {
+                    CopyUniformValue(SourceProgramID, sourceLocation, destinationLocation, uniformType);
+                }
+            }
+        }
+    }
+
+    static void CopyUniformValue(unsigned int SourceProgramID, GLint SourceLocation, GLint DestinationLocation, GLenum UniformType)
+    {
+        GLfloat floatValues[16];
+        GLint intValues[4];
+        GLuint unsignedValues[4];
+
+        switch (UniformType)
+        {
+            case GL_FLOAT: case GL_FLOAT_VEC2: case GL_FLOAT_VEC3: case GL_FLOAT_VEC4:
+            case GL_FLOAT_MAT2: case GL_FLOAT_MAT3: case GL_FLOAT_MAT4:
+            {
+                glGetUniformfv(SourceProgramID, SourceLocation, floatValues);
+                break;
+            }
+            case GL_UNSIGNED_INT: case GL_UNSIGNED_INT_VEC2: case GL_UNSIGNED_INT_VEC3: case GL_UNSIGNED_INT_VEC4:
+            {
+                glGetUniformuiv(SourceProgramID, SourceLocation, unsignedValues);
+                break;
+            }
+            default:
+            {
+                // ints, bools & samplers
+                glGetUniformiv(SourceProgramID, SourceLocation, intValues);
+                break;
+            }
+        }
+
+        switch (UniformType)
+        {
+            case GL_FLOAT: glUniform1fv(DestinationLocation, 1, floatValues); break;
+            case GL_FLOAT_VEC2: glUniform2fv(DestinationLocation, 1, floatValues); break;
+            case GL_FLOAT_VEC3: glUniform3fv(DestinationLocation, 1, floatValues); break;
+            case GL_FLOAT_VEC4: glUniform4fv(DestinationLocation, 1, floatValues); break;
+            case GL_FLOAT_MAT2: glUniformMatrix2fv(DestinationLocation, 1, GL_FALSE, floatValues); break;
+            case GL_FLOAT_MAT3: glUniformMatrix3fv(DestinationLocation, 1, GL_FALSE, floatValues); break;
+            case GL_FLOAT_MAT4: glUniformMatrix4fv(DestinationLocation, 1, GL_FALSE, floatValues); break;
+            case GL_UNSIGNED_INT: glUniform1uiv(DestinationLocation, 1, unsignedValues); break;
+            case GL_UNSIGNED_INT_VEC2: glUniform2uiv(DestinationLocation, 1, unsignedValues); break;
+            case GL_UNSIGNED_INT_VEC3: glUniform3uiv(DestinationLocation, 1, unsignedValues); break;
+            case GL_UNSIGNED_INT_VEC4: glUniform4uiv(DestinationLocation, 1, unsignedValues); break;
+            case GL_INT_VEC2: case GL_BOOL_VEC2: glUniform2iv(DestinationLocation, 1, intValues); break;
+            case GL_INT_VEC3: case GL_BOOL_VEC3: glUniform3iv(DestinationLocation, 1, intValues); break;
+            case GL_INT_VEC4: case GL_BOOL_VEC4: glUniform4iv(DestinationLocation, 1, intValues); break;
+            default: glUniform1iv(DestinationLocation, 1, intValues); break;
+        }
+    }
+
+    // Uploads Count values to the uniform at Location (values unused by the program, i.e. at location -1, are dropped right away)
+
+    void UploadUniform(GLint Location, GLsizei Count, const GLint* Values) const
+    {
+        if (Location < 0)
+        {
+            return;
+        }
+        if (GLExtensions::bHasProgramUniforms)
+        {
+            GLExtensions::ProgramUniform1iv(ProgramID, Location, Count, Values);
+            return;
+        }
+        GLStateCache::UseProgram(ProgramID);
+        glUniform1iv(Location, Count, Values);
+    }
+
+    void UploadUniform(GLint Location, GLsizei Count, const GLfloat* Values) const
+    {
+        if (Location < 0)
+        {
+            return;
+        }
+        if (GLExtensions::bHasProgramUniforms)
+        {
+            GLExtensions::ProgramUniform1fv(ProgramID, Location, Count, Values);
+            return;
+        }
+        GLStateCache::UseProgram(ProgramID);
+        glUniform1fv(Location, Count, Values);
+    }
+
+    void UploadUniform(GLint Location, GLsizei Count, const glm::vec2* Values) const
+    {
+        if (Location < 0)
+        {
+            return;
+        }
+        if (GLExtensions::bHasProgramUniforms)
+        {
+            GLExtensions::ProgramUniform2fv(ProgramID, Location, Count, glm::value_ptr(*Values));
+            return;
+        }
+        GLStateCache::UseProgram(ProgramID);
+        glUniform2fv(Location, Count, glm::value_ptr(*Values));
+    }
+
+    void UploadUniform(GLint Location, GLsizei Count, const glm::vec3* Values) const
+    {
+        if (Location < 0)
+        {
+            return;
+        }
+        if (GLExtensions::bHasProgramUniforms)
+        {
+            GLExtensions::ProgramUniform3fv(ProgramID, Location, Count, glm::value_ptr(*Values));
+            return;
+        }
+        GLStateCache::UseProgram(ProgramID);
+        glUniform3fv(Location, Count, glm::value_ptr(*Values));
+    }
+
+    void UploadUniform(GLint Location, GLsizei Count, const glm::vec4* Values) const
+    {
+        if (Location < 0)
+        {
+            return;
+        }
+        if (GLExtensions::bHasProgramUniforms)
+        {
+            GLExtensions::ProgramUniform4fv(ProgramID, Location, Count, glm::value_ptr(*Values));
+            return;
+        }
+        GLStateCache::UseProgram(ProgramID);
+        glUniform4fv(Location, Count, glm::value_ptr(*Values));
+    }
+
+    void UploadUniform(GLint Location, GLsizei Count, const glm::mat3* Values) const
+    {
+        if (Location < 0)
+        {
+            return;
+        }
+        if (GLExtensions::bHasProgramUniforms)
+        {
+            GLExtensions::ProgramUniformMatrix3fv(ProgramID, Location, Count, GL_FALSE, glm::value_ptr(*Values));
+            return;
+        }
+        GLStateCache::UseProgram(ProgramID);
+        glUniformMatrix3fv(Location, Count, GL_FALSE, glm::value_ptr(*Values));
+    }
+
+    void UploadUniform(GLint Location, GLsizei Count, const glm::mat4* Values) const
+    {
+        if (Location < 0)
+        {
+            return;
+        }
+        if (GLExtensions::bHasProgramUniforms)
+        {
+            GLExtensions::ProgramUniformMatrix4fv(ProgramID, Location, Count, GL_FALSE, glm::value_ptr(*Values));
+            return;
+        }
+        GLStateCache::UseProgram(ProgramID);
+        glUniformMatrix4fv(Location, Count, GL_FALSE, glm::value_ptr(*Values));
+    }
+
+    GLint FindUniformLocation(const std::string& UniformName) const
+    {
+        const GLint uniformLocation = UniformLocations.Find(UniformName);
+        ++FrameUniformLookupStats.StringLookups;
+        RecordUniformLookup(uniformLocation);
+        return uniformLocation;
+    }
+
+    GLint FindUniformLocation(UniformKey Key) const
+    {
+        const GLint uniformLocation = UniformLocations.Find(Key);
+        ++FrameUniformLookupStats.KeyLookups;
+        RecordUniformLookup(uniformLocation);
+        return uniformLocation;
+    }
+
+    static void RecordUniformLookup(GLint UniformLocation)
+    {
+        ++FrameUniformLookupStats.AvoidedDriverLookups;
+        if (UniformLocation < 0)
+        {
+            ++FrameUniformLookupStats.Misses;
+        }
+    }
+
+    // utility function for checking shader/shader program compilation/linking errors (respectively), returns true on success
     enum class EEntityType : unsigned int;
-    void CheckEntityCompilationErrors(unsigned int EntityID, EEntityType EntityType) const
+    bool CheckEntityCompilationErrors(unsigned int EntityID, EEntityType EntityType) const
     {
         int compiledSuccessfully;
         char compilationInfoLog[1024];
@@ -137,6 +782,8 @@ private:
                 break;
             }
         }
+
+        return compiledSuccessfully;
     }
 
     std::string EntityTypeToString(EEntityType EntityType) const
@@ -162,6 +809,27 @@ private:
 
 private:
     unsigned int ProgramID;
+    UniformLocationTable UniformLocations;
+
+    std::string VertexShaderFilePath;
+    std::string FragmentShaderFilePath;
+    std::vector<std::string> Defines;
+    ShaderSpecialization Specialization;
+
+    // build state, shader objects are kept alive only until FinishBuild queried their info logs
+    unsigned int PendingVertexShaderID = 0;
+    unsigned int PendingFragmentShaderID = 0;
+    bool bBuildPending = false;
+    bool bLinked = false;
+    bool bUseBinaryCache = false;
+    bool bLoadedFromCache = false;
+    bool bFromSpirV = false;
+    std::uint64_t BinaryCacheKey = 0;
+    std::chrono::steady_clock::time_point BuildStartTime;
+    ShaderBuildRecord BuildRecord;
+
+    inline static UniformLookupStats FrameUniformLookupStats;
+    inline static ShaderPreprocessor Preprocessor;
 
     enum class EEntityType: unsigned int
     {
@@ -0,0 +1,113 @@
+#ifndef SHADER_SOURCE_LOADER_H
+#define SHADER_SOURCE_LOADER_H
+
+#include <glad/glad.h>
+
+#include <string>
+#include <string_view>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+
+// Non-owning view of shader source code, which can be handed to glShaderSource as a pointer + length pair as is
+struct ShaderSourceView
+{
+    const char* Data = nullptr;
+    GLint Length = 0;
+
+    bool IsValid() const
+    {
+        return Data != nullptr;
+    }
+
+    std::string_view ToStringView() const
+    {
+        return std::string_view(Data != nullptr ? Data : "", static_cast<std::size_t>(Length));
+    }
+};
+
+/*
+ * Reads whole file with plain file descriptor calls: open, fstat, a single read straight into the destination & close,
+ * without any stdio/stream buffering. AllocateDestination(FileSize) must return a buffer of at least FileSize + 1 bytes;
+ * the source code is null-terminated as well, for code that still expects C strings.
+ */
+template <typename AllocatorType>
+bool ReadShaderSourceFile(const char* ShaderSourceFilePath, AllocatorType&& AllocateDestination, ShaderSourceView& OutSourceCode)
+{
+#ifdef _WIN32
+    const int sourceFile = _open(ShaderSourceFilePath, _O_RDONLY | _O_BINARY);
+    struct _stat64 sourceFileStatus;
+    const bool bOpened = sourceFile >= 0 && _fstat64(sourceFile, &sourceFileStatus) == 0;
+#else
+    const int sourceFile = open(ShaderSourceFilePath, O_RDONLY);
+    struct stat sourceFileStatus;
+    const bool bOpened = sourceFile >= 0 && fstat(sourceFile, &sourceFileStatus) == 0;
+#endif
+
+    std::size_t fileSize = 0;
+    std::size_t readBytesCount = 0;
+    char* destination = nullptr;
+    if (bOpened)
+    {
+        fileSize = static_cast<std::size_t>(sourceFileStatus.st_size);
+        destination = AllocateDestination(fileSize);
+
+        while (readBytesCount < fileSize)
+        {
+#ifdef _WIN32
+            const int readResult = _read(sourceFile, destination + readBytesCount, static_cast<unsigned int>(fileSize - readBytesCount));
+#else
+            const ssize_t readResult = read(sourceFile, destination + readBytesCount, fileSize - readBytesCount);
+#endif
+            if (readResult <= 0)
+            {
+                break;
+            }
+            readBytesCount += static_cast<std::size_t>(readResult);
+        }
+    }
+
+    if (sourceFile >= 0)
+    {
+#ifdef _WIN32
+        _close(sourceFile);
+#else
+        close(sourceFile);
+#endif
+    }
+
+    if (!bOpened || readBytesCount != fileSize)
+    {
+        return false;
+    }
+
+    destination[readBytesCount] = '\0';
+    OutSourceCode = { destination, static_cast<GLint>(readBytesCount) };
+    return true;
+}
+
+// Reads whole file into the given string (sized to the file exactly, so it's the only copy of the source code)
+inline bool ReadShaderSourceFile(const char* ShaderSourceFilePath, std::string& OutSourceCode)
+{
+    ShaderSourceView sourceCode;
+    const bool bRead = ReadShaderSourceFile(ShaderSourceFilePath, [&OutSourceCode](std::size_t FileSize)
+    {
+        OutSourceCode.resize(FileSize);
+        return &OutSourceCode[0];
+    }, sourceCode);
+
+    if (!bRead)
+    {
+        OutSourceCode.clear();
+    }
+    return bRead;
+}
+#endif
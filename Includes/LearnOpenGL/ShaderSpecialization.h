@@ -0,0 +1,281 @@
+#ifndef SHADER_SPECIALIZATION_H
+#define SHADER_SPECIALIZATION_H
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+
+
+/*
+ * Values known by the time a program is built, baked into its shaders as compile-time constants instead of being fetched
+ * from uniforms, so the compiler can fold them. GLSL shaders get their "uniform T Name;" declarations rewritten into
+ * "const T Name = Value;" (only plain declarations, without layout qualifiers), SPIR-V shaders get
+ * the values of specialization constants with the given constant_id.
+ */
+class ShaderSpecialization
+{
+public:
+    enum class EConstantType : unsigned int
+    {
+        Float,
+        Int,
+        UInt,
+        Bool
+    };
+
+    // ConstantID is the constant_id of the matching specialization constant in SPIR-V shaders (negative if there's none)
+    ShaderSpecialization& Set(const std::string& Name, float Value, int ConstantID = -1)
+    {
+        GLuint valueBits;
+        std::memcpy(&valueBits, &Value, sizeof(valueBits));
+        return Set(Name, EConstantType::Float, valueBits, ConstantID);
+    }
+
+    ShaderSpecialization& Set(const std::string& Name, int Value, int ConstantID = -1)
+    {
+        return Set(Name, EConstantType::Int, static_cast<GLuint>(Value), ConstantID);
+    }
+
+    ShaderSpecialization& Set(const std::string& Name, unsigned int Value, int ConstantID = -1)
+    {
+        return Set(Name, EConstantType::UInt, Value, ConstantID);
+    }
+
+    ShaderSpecialization& Set(const std::string& Name, bool Value, int ConstantID = -1)
+    {
+        return Set(Name, EConstantType::Bool, Value ? 1u : 0u, ConstantID);
+    }
+
+    bool IsEmpty() const
+    {
+        return Constants.empty();
+    }
+
+    // Identifies the set of values (constants are kept sorted by name, so the order they were set in doesn't matter)
+    std::uint64_t ComputeKey() const
+    {
+        // FNV-1a
+        std::uint64_t key = 14695981039346656037ull;
+        for (const char character : MakeKeyString())
+        {
+            key = (key ^ static_cast<unsigned char>(character)) * 1099511628211ull;
+        }
+        return key;
+    }
+
+    // Exact identity of the set of values (names, types, value bits & constant IDs), for keys that must not collide
+    std::string MakeKeyString() const
+    {
+        std::string keyString;
+        for (const Constant& constant : Constants)
+        {
+            keyString += constant.Name + ":" + std::to_string(static_cast<unsigned int>(constant.Type)) + ":" + std::to_string(constant.ValueBits) + ":" +
+                std::to_string(constant.ConstantID) + ";";
+        }
+        return keyString;
+    }
+
+    /*
+     * Copy of GLSL source with uniforms named like the constants turned into constants of the same type (same line count, so
+     * compiler messages still point to the right lines). OutSpecializedNames receives names of the constants actually applied.
+     */
+    std::string SpecializeSource(std::string_view SourceCode, std::vector<std::string>& OutSpecializedNames) const
+    {
+        std::string specializedSourceCode;
+        specializedSourceCode.reserve(SourceCode.size());
+
+        std::size_t copiedUntil = 0;
+        for (std::size_t uniformPosition = FindToken(SourceCode, "uniform", 0); uniformPosition != std::string_view::npos;
+            uniformPosition = FindToken(SourceCode, "uniform", uniformPosition + 1))
+        {
+            // "layout(...) uniform" can't become a constant as is (and the layout is there for a reason anyway)
+            const std::size_t previousCharacterPosition = uniformPosition == 0 ? std::string_view::npos :
+                SourceCode.find_last_not_of(" \t\r\n", uniformPosition - 1);
+            if (previousCharacterPosition != std::string_view::npos && SourceCode[previousCharacterPosition] == ')')
+            {
+                continue;
+            }
+
+            std::size_t position = uniformPosition + std::strlen("uniform");
+            const std::string_view typeName = ReadIdentifier(SourceCode, position);
+            const std::string_view uniformName = ReadIdentifier(SourceCode, position);
+            position = SourceCode.find_first_not_of(" \t", position);
+            if (typeName.empty() || uniformName.empty() || position == std::string_view::npos || SourceCode[position] != ';')
+            {
+                continue;
+            }
+
+            const Constant* constant = Find(uniformName);
+            if (constant == nullptr || typeName != TypeToString(constant->Type))
+            {
+                continue;
+            }
+
+            specializedSourceCode.append(SourceCode.substr(copiedUntil, uniformPosition - copiedUntil));
+            specializedSourceCode += "const " + std::string(typeName) + " " + std::string(uniformName) + " = " + ValueToString(*constant);
+            copiedUntil = position;
+            OutSpecializedNames.push_back(constant->Name);
+        }
+
+        specializedSourceCode.append(SourceCode.substr(copiedUntil));
+        return specializedSourceCode;
+    }
+
+    // Constant IDs & values to pass to glSpecializeShader
+    void GetSpirVConstants(std::vector<GLuint>& OutConstantIDs, std::vector<GLuint>& OutConstantValues) const
+    {
+        for (const Constant& constant : Constants)
+        {
+            if (constant.ConstantID >= 0)
+            {
+                OutConstantIDs.push_back(static_cast<GLuint>(constant.ConstantID));
+                OutConstantValues.push_back(constant.ValueBits);
+            }
+        }
+    }
+
+    // Human readable "name=value" list, e.g. for logs
+    std::string ToString() const
+    {
+        std::string description;
+        for (const Constant& constant : Constants)
+        {
+            description += (description.empty() ? "" : ";") + constant.Name + "=" + ValueToString(constant);
+        }
+        return description;
+    }
+
+    std::vector<std::string> GetNames() const
+    {
+        std::vector<std::string> names;
+        for (const Constant& constant : Constants)
+        {
+            names.push_back(constant.Name);
+        }
+        return names;
+    }
+
+private:
+    struct Constant
+    {
+        std::string Name;
+        EConstantType Type;
+        GLuint ValueBits;
+        int ConstantID;
+    };
+
+    ShaderSpecialization& Set(const std::string& Name, EConstantType Type, GLuint ValueBits, int ConstantID)
+    {
+        const auto constant = std::lower_bound(Constants.begin(), Constants.end(), Name, [](const Constant& Existing, const std::string& NewName)
+        {
+            return Existing.Name < NewName;
+        });
+
+        if (constant != Constants.end() && constant->Name == Name)
+        {
+            *constant = { Name, Type, ValueBits, ConstantID };
+        }
+        else
+        {
+            Constants.insert(constant, { Name, Type, ValueBits, ConstantID });
+        }
+        return *this;
+    }
+
+    const Constant* Find(std::string_view Name) const
+    {
+        for (const Constant& constant : Constants)
+        {
+            if (constant.Name == Name)
+            {
+                return &constant;
+            }
+        }
+        return nullptr;
+    }
+
+    static bool IsIdentifierCharacter(char Character)
+    {
+        return (Character >= 'a' && Character <= 'z') || (Character >= 'A' && Character <= 'Z') || (Character >= '0' && Character <= '9') || Character == '_';
+    }
+
+    // Position of the whole word Token at or after StartPosition
+    static std::size_t FindToken(std::string_view SourceCode, std::string_view Token, std::size_t StartPosition)
+    {
+        for (std::size_t position = SourceCode.find(Token, StartPosition); position != std::string_view::npos; position = SourceCode.find(Token, position + 1))
+        {
+            const bool bStartsWord = position == 0 || !IsIdentifierCharacter(SourceCode[position - 1]);
+            const bool bEndsWord = position + Token.size() == SourceCode.size() || !IsIdentifierCharacter(SourceCode[position + Token.size()]);
+            if (bStartsWord && bEndsWord)
+            {
+                return position;
+            }
+        }
+        return std::string_view::npos;
+    }
+
+    // Skips blanks, then reads an identifier (empty if there's none), advancing InOutPosition past it
+    static std::string_view ReadIdentifier(std::string_view SourceCode, std::size_t& InOutPosition)
+    {
+        const std::size_t identifierStart = SourceCode.find_first_not_of(" \t", InOutPosition);
+        std::size_t identifierEnd = identifierStart;
+        while (identifierEnd < SourceCode.size() && IsIdentifierCharacter(SourceCode[identifierEnd]))
+        {
+            ++identifierEnd;
+        }
+
+        if (identifierStart == std::string_view::npos || identifierEnd == identifierStart)
+        {
+            return {};
+        }
+
+        InOutPosition = identifierEnd;
+        return SourceCode.substr(identifierStart, identifierEnd - identifierStart);
+    }
+
+    static const char* TypeToString(EConstantType Type)
+    {
+        switch (Type)
+        {
+            case EConstantType::Float: return "float";
+            case EConstantType::Int: return "int";
+            case EConstantType::UInt: return "uint";
+            default: return "bool";
+        }
+    }
+
+    static std::string ValueToString(const Constant& SpecializedConstant)
+    {
+        switch (SpecializedConstant.Type)
+        {
+            case EConstantType::Float:
+            {
+                float value;
+                std::memcpy(&value, &SpecializedConstant.ValueBits, sizeof(value));
+
+                // enough digits to round-trip, and always a float literal
+                char valueString[32];
+                std::snprintf(valueString, sizeof(valueString), "%.9g", value);
+                std::string literal = valueString;
+                if (literal.find_first_of(".eEn") == std::string::npos)
+                {
+                    literal += ".0";
+                }
+                return literal;
+            }
+            case EConstantType::Int: return std::to_string(static_cast<int>(SpecializedConstant.ValueBits));
+            case EConstantType::UInt: return std::to_string(SpecializedConstant.ValueBits) + "u";
+            default: return SpecializedConstant.ValueBits != 0 ? "true" : "false";
+        }
+    }
+
+private:
+    std::vector<Constant> Constants;
+};
+#endif
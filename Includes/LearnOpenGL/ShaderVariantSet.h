@@ -0,0 +1,146 @@
+#ifndef SHADER_VARIANT_SET_H
+#define SHADER_VARIANT_SET_H
+
+#include "LearnOpenGL/ShaderProgram.h"
+
+#include <map>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <utility>
+#include <iostream>
+#include <initializer_list>
+
+
+/*
+ * Permutations of a single vertex + fragment shader pair, toggled by a fixed list of define keys (up to 64). A variant is
+ * identified by the bitmask of its enabled keys (bit N = N-th key), and is only compiled the first time it's requested, so
+ * unused permutations cost nothing. Variants are built deferred and cached for the lifetime of the set.
+ * Each variant can additionally be specialized (see ShaderSpecialization): by the set's default constants, or by the ones
+ * passed to GetVariant. Every distinct set of values is cached as a program of its own, so only values from a small, fixed
+ * set are worth specializing; anything adjusted continuously should stay a uniform.
+ */
+class ShaderVariantSet
+{
+public:
+    ShaderVariantSet(const char* VertexShaderSourceFilePath, const char* FragmentShaderSourceFilePath, std::vector<std::string> VariantDefineKeys,
+        ShaderSpecialization DefaultConstants = ShaderSpecialization())
+        : VertexShaderFilePath(VertexShaderSourceFilePath), FragmentShaderFilePath(FragmentShaderSourceFilePath), DefineKeys(std::move(VariantDefineKeys)),
+        DefaultSpecialization(std::move(DefaultConstants))
+    {
+        if (DefineKeys.size() > MAX_DEFINE_KEYS_COUNT)
+        {
+            std::cout << "Shader variant set supports up to " << MAX_DEFINE_KEYS_COUNT << " define keys, extra ones are ignored." << std::endl;
+            DefineKeys.resize(MAX_DEFINE_KEYS_COUNT);
+        }
+    }
+
+    ShaderVariantSet(const ShaderVariantSet&) = delete;
+    ShaderVariantSet& operator=(const ShaderVariantSet&) = delete;
+
+    // Deletes GL programs of all compiled variants (not done by a destructor, as the set usually outlives the GL context)
+    void DeleteVariants()
+    {
+        for (auto& variant : Variants)
+        {
+            variant.second->DeleteProgram();
+        }
+        Variants.clear();
+    }
+
+    // Bitmask of the given define keys; unknown keys are reported & ignored
+    std::uint64_t MakeVariantKey(std::initializer_list<const char*> EnabledDefineKeys) const
+    {
+        std::uint64_t variantKey = 0;
+        for (const char* enabledDefineKey : EnabledDefineKeys)
+        {
+            bool bFound = false;
+            for (std::size_t keyIndex = 0; keyIndex < DefineKeys.size(); ++keyIndex)
+            {
+                if (DefineKeys[keyIndex] == enabledDefineKey)
+                {
+                    variantKey |= std::uint64_t(1) << keyIndex;
+                    bFound = true;
+                    break;
+                }
+            }
+
+            if (!bFound)
+            {
+                std::cout << "Unknown shader variant define key: " << enabledDefineKey << std::endl;
+            }
+        }
+
+        return variantKey;
+    }
+
+    // Variant with the given keys enabled, compiled on first request (its build is finished by UseProgram or FinishBuild)
+    ShaderProgram& GetVariant(std::uint64_t VariantKey)
+    {
+        return GetVariant(VariantKey, DefaultSpecialization);
+    }
+
+    // Same as above, specialized by the given constants instead of the default ones (every distinct set of values is a program of its own)
+    ShaderProgram& GetVariant(std::uint64_t VariantKey, const ShaderSpecialization& Constants)
+    {
+        std::unique_ptr<ShaderProgram>& variant = Variants[MakeProgramKey(VariantKey, Constants)];
+        if (variant == nullptr)
+        {
+            variant = std::make_unique<ShaderProgram>(VertexShaderFilePath.c_str(), FragmentShaderFilePath.c_str(), MakeDefines(VariantKey),
+                Constants, ShaderProgram::EBuildMode::Deferred);
+        }
+
+        return *variant;
+    }
+
+    ShaderProgram& GetVariant(std::initializer_list<const char*> EnabledDefineKeys)
+    {
+        return GetVariant(MakeVariantKey(EnabledDefineKeys));
+    }
+
+    // Submits builds of the given variants up front, so the driver can compile them in parallel before they're first used
+    void Prewarm(std::initializer_list<std::uint64_t> VariantKeys)
+    {
+        for (const std::uint64_t variantKey : VariantKeys)
+        {
+            GetVariant(variantKey);
+        }
+    }
+
+    std::size_t GetCompiledVariantsCount() const
+    {
+        return Variants.size();
+    }
+
+private:
+    static constexpr std::size_t MAX_DEFINE_KEYS_COUNT = 64;
+
+    // Variant key paired with the exact specialization, so distinct programs can't share a key
+    static std::pair<std::uint64_t, std::string> MakeProgramKey(std::uint64_t VariantKey, const ShaderSpecialization& Constants)
+    {
+        return { VariantKey, Constants.MakeKeyString() };
+    }
+
+    std::vector<std::string> MakeDefines(std::uint64_t VariantKey) const
+    {
+        std::vector<std::string> defines;
+        for (std::size_t keyIndex = 0; keyIndex < DefineKeys.size(); ++keyIndex)
+        {
+            if ((VariantKey & (std::uint64_t(1) << keyIndex)) != 0)
+            {
+                defines.push_back(DefineKeys[keyIndex]);
+            }
+        }
+
+        return defines;
+    }
+
+private:
+    std::string VertexShaderFilePath;
+    std::string FragmentShaderFilePath;
+    std::vector<std::string> DefineKeys;
+    ShaderSpecialization DefaultSpecialization;
+    std::map<std::pair<std::uint64_t, std::string>, std::unique_ptr<ShaderProgram>> Variants;
+};
+#endif
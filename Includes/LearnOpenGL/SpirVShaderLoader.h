@@ -0,0 +1,262 @@
+#ifndef SPIRV_SHADER_LOADER_H
+#define SPIRV_SHADER_LOADER_H
+
+#include <glad/glad.h>
+
+#include "LearnOpenGL/GLExtensions.h"
+#include "LearnOpenGL/ShaderSourceLoader.h"
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+
+
+/*
+ * Precompiled SPIR-V shaders (ARB_gl_spirv), baked offline by SpirVBaker into "<shader source file>.spv" next to the
+ * source. A binary is only used while it's up to date, i.e. not older than any file the expanded source is made of;
+ * otherwise (or without ARB_gl_spirv) shaders are compiled from GLSL as usual.
+ * SPIR-V modules don't have to carry uniform names for the driver to reflect, so it's opt-in: a program is only loaded from
+ * binaries if both of its stages declare explicit locations / bindings for all of their uniforms & uniform blocks
+ * (layout(location = N) / layout(binding = N)). #version 330 shaders can declare them behind GL_ARB_explicit_uniform_location
+ * (see 4.1.Shader.fs), which every SPIR-V capable driver has. If a linked SPIR-V program still has names the driver can't resolve,
+ * ShaderProgram reports it and builds the program from GLSL instead.
+ */
+class SpirVShaderLoader
+{
+public:
+    static void SetEnabled(bool bNewEnabled)
+    {
+        bEnabled = bNewEnabled;
+    }
+
+    static bool IsAvailable()
+    {
+        return bEnabled && GLExtensions::bHasSpirV;
+    }
+
+    static std::string GetBinaryFilePath(const std::string& ShaderSourceFilePath)
+    {
+        return ShaderSourceFilePath + ".spv";
+    }
+
+    // Reads the baked binary of the shader if there's one newer than all of the given source files (root file & its includes)
+    static bool LoadUpToDateBinary(const std::string& ShaderSourceFilePath, const std::vector<std::string>& SourceFilePaths, std::string& OutBinary)
+    {
+        const std::string binaryFilePath = GetBinaryFilePath(ShaderSourceFilePath);
+
+        std::error_code errorCode;
+        const std::filesystem::file_time_type binaryWriteTime = std::filesystem::last_write_time(binaryFilePath, errorCode);
+        if (errorCode)
+        {
+            return false;
+        }
+
+        for (const std::string& sourceFilePath : SourceFilePaths)
+        {
+            const std::filesystem::file_time_type sourceWriteTime = std::filesystem::last_write_time(sourceFilePath, errorCode);
+            if (errorCode || sourceWriteTime > binaryWriteTime)
+            {
+                return false;
+            }
+        }
+
+        if (!ReadShaderSourceFile(binaryFilePath.c_str(), OutBinary) || !IsSpirVModule(OutBinary))
+        {
+            std::cout << "Ignoring invalid SPIR-V binary " << binaryFilePath << std::endl;
+            OutBinary.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    /*
+     * Creates shader object from the SPIR-V module & specializes its "main" entry point with the given constants (the ones
+     * the module doesn't declare are skipped, so both stages can be given the same set). Like glCompileShader, success is
+     * reported by GL_COMPILE_STATUS of the returned shader.
+     */
+    static GLuint CreateShader(GLenum ShaderType, std::string_view Binary, const std::vector<GLuint>& ConstantIDs = {},
+        const std::vector<GLuint>& ConstantValues = {})
+    {
+        // glSpecializeShader fails on IDs of constants the module doesn't have
+        const std::vector<GLuint> declaredConstantIDs = ConstantIDs.empty() ? std::vector<GLuint>() : FindSpecializationConstantIDs(Binary);
+        std::vector<GLuint> usedConstantIDs;
+        std::vector<GLuint> usedConstantValues;
+        for (std::size_t constantIndex = 0; constantIndex < ConstantIDs.size() && constantIndex < ConstantValues.size(); ++constantIndex)
+        {
+            if (std::find(declaredConstantIDs.begin(), declaredConstantIDs.end(), ConstantIDs[constantIndex]) != declaredConstantIDs.end())
+            {
+                usedConstantIDs.push_back(ConstantIDs[constantIndex]);
+                usedConstantValues.push_back(ConstantValues[constantIndex]);
+            }
+        }
+
+        const GLuint shaderID = glCreateShader(ShaderType);
+        GLExtensions::ShaderBinary(1, &shaderID, GL_SHADER_BINARY_FORMAT_SPIR_V_ARB, Binary.data(), static_cast<GLsizei>(Binary.size()));
+        GLExtensions::SpecializeShader(shaderID, "main", static_cast<GLuint>(usedConstantIDs.size()), usedConstantIDs.data(), usedConstantValues.data());
+        return shaderID;
+    }
+
+    /*
+     * Whether every uniform & uniform block declaration of the (expanded GLSL) source has an explicit location or binding,
+     * i.e. the shader doesn't rely on the driver finding its uniforms by name. Comments & preprocessor lines are skipped.
+     */
+    static bool DeclaresExplicitUniformLayouts(std::string_view SourceCode)
+    {
+        std::string statement;
+        std::size_t position = 0;
+        while (position < SourceCode.size())
+        {
+            const char character = SourceCode[position];
+            if (SourceCode.compare(position, 2, "//") == 0 || (character == '#' && statement.find_first_not_of(" \t\r\n") == std::string::npos))
+            {
+                position = SourceCode.find('\n', position);
+                continue;
+            }
+            if (SourceCode.compare(position, 2, "/*") == 0)
+            {
+                position = SourceCode.find("*/", position + 2);
+                position = position == std::string_view::npos ? position : position + 2;
+                statement += ' ';
+                continue;
+            }
+
+            ++position;
+            if (character != ';' && character != '{' && character != '}')
+            {
+                statement += character;
+                continue;
+            }
+
+            if (ContainsWord(statement, "uniform") &&
+                !(ContainsWord(statement, "layout") && (ContainsWord(statement, "location") || ContainsWord(statement, "binding"))))
+            {
+                return false;
+            }
+            statement.clear();
+        }
+
+        return true;
+    }
+
+    // Number of the linked program's active uniforms & uniform blocks, which can't be found by name (unnamed ones in SPIR-V programs)
+    static int CountUnresolvedNames(GLuint ProgramID)
+    {
+        int unresolvedNamesCount = 0;
+
+        GLint activeUniformsCount = 0;
+        GLint maxUniformNameLength = 0;
+        glGetProgramiv(ProgramID, GL_ACTIVE_UNIFORMS, &activeUniformsCount);
+        glGetProgramiv(ProgramID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxUniformNameLength);
+
+        std::string uniformName(static_cast<std::size_t>(maxUniformNameLength > 0 ? maxUniformNameLength : 1), '\0');
+        for (GLint uniformIndex = 0; uniformIndex < activeUniformsCount; ++uniformIndex)
+        {
+            GLsizei uniformNameLength = 0;
+            GLint uniformArraySize = 0;
+            GLenum uniformType = 0;
+            glGetActiveUniform(ProgramID, uniformIndex, maxUniformNameLength, &uniformNameLength, &uniformArraySize, &uniformType, &uniformName[0]);
+
+            // uniform block members have no location of their own, their block is checked below
+            const GLuint activeUniformIndex = static_cast<GLuint>(uniformIndex);
+            GLint blockIndex = -1;
+            glGetActiveUniformsiv(ProgramID, 1, &activeUniformIndex, GL_UNIFORM_BLOCK_INDEX, &blockIndex);
+            if (blockIndex < 0 && (uniformNameLength == 0 || glGetUniformLocation(ProgramID, uniformName.substr(0, uniformNameLength).c_str()) < 0))
+            {
+                ++unresolvedNamesCount;
+            }
+        }
+
+        GLint activeBlocksCount = 0;
+        GLint maxBlockNameLength = 0;
+        glGetProgramiv(ProgramID, GL_ACTIVE_UNIFORM_BLOCKS, &activeBlocksCount);
+        glGetProgramiv(ProgramID, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxBlockNameLength);
+
+        std::string blockName(static_cast<std::size_t>(maxBlockNameLength > 0 ? maxBlockNameLength : 1), '\0');
+        for (GLint blockIndex = 0; blockIndex < activeBlocksCount; ++blockIndex)
+        {
+            GLsizei blockNameLength = 0;
+            glGetActiveUniformBlockName(ProgramID, blockIndex, maxBlockNameLength, &blockNameLength, &blockName[0]);
+            if (blockNameLength == 0 || glGetUniformBlockIndex(ProgramID, blockName.substr(0, blockNameLength).c_str()) == GL_INVALID_INDEX)
+            {
+                ++unresolvedNamesCount;
+            }
+        }
+
+        return unresolvedNamesCount;
+    }
+
+private:
+    static bool ContainsWord(const std::string& Text, std::string_view Word)
+    {
+        for (std::size_t position = Text.find(Word); position != std::string::npos; position = Text.find(Word, position + 1))
+        {
+            const auto isIdentifierCharacter = [](char Character) { return std::isalnum(static_cast<unsigned char>(Character)) || Character == '_'; };
+            if ((position == 0 || !isIdentifierCharacter(Text[position - 1])) &&
+                (position + Word.size() == Text.size() || !isIdentifierCharacter(Text[position + Word.size()])))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // constant_id values of the module's specialization constants (literals of its "OpDecorate <id> SpecId <constant_id>" instructions)
+    static std::vector<GLuint> FindSpecializationConstantIDs(std::string_view Binary)
+    {
+        constexpr std::uint32_t OP_DECORATE = 71;
+        constexpr std::uint32_t DECORATION_SPEC_ID = 1;
+        constexpr std::size_t HEADER_WORDS_COUNT = 5;
+
+        std::vector<GLuint> constantIDs;
+        const std::size_t wordsCount = Binary.size() / sizeof(std::uint32_t);
+        std::size_t wordIndex = HEADER_WORDS_COUNT;
+        while (wordIndex < wordsCount)
+        {
+            std::uint32_t instruction[4] = {};
+            std::memcpy(instruction, Binary.data() + wordIndex * sizeof(std::uint32_t), sizeof(std::uint32_t));
+
+            // first word holds the instruction's word count in its high half & the opcode in its low half
+            const std::uint32_t instructionWordsCount = instruction[0] >> 16;
+            if (instructionWordsCount == 0 || wordIndex + instructionWordsCount > wordsCount)
+            {
+                break;
+            }
+
+            if ((instruction[0] & 0xFFFF) == OP_DECORATE && instructionWordsCount == 4)
+            {
+                std::memcpy(instruction, Binary.data() + wordIndex * sizeof(std::uint32_t), sizeof(instruction));
+                if (instruction[2] == DECORATION_SPEC_ID)
+                {
+                    constantIDs.push_back(instruction[3]);
+                }
+            }
+            wordIndex += instructionWordsCount;
+        }
+
+        return constantIDs;
+    }
+
+    static bool IsSpirVModule(const std::string& Binary)
+    {
+        constexpr std::uint32_t SPIRV_MAGIC_NUMBER = 0x07230203;
+
+        std::uint32_t magicNumber = 0;
+        if (Binary.size() < 5 * sizeof(std::uint32_t) || Binary.size() % sizeof(std::uint32_t) != 0)
+        {
+            return false;
+        }
+        std::memcpy(&magicNumber, Binary.data(), sizeof(magicNumber));
+        return magicNumber == SPIRV_MAGIC_NUMBER;
+    }
+
+private:
+    inline static bool bEnabled = true;
+};
+#endif
@@ -0,0 +1,501 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <glad/glad.h>
+
+#include "LearnOpenGL/GLExtensions.h"
+#include "LearnOpenGL/GLStateCache.h"
+#include "LearnOpenGL/ImageArena.h"
+#include "LearnOpenGL/TextureLoadOptions.h"
+#include "LearnOpenGL/BakedTextureLoader.h"
+#include "LearnOpenGL/MipChainGenerator.h"
+#include "LearnOpenGL/BlockCompressor.h"
+#include "LearnOpenGL/ParallelJpegDecoder.h"
+#include "Images/stb_image.h"
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <memory>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+#include <unordered_map>
+
+
+struct TextureCacheStats
+{
+    unsigned int Hits = 0;
+    unsigned int Misses = 0;
+    unsigned int ResidentTextures = 0;
+    // estimated GPU memory of all resident textures, mip chains included
+    std::size_t ResidentBytes = 0;
+};
+
+// 2D texture shared through TextureCache; its GL texture is deleted once the last handle to it is gone
+class CachedTexture
+{
+public:
+    CachedTexture() = default;
+    CachedTexture(const CachedTexture&) = delete;
+    CachedTexture& operator=(const CachedTexture&) = delete;
+    ~CachedTexture();
+
+    // 0 if the image failed to load
+    GLuint GetID() const
+    {
+        return TextureID;
+    }
+
+    int GetWidth() const
+    {
+        return Width;
+    }
+
+    int GetHeight() const
+    {
+        return Height;
+    }
+
+    int GetChannels() const
+    {
+        return Channels;
+    }
+
+    std::size_t GetSizeInBytes() const
+    {
+        return SizeInBytes;
+    }
+
+    // Whether the texture still holds a placeholder, while its image is being streamed in (see TextureStreamer)
+    bool IsStreaming() const
+    {
+        return bStreaming;
+    }
+
+private:
+    friend class TextureCache;
+    friend class TextureStreamer;
+
+    GLuint TextureID = 0;
+    int Width = 0;
+    int Height = 0;
+    int Channels = 0;
+    std::size_t SizeInBytes = 0;
+    bool bStreaming = false;
+    std::string CacheKey;
+};
+
+using TextureHandle = std::shared_ptr<const CachedTexture>;
+
+/*
+ * Decodes & uploads every image file once, no matter how many times (or by how many scenes) it's loaded: textures are
+ * keyed by canonical file path plus load options, and handed out as shared handles. GPU memory is freed when the last
+ * handle is released. Up to date baked files (see BakedTextureLoader) are uploaded as they are, instead of decoding the image.
+ * Where buffer storage is supported, images that need no work on the CPU after decoding are decoded straight into a pixel buffer
+ * (kept in client memory, so decoders can read back what they wrote at system memory speed) & uploaded from there.
+ * Textures are created with repeat wrapping & linear filtering, and have mipmaps generated (optionally block compressed, see
+ * SetBlockCompression); as they're shared, sampling state that differs between users belongs into sampler objects rather than texture parameters.
+ * Call DeleteAll before the GL context goes away, handles still alive afterwards are left without GL texture.
+ */
+class TextureCache
+{
+public:
+    static TextureHandle Load(const std::string& FilePath, const TextureLoadOptions& Options = TextureLoadOptions())
+    {
+        const std::string cacheKey = MakeCacheKey(FilePath, Options);
+        TextureHandle residentTexture = FindResident(cacheKey);
+        if (residentTexture != nullptr)
+        {
+            return residentTexture;
+        }
+
+        BakedTextureFile bakedTexture;
+        if (BakedTextureLoader::OpenUpToDate(FilePath, Options, bakedTexture))
+        {
+            return LoadBaked(bakedTexture, cacheKey);
+        }
+
+        std::shared_ptr<CachedTexture> texture = std::make_shared<CachedTexture>();
+
+        stbi_set_flip_vertically_on_load(Options.bFlipVertically);
+        // images uploaded as they are skip the copy out of stb_image's buffer, the ones the CPU still has to work on don't gain from it
+        if (GLExtensions::bHasBufferStorage && !bCpuMipmapGeneration && !bBlockCompression && LoadThroughPixelBuffer(FilePath, Options, *texture))
+        {
+            AddResident(texture, cacheKey);
+            return texture;
+        }
+
+        // everything stb_image allocates is gone once the pixels are uploaded, so it all comes from (and goes back to) the thread's arena
+        ImageArena::Scope arenaScope;
+        int width = 0;
+        int height = 0;
+        int fileChannels = 0;
+        unsigned char* pixels = ParallelJpegDecoder::Load(FilePath, &width, &height, &fileChannels, Options.DesiredChannels);
+        if (pixels == nullptr)
+        {
+            // failures aren't cached, so a fixed file gets picked up by the next load
+            std::cout << "Failed to load texture " << FilePath << std::endl;
+            return texture;
+        }
+
+        texture->Width = width;
+        texture->Height = height;
+        texture->Channels = Options.DesiredChannels != 0 ? Options.DesiredChannels : fileChannels;
+        texture->TextureID = CreateTexture();
+        texture->SizeInBytes = UploadPixels(pixels, width, height, texture->Channels, Options.bSRGB);
+        stbi_image_free(pixels);
+
+        AddResident(texture, cacheKey);
+        return texture;
+    }
+
+    static TextureCacheStats GetStats()
+    {
+        return Stats;
+    }
+
+    // Mipmaps of decoded images get generated by MipChainGenerator (same on every driver, optionally with a sharper filter) instead of glGenerateMipmap
+    static void SetCpuMipmapGeneration(bool bNewEnabled, EMipFilter NewFilter = EMipFilter::Box)
+    {
+        bCpuMipmapGeneration = bNewEnabled;
+        CpuMipmapFilter = NewFilter;
+    }
+
+    /*
+     * Decoded images get compressed into the BCn format BlockCompressor::ChooseFormat picks for them, where the driver supports
+     * it, taking 4 to 8 times less GPU memory at the cost of encoding time on load; their mipmaps are generated on the CPU
+     * (with the SetCpuMipmapGeneration filter), as drivers don't generate them for compressed textures. Baked files are uploaded as they are.
+     */
+    static void SetBlockCompression(bool bNewEnabled, EBlockCompressionQuality NewQuality = EBlockCompressionQuality::Normal)
+    {
+        bBlockCompression = bNewEnabled;
+        BlockCompressionQuality = NewQuality;
+    }
+
+    // Deletes GL textures of all resident textures right away (not left to the handles, as they usually outlive the GL context)
+    static void DeleteAll()
+    {
+        for (auto& cachedTexture : Textures)
+        {
+            const std::shared_ptr<CachedTexture> texture = std::const_pointer_cast<CachedTexture>(cachedTexture.second.lock());
+            if (texture != nullptr)
+            {
+                Release(*texture);
+            }
+        }
+        Textures.clear();
+
+        DeleteDecodePixelBuffer();
+    }
+
+private:
+    friend class CachedTexture;
+    friend class TextureStreamer;
+
+    // Resident texture loaded under the given key (counted as a hit), or null (counted as a miss)
+    static TextureHandle FindResident(const std::string& CacheKey)
+    {
+        const auto cachedTexture = Textures.find(CacheKey);
+        TextureHandle texture = cachedTexture != Textures.end() ? cachedTexture->second.lock() : nullptr;
+        ++(texture != nullptr ? Stats.Hits : Stats.Misses);
+        return texture;
+    }
+
+    static void AddResident(const std::shared_ptr<CachedTexture>& Texture, const std::string& CacheKey)
+    {
+        Texture->CacheKey = CacheKey;
+        ++Stats.ResidentTextures;
+        Stats.ResidentBytes += Texture->SizeInBytes;
+        Textures[CacheKey] = Texture;
+    }
+
+    static void ResizeResident(CachedTexture& Texture, std::size_t NewSizeInBytes)
+    {
+        Stats.ResidentBytes = Stats.ResidentBytes - Texture.SizeInBytes + NewSizeInBytes;
+        Texture.SizeInBytes = NewSizeInBytes;
+    }
+
+    /*
+     * Reads the image header, decodes the image straight into a mapped pixel buffer of its size, and uploads it into a new texture
+     * from there, so peak memory of the load is the image plus the texture and nothing gets copied on the CPU (unless the decoder
+     * didn't write its final image into the buffer after all, which costs one copy). False if any of it failed, the image then goes
+     * through the regular path (which reports failed decodes).
+     */
+    static bool LoadThroughPixelBuffer(const std::string& FilePath, const TextureLoadOptions& Options, CachedTexture& Texture)
+    {
+        // the header is read from the arena too, the decode then gets the buffer for its image on top
+        ImageArena::Scope arenaScope;
+        int width = 0;
+        int height = 0;
+        int fileChannels = 0;
+        if (!stbi_info(FilePath.c_str(), &width, &height, &fileChannels))
+        {
+            return false;
+        }
+        const int channels = Options.DesiredChannels != 0 ? Options.DesiredChannels : fileChannels;
+        const std::size_t imageSize = static_cast<std::size_t>(width) * height * channels;
+
+        unsigned char* mappedMemory = MapDecodePixelBuffer(imageSize + DECODE_BUFFER_SLACK);
+        if (mappedMemory == nullptr)
+        {
+            std::cout << "Failed to map pixel buffer for texture " << FilePath << std::endl;
+            return false;
+        }
+
+        bool bDecoded = false;
+        {
+            ImageArena::Scope outputScope(mappedMemory, imageSize, imageSize + DECODE_BUFFER_SLACK);
+            int decodedWidth = 0;
+            int decodedHeight = 0;
+            unsigned char* pixels = ParallelJpegDecoder::Load(FilePath, &decodedWidth, &decodedHeight, &fileChannels, Options.DesiredChannels);
+            bDecoded = pixels != nullptr && decodedWidth == width && decodedHeight == height;
+            if (bDecoded && pixels != mappedMemory)
+            {
+                std::memcpy(mappedMemory, pixels, imageSize);
+            }
+            stbi_image_free(pixels);
+        }
+        // buffer contents may get lost while mapped (e.g. to a display mode change)
+        const bool bUnmapped = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+        if (!bDecoded || !bUnmapped)
+        {
+            GLStateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return false;
+        }
+
+        GLenum pixelFormat;
+        GLenum internalFormat;
+        GetUploadFormats(channels, Options.bSRGB, pixelFormat, internalFormat);
+
+        Texture.Width = width;
+        Texture.Height = height;
+        Texture.Channels = channels;
+        Texture.TextureID = CreateTexture();
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, pixelFormat, GL_UNSIGNED_BYTE, nullptr);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        GLStateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        Texture.SizeInBytes = ComputeMipChainSize(width, height, channels);
+        return true;
+    }
+
+    /*
+     * Binds the decode pixel buffer (recreated when smaller than Size) & maps its first Size bytes for reading & writing, as decoders
+     * read back what they wrote (PNG filters, zlib back-references, vertical flip). Its storage is immutable & asks for client memory,
+     * so those reads don't hit uncached, write-combined memory. Mapping waits for the driver to finish reading the previous upload.
+     * Null (with nothing bound) if the buffer couldn't be mapped.
+     */
+    static unsigned char* MapDecodePixelBuffer(std::size_t Size)
+    {
+        if (DecodePixelBufferSize < Size)
+        {
+            DeleteDecodePixelBuffer();
+            glGenBuffers(1, &DecodePixelBufferID);
+            GLStateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, DecodePixelBufferID);
+            GLExtensions::BufferStorage(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(Size), nullptr,
+                GL_CLIENT_STORAGE_BIT | GL_MAP_READ_BIT | GL_MAP_WRITE_BIT);
+            DecodePixelBufferSize = Size;
+        }
+
+        GLStateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, DecodePixelBufferID);
+        unsigned char* mappedMemory = static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(Size),
+            GL_MAP_READ_BIT | GL_MAP_WRITE_BIT));
+        if (mappedMemory == nullptr)
+        {
+            GLStateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+
+        return mappedMemory;
+    }
+
+    static void DeleteDecodePixelBuffer()
+    {
+        if (DecodePixelBufferID != 0)
+        {
+            glDeleteBuffers(1, &DecodePixelBufferID);
+            GLStateCache::OnBufferDeleted(DecodePixelBufferID);
+            DecodePixelBufferID = 0;
+            DecodePixelBufferSize = 0;
+        }
+    }
+
+    static TextureHandle LoadBaked(const BakedTextureFile& BakedTexture, const std::string& CacheKey)
+    {
+        std::shared_ptr<CachedTexture> texture = std::make_shared<CachedTexture>();
+        texture->Width = BakedTexture.GetWidth();
+        texture->Height = BakedTexture.GetHeight();
+        texture->Channels = BakedTexture.GetChannels();
+        texture->SizeInBytes = BakedTexture.GetSizeInBytes();
+        texture->TextureID = CreateTexture();
+        BakedTexture.Upload();
+
+        AddResident(texture, CacheKey);
+        return texture;
+    }
+
+    static std::string MakeCacheKey(const std::string& FilePath, const TextureLoadOptions& Options)
+    {
+        std::error_code errorCode;
+        std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(FilePath, errorCode);
+        if (errorCode)
+        {
+            canonicalPath = std::filesystem::path(FilePath).lexically_normal();
+        }
+
+        return canonicalPath.string() + "|" + (Options.bFlipVertically ? "flip" : "") + "|" + std::to_string(Options.DesiredChannels) + "|" +
+            (Options.bSRGB ? "srgb" : "");
+    }
+
+    static std::size_t ComputeMipChainSize(int Width, int Height, int Channels)
+    {
+        std::size_t mipChainSize = 0;
+        while (true)
+        {
+            mipChainSize += static_cast<std::size_t>(Width) * Height * Channels;
+            if (Width == 1 && Height == 1)
+            {
+                return mipChainSize;
+            }
+            Width = std::max(Width / 2, 1);
+            Height = std::max(Height / 2, 1);
+        }
+    }
+
+    // Creates texture with the default sampling state, left bound to unit 0
+    static GLuint CreateTexture()
+    {
+        GLuint textureID = 0;
+        glGenTextures(1, &textureID);
+        GLStateCache::BindTexture(0, GL_TEXTURE_2D, textureID);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        return textureID;
+    }
+
+    static void GetUploadFormats(int Channels, bool bSRGB, GLenum& OutPixelFormat, GLenum& OutInternalFormat)
+    {
+        switch (Channels)
+        {
+            case 1: OutPixelFormat = GL_RED; OutInternalFormat = GL_R8; break;
+            case 2: OutPixelFormat = GL_RG; OutInternalFormat = GL_RG8; break;
+            case 3: OutPixelFormat = GL_RGB; OutInternalFormat = bSRGB ? GL_SRGB8 : GL_RGB8; break;
+            default: OutPixelFormat = GL_RGBA; OutInternalFormat = bSRGB ? GL_SRGB8_ALPHA8 : GL_RGBA8; break;
+        }
+    }
+
+    // Options to block compress an image with; false if the driver doesn't support the format it needs
+    static bool GetBlockCompressionOptions(int Channels, bool bSRGB, EBlockCompressionQuality Quality, BlockCompressionOptions& OutOptions)
+    {
+        OutOptions.Format = BlockCompressor::ChooseFormat(Channels, GLExtensions::bHasTextureCompressionBPTC);
+        OutOptions.Quality = Quality;
+        return BlockCompressor::IsSupported(OutOptions.Format, bSRGB && Channels >= 3);
+    }
+
+    static MipGenerationOptions GetMipGenerationOptions(bool bSRGB)
+    {
+        MipGenerationOptions mipOptions;
+        mipOptions.Filter = CpuMipmapFilter;
+        mipOptions.bSRGB = bSRGB;
+        mipOptions.bPremultipliedAlpha = true;
+        return mipOptions;
+    }
+
+    // Uploads the levels (level 0 first) compressed into the format into the bound texture; returns their total size
+    static std::size_t UploadCompressedLevels(const std::vector<MipLevel>& CompressedLevels, EBlockFormat Format, bool bSRGB)
+    {
+        const GLenum internalFormat = BlockCompressor::GetInternalFormat(Format, bSRGB);
+        std::size_t sizeInBytes = 0;
+        for (std::size_t levelIndex = 0; levelIndex < CompressedLevels.size(); ++levelIndex)
+        {
+            const MipLevel& level = CompressedLevels[levelIndex];
+            glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(levelIndex), internalFormat, level.Width, level.Height, 0,
+                static_cast<GLsizei>(level.Pixels.size()), level.Pixels.data());
+            sizeInBytes += level.Pixels.size();
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(CompressedLevels.size()) - 1);
+        return sizeInBytes;
+    }
+
+    // (Re)allocates the bound texture & fills it with the pixels, mipmaps included; returns the GPU memory it takes
+    static std::size_t UploadPixels(const unsigned char* Pixels, int Width, int Height, int Channels, bool bSRGB)
+    {
+        BlockCompressionOptions compressionOptions;
+        if (bBlockCompression && GetBlockCompressionOptions(Channels, bSRGB, BlockCompressionQuality, compressionOptions))
+        {
+            const std::vector<MipLevel> mipLevels = MipChainGenerator::Generate(Pixels, Width, Height, Channels, GetMipGenerationOptions(bSRGB));
+            return UploadCompressedLevels(BlockCompressor::CompressMipChain(Pixels, Width, Height, Channels, mipLevels, compressionOptions), compressionOptions.Format,
+                bSRGB && Channels >= 3);
+        }
+
+        GLenum pixelFormat;
+        GLenum internalFormat;
+        GetUploadFormats(Channels, bSRGB, pixelFormat, internalFormat);
+
+        // rows of decoded images are tightly packed, which the default 4 byte alignment only covers for some widths
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, Width, Height, 0, pixelFormat, GL_UNSIGNED_BYTE, Pixels);
+        if (!bCpuMipmapGeneration)
+        {
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glGenerateMipmap(GL_TEXTURE_2D);
+            return ComputeMipChainSize(Width, Height, Channels);
+        }
+
+        const std::vector<MipLevel> mipLevels = MipChainGenerator::Generate(Pixels, Width, Height, Channels, GetMipGenerationOptions(bSRGB));
+        for (std::size_t levelIndex = 0; levelIndex < mipLevels.size(); ++levelIndex)
+        {
+            const MipLevel& mipLevel = mipLevels[levelIndex];
+            glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(levelIndex + 1), internalFormat, mipLevel.Width, mipLevel.Height, 0, pixelFormat, GL_UNSIGNED_BYTE,
+                mipLevel.Pixels.data());
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(mipLevels.size()));
+        return ComputeMipChainSize(Width, Height, Channels);
+    }
+
+    static void Release(CachedTexture& Texture)
+    {
+        if (Texture.TextureID == 0)
+        {
+            return;
+        }
+
+        glDeleteTextures(1, &Texture.TextureID);
+        GLStateCache::OnTextureDeleted(Texture.TextureID);
+        Texture.TextureID = 0;
+
+        --Stats.ResidentTextures;
+        Stats.ResidentBytes -= Texture.SizeInBytes;
+
+        // the entry may belong to a newer texture already, if this one was deleted by DeleteAll & the file loaded again
+        const auto cachedTexture = Textures.find(Texture.CacheKey);
+        if (cachedTexture != Textures.end() && cachedTexture->second.expired())
+        {
+            Textures.erase(cachedTexture);
+        }
+    }
+
+private:
+    // decoders may allocate a few bytes past the image (see ImageArena::Scope)
+    static constexpr std::size_t DECODE_BUFFER_SLACK = 16;
+
+    inline static std::unordered_map<std::string, std::weak_ptr<const CachedTexture>> Textures;
+    inline static TextureCacheStats Stats;
+    inline static bool bCpuMipmapGeneration = false;
+    inline static EMipFilter CpuMipmapFilter = EMipFilter::Box;
+    inline static bool bBlockCompression = false;
+    inline static EBlockCompressionQuality BlockCompressionQuality = EBlockCompressionQuality::Normal;
+    // images get decoded into it by Load, when they're uploaded as they are
+    inline static GLuint DecodePixelBufferID = 0;
+    inline static std::size_t DecodePixelBufferSize = 0;
+};
+
+inline CachedTexture::~CachedTexture()
+{
+    TextureCache::Release(*this);
+}
+#endif
@@ -0,0 +1,14 @@
+#ifndef TEXTURE_LOAD_OPTIONS_H
+#define TEXTURE_LOAD_OPTIONS_H
+
+
+// How an image file is turned into a texture; textures loaded with different options are cached (and baked) separately
+struct TextureLoadOptions
+{
+    bool bFlipVertically = false;
+    // channels the image is converted to on load (0 keeps the ones of the file)
+    int DesiredChannels = 0;
+    // color data is stored in sRGB & converted to linear when sampled
+    bool bSRGB = false;
+};
+#endif
@@ -0,0 +1,598 @@
+#ifndef TEXTURE_STREAMER_H
+#define TEXTURE_STREAMER_H
+
+#include <glad/glad.h>
+
+#include "LearnOpenGL/GLExtensions.h"
+#include "LearnOpenGL/GLStateCache.h"
+#include "LearnOpenGL/TextureCache.h"
+#include "LearnOpenGL/MipChainGenerator.h"
+#include "LearnOpenGL/BlockCompressor.h"
+#include "Images/stb_image.h"
+
+#include <cstring>
+#include <string>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <iostream>
+#include <iterator>
+#include <algorithm>
+#include <condition_variable>
+
+
+/*
+ * Loads textures without blocking the GL thread: Load hands out a texture right away, holding a 1x1 grey placeholder, and
+ * queues the image file for a pool of worker threads to decode. Update (meant to be called once per frame) copies decoded
+ * images into pixel buffer objects and uploads them into their textures from there, so the driver can pull the data without
+ * stalling; a fenced PBO is reused only once the GPU is done with it, which also bounds the uploads done per frame. Texture IDs
+ * never change, so textures can be bound before their image lands (IsStreaming tells whether it did); a texture whose
+ * image fails to load ends up without GL texture, like with TextureCache::Load.
+ * Textures are shared with TextureCache, i.e. loading a resident file (by either of the two) doesn't decode it again.
+ * Images with an up to date baked file (see BakedTextureLoader) have nothing to decode, so they're uploaded by Load right away.
+ * With TextureCache's CPU mipmap generation enabled, mip chains are generated by the workers as well, and uploaded along with the image;
+ * the same goes for TextureCache's block compression, which the workers do too.
+ * Where immutable texture storage is supported, images uploaded as they are get their storage allocated by Load already (sized
+ * from the image header), showing the placeholder through the base level until they land, and their decoded image is uploaded
+ * in row bands, a band per free pixel buffer, so a large image is spread over several frames instead of stalling one.
+ * Call Shutdown before the GL context goes away.
+ */
+class TextureStreamer
+{
+public:
+    // WorkersCount of 0 picks one based on the number of CPU cores (leaving one for the GL thread)
+    explicit TextureStreamer(unsigned int WorkersCount = 0)
+    {
+        if (WorkersCount == 0)
+        {
+            const unsigned int coresCount = std::thread::hardware_concurrency();
+            WorkersCount = std::clamp(coresCount > 1 ? coresCount - 1 : 1u, 1u, MAX_AUTO_WORKERS_COUNT);
+        }
+
+        for (unsigned int workerIndex = 0; workerIndex < WorkersCount; ++workerIndex)
+        {
+            Workers.emplace_back(&TextureStreamer::RunWorker, this);
+        }
+    }
+
+    ~TextureStreamer()
+    {
+        StopWorkers();
+        for (DecodedImage& decodedImage : DecodedImages)
+        {
+            stbi_image_free(decodedImage.Pixels);
+        }
+    }
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // Needs the GL context, as the placeholder texture is created right away
+    TextureHandle Load(const std::string& FilePath, const TextureLoadOptions& Options = TextureLoadOptions())
+    {
+        const std::string cacheKey = TextureCache::MakeCacheKey(FilePath, Options);
+        TextureHandle residentTexture = TextureCache::FindResident(cacheKey);
+        if (residentTexture != nullptr)
+        {
+            return residentTexture;
+        }
+
+        BakedTextureFile bakedTexture;
+        if (BakedTextureLoader::OpenUpToDate(FilePath, Options, bakedTexture))
+        {
+            return TextureCache::LoadBaked(bakedTexture, cacheKey);
+        }
+
+        std::shared_ptr<CachedTexture> texture = std::make_shared<CachedTexture>();
+        texture->bStreaming = true;
+        texture->TextureID = TextureCache::CreateTexture();
+        const bool bStorageAllocated = !TextureCache::bCpuMipmapGeneration && !TextureCache::bBlockCompression && AllocateStorage(FilePath, Options, *texture);
+        if (!bStorageAllocated)
+        {
+            const unsigned char placeholderPixel[4] = { PLACEHOLDER_VALUE, PLACEHOLDER_VALUE, PLACEHOLDER_VALUE, 255 };
+            texture->Width = 1;
+            texture->Height = 1;
+            texture->Channels = 4;
+            texture->SizeInBytes = TextureCache::UploadPixels(placeholderPixel, 1, 1, 4, false);
+        }
+        TextureCache::AddResident(texture, cacheKey);
+
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            DecodeJobs.push_back({ FilePath, Options, texture, TextureCache::bCpuMipmapGeneration, TextureCache::CpuMipmapFilter, TextureCache::bBlockCompression,
+                TextureCache::BlockCompressionQuality, bStorageAllocated });
+            ++PendingTexturesCount;
+        }
+        WorkAvailable.notify_one();
+
+        return texture;
+    }
+
+    // Uploads images decoded since the last call (as many as there are free pixel buffers) & retires finished uploads; returns number of textures that landed
+    unsigned int Update()
+    {
+        unsigned int landedTexturesCount = 0;
+        for (PixelBuffer& pixelBuffer : PixelBuffers)
+        {
+            if (pixelBuffer.Fence != nullptr && IsSignaled(pixelBuffer.Fence))
+            {
+                glDeleteSync(pixelBuffer.Fence);
+                pixelBuffer.Fence = nullptr;
+                if (pixelBuffer.bFinishesTexture)
+                {
+                    landedTexturesCount += FinishStreaming(pixelBuffer.Texture) ? 1 : 0;
+                }
+                pixelBuffer.Texture.reset();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            DecodedImages.insert(DecodedImages.end(), std::make_move_iterator(FinishedImages.begin()), std::make_move_iterator(FinishedImages.end()));
+            FinishedImages.clear();
+        }
+
+        auto decodedImage = DecodedImages.begin();
+        for (PixelBuffer& pixelBuffer : PixelBuffers)
+        {
+            if (pixelBuffer.Fence != nullptr)
+            {
+                continue;
+            }
+
+            // skip images nobody waits for anymore, and failed ones, without taking the buffer
+            EUploadResult uploadResult = EUploadResult::Dropped;
+            while (decodedImage != DecodedImages.end() && (uploadResult = Upload(*decodedImage, pixelBuffer)) == EUploadResult::Dropped)
+            {
+                landedTexturesCount += FinishStreaming(decodedImage->Texture) ? 1 : 0;
+                stbi_image_free(decodedImage->Pixels);
+                ++decodedImage;
+            }
+
+            // the buffer couldn't be mapped, so the image (and the ones after it) wait for the next frame
+            if (decodedImage == DecodedImages.end() || uploadResult == EUploadResult::Retry)
+            {
+                break;
+            }
+            // image uploaded in bands stays in front until its last band is out
+            if (!decodedImage->bStorageAllocated || decodedImage->UploadedRowsCount == decodedImage->Height)
+            {
+                stbi_image_free(decodedImage->Pixels);
+                ++decodedImage;
+            }
+        }
+        DecodedImages.erase(DecodedImages.begin(), decodedImage);
+
+        return landedTexturesCount;
+    }
+
+    // Number of textures still waiting to be decoded or uploaded
+    unsigned int GetPendingTexturesCount() const
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        return PendingTexturesCount;
+    }
+
+    // Stops the workers & deletes pixel buffers and fences (not done by the destructor, as the streamer usually outlives the GL context)
+    void Shutdown()
+    {
+        StopWorkers();
+        for (PixelBuffer& pixelBuffer : PixelBuffers)
+        {
+            if (pixelBuffer.Fence != nullptr)
+            {
+                glDeleteSync(pixelBuffer.Fence);
+                pixelBuffer.Fence = nullptr;
+            }
+            if (pixelBuffer.BufferID != 0)
+            {
+                glDeleteBuffers(1, &pixelBuffer.BufferID);
+                GLStateCache::OnBufferDeleted(pixelBuffer.BufferID);
+                pixelBuffer.BufferID = 0;
+            }
+        }
+    }
+
+private:
+    static constexpr unsigned int MAX_AUTO_WORKERS_COUNT = 4;
+    static constexpr std::size_t PIXEL_BUFFERS_COUNT = 4;
+    // rows of an image uploaded in bands go out in bands of about this size, one per free pixel buffer
+    static constexpr std::size_t UPLOAD_BAND_SIZE = 1 << 20;
+    static constexpr unsigned char PLACEHOLDER_VALUE = 128;
+
+    enum class EUploadResult : unsigned int
+    {
+        // upload is on its way through the pixel buffer
+        Started,
+        // texture is gone, or its image failed to load; nothing left to upload
+        Dropped,
+        // pixel buffer couldn't be mapped, the image is to be uploaded again later
+        Retry
+    };
+
+    struct DecodeJob
+    {
+        std::string FilePath;
+        TextureLoadOptions Options;
+        std::weak_ptr<CachedTexture> Texture;
+        bool bCpuMipmapGeneration;
+        EMipFilter CpuMipmapFilter;
+        bool bBlockCompression;
+        EBlockCompressionQuality BlockCompressionQuality;
+        bool bStorageAllocated;
+    };
+
+    // Pixels are null if the image failed to decode (or got compressed already)
+    struct DecodedImage
+    {
+        std::string FilePath;
+        TextureLoadOptions Options;
+        std::weak_ptr<CachedTexture> Texture;
+        unsigned char* Pixels = nullptr;
+        int Width = 0;
+        int Height = 0;
+        int Channels = 0;
+        // levels 1 and smaller, empty if the driver generates them
+        std::vector<MipLevel> MipLevels;
+        // all the levels (level 0 first) compressed into BlockFormat, taking the place of Pixels & MipLevels; empty if uploaded uncompressed
+        std::vector<MipLevel> CompressedLevels;
+        EBlockFormat BlockFormat = EBlockFormat::BC1;
+        // texture got its immutable storage from Load, the image goes into it in row bands
+        bool bStorageAllocated = false;
+        int UploadedRowsCount = 0;
+    };
+
+    struct PixelBuffer
+    {
+        GLuint BufferID = 0;
+        // signaled once the GPU has consumed the upload sourced from the buffer
+        GLsync Fence = nullptr;
+        std::weak_ptr<CachedTexture> Texture;
+        // whether the upload is the last one of its texture (which lands with the fence), rather than one of its bands
+        bool bFinishesTexture = false;
+    };
+
+    void RunWorker()
+    {
+        while (true)
+        {
+            DecodeJob decodeJob;
+            {
+                std::unique_lock<std::mutex> lock(Mutex);
+                WorkAvailable.wait(lock, [this]() { return bStopping || !DecodeJobs.empty(); });
+                if (bStopping)
+                {
+                    return;
+                }
+                decodeJob = std::move(DecodeJobs.front());
+                DecodeJobs.pop_front();
+            }
+
+            DecodedImage decodedImage;
+            decodedImage.FilePath = decodeJob.FilePath;
+            decodedImage.Options = decodeJob.Options;
+            decodedImage.Texture = decodeJob.Texture;
+            decodedImage.bStorageAllocated = decodeJob.bStorageAllocated;
+            // texture dropped while queued is not worth decoding
+            if (!decodeJob.Texture.expired())
+            {
+                stbi_set_flip_vertically_on_load_thread(decodeJob.Options.bFlipVertically);
+                int fileChannels = 0;
+                decodedImage.Pixels = stbi_load(decodeJob.FilePath.c_str(), &decodedImage.Width, &decodedImage.Height, &fileChannels,
+                    decodeJob.Options.DesiredChannels);
+                decodedImage.Channels = decodeJob.Options.DesiredChannels != 0 ? decodeJob.Options.DesiredChannels : fileChannels;
+
+                BlockCompressionOptions compressionOptions;
+                const bool bBlockCompressed = decodedImage.Pixels != nullptr && decodeJob.bBlockCompression &&
+                    TextureCache::GetBlockCompressionOptions(decodedImage.Channels, decodeJob.Options.bSRGB, decodeJob.BlockCompressionQuality, compressionOptions);
+
+                // drivers don't generate mipmaps of compressed textures
+                if (decodedImage.Pixels != nullptr && (decodeJob.bCpuMipmapGeneration || bBlockCompressed))
+                {
+                    MipGenerationOptions mipOptions;
+                    mipOptions.Filter = decodeJob.CpuMipmapFilter;
+                    mipOptions.bSRGB = decodeJob.Options.bSRGB;
+                    mipOptions.bPremultipliedAlpha = true;
+                    // other workers are busy with their own images
+                    mipOptions.ThreadsCount = 1;
+                    decodedImage.MipLevels = MipChainGenerator::Generate(decodedImage.Pixels, decodedImage.Width, decodedImage.Height, decodedImage.Channels,
+                        mipOptions);
+                }
+
+                if (bBlockCompressed)
+                {
+                    compressionOptions.ThreadsCount = 1;
+                    decodedImage.CompressedLevels = BlockCompressor::CompressMipChain(decodedImage.Pixels, decodedImage.Width, decodedImage.Height,
+                        decodedImage.Channels, decodedImage.MipLevels, compressionOptions);
+                    decodedImage.BlockFormat = compressionOptions.Format;
+                    decodedImage.MipLevels.clear();
+                    stbi_image_free(decodedImage.Pixels);
+                    decodedImage.Pixels = nullptr;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(Mutex);
+            FinishedImages.push_back(std::move(decodedImage));
+        }
+    }
+
+    void StopWorkers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            bStopping = true;
+        }
+        WorkAvailable.notify_all();
+
+        for (std::thread& worker : Workers)
+        {
+            worker.join();
+        }
+        Workers.clear();
+
+        // whatever the workers didn't get to is left unfinished
+        for (DecodedImage& finishedImage : FinishedImages)
+        {
+            stbi_image_free(finishedImage.Pixels);
+        }
+        FinishedImages.clear();
+        DecodeJobs.clear();
+    }
+
+    /*
+     * Gives the bound texture immutable storage for the image, sized from its header, with the placeholder in its smallest level,
+     * which is made the base level until the image lands; false if immutable storage isn't supported or the header can't be read.
+     */
+    static bool AllocateStorage(const std::string& FilePath, const TextureLoadOptions& Options, CachedTexture& Texture)
+    {
+        int width = 0;
+        int height = 0;
+        int fileChannels = 0;
+        if (!GLExtensions::bHasTextureStorage || !stbi_info(FilePath.c_str(), &width, &height, &fileChannels))
+        {
+            return false;
+        }
+        const int channels = Options.DesiredChannels != 0 ? Options.DesiredChannels : fileChannels;
+
+        GLenum pixelFormat;
+        GLenum internalFormat;
+        TextureCache::GetUploadFormats(channels, Options.bSRGB, pixelFormat, internalFormat);
+        int levelsCount = 1;
+        while ((std::max(width, height) >> levelsCount) > 0)
+        {
+            ++levelsCount;
+        }
+        GLExtensions::TexStorage2D(GL_TEXTURE_2D, levelsCount, internalFormat, width, height);
+
+        const unsigned char placeholderPixel[4] = { PLACEHOLDER_VALUE, PLACEHOLDER_VALUE, PLACEHOLDER_VALUE, 255 };
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, levelsCount - 1, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, placeholderPixel);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, levelsCount - 1);
+
+        Texture.Width = width;
+        Texture.Height = height;
+        Texture.Channels = channels;
+        Texture.SizeInBytes = TextureCache::ComputeMipChainSize(width, height, channels);
+        return true;
+    }
+
+    // Orphans the free pixel buffer at the given size & maps it for writing, left bound; null if mapping failed
+    static unsigned char* MapPixelBuffer(PixelBuffer& FreePixelBuffer, std::size_t Size, const std::string& FilePath)
+    {
+        if (FreePixelBuffer.BufferID == 0)
+        {
+            glGenBuffers(1, &FreePixelBuffer.BufferID);
+        }
+
+        // orphaning the buffer gives us fresh storage even if the driver still reads the previous upload
+        GLStateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, FreePixelBuffer.BufferID);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(Size), nullptr, GL_STREAM_DRAW);
+        unsigned char* mappedMemory = static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(Size),
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+        if (mappedMemory == nullptr)
+        {
+            GLStateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            std::cout << "Failed to map pixel buffer for texture " << FilePath << std::endl;
+        }
+        return mappedMemory;
+    }
+
+    // Starts upload of the next band of the image into its immutable storage through the free pixel buffer
+    static EUploadResult UploadBand(DecodedImage& Image, CachedTexture& Texture, PixelBuffer& FreePixelBuffer)
+    {
+        const std::size_t rowSize = static_cast<std::size_t>(Image.Width) * Image.Channels;
+        const int bandRowsCount = std::min(Image.Height - Image.UploadedRowsCount, std::max(static_cast<int>(UPLOAD_BAND_SIZE / rowSize), 1));
+        unsigned char* mappedMemory = MapPixelBuffer(FreePixelBuffer, rowSize * bandRowsCount, Image.FilePath);
+        if (mappedMemory == nullptr)
+        {
+            return EUploadResult::Retry;
+        }
+        std::memcpy(mappedMemory, Image.Pixels + rowSize * Image.UploadedRowsCount, rowSize * bandRowsCount);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        GLenum pixelFormat;
+        GLenum internalFormat;
+        TextureCache::GetUploadFormats(Image.Channels, Image.Options.bSRGB, pixelFormat, internalFormat);
+        GLStateCache::BindTexture(0, GL_TEXTURE_2D, Texture.TextureID);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, Image.UploadedRowsCount, Image.Width, bandRowsCount, pixelFormat, GL_UNSIGNED_BYTE, nullptr);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        GLStateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        Image.UploadedRowsCount += bandRowsCount;
+
+        FreePixelBuffer.bFinishesTexture = Image.UploadedRowsCount == Image.Height;
+        if (FreePixelBuffer.bFinishesTexture)
+        {
+            // the whole image is in, so the texture can leave the placeholder level
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+        FreePixelBuffer.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        FreePixelBuffer.Texture = Image.Texture;
+        return EUploadResult::Started;
+    }
+
+    // Starts upload of the image (or its next band) into its texture through the free pixel buffer
+    EUploadResult Upload(DecodedImage& Image, PixelBuffer& FreePixelBuffer)
+    {
+        const std::shared_ptr<CachedTexture> texture = Image.Texture.lock();
+        // texture of a live handle may still lose its GL texture to TextureCache::DeleteAll
+        if (texture == nullptr || texture->TextureID == 0)
+        {
+            return EUploadResult::Dropped;
+        }
+
+        // storage allocated from the header doesn't fit a file that changed before it got decoded
+        const bool bFitsStorage = !Image.bStorageAllocated || (Image.Width == texture->Width && Image.Height == texture->Height && Image.Channels == texture->Channels);
+        if ((Image.Pixels == nullptr && Image.CompressedLevels.empty()) || !bFitsStorage)
+        {
+            // same as with TextureCache::Load, failed texture is left without GL texture & isn't cached, so a fixed file gets picked up by the next load
+            std::cout << "Failed to load texture " << Image.FilePath << std::endl;
+            const auto cachedTexture = TextureCache::Textures.find(texture->CacheKey);
+            if (cachedTexture != TextureCache::Textures.end() && cachedTexture->second.lock() == texture)
+            {
+                TextureCache::Textures.erase(cachedTexture);
+            }
+            TextureCache::Release(*texture);
+            return EUploadResult::Dropped;
+        }
+
+        if (Image.bStorageAllocated)
+        {
+            return UploadBand(Image, *texture, FreePixelBuffer);
+        }
+
+        // all the levels go into the buffer back to back
+        struct LevelUpload
+        {
+            const unsigned char* Pixels;
+            int Width;
+            int Height;
+            std::size_t Size;
+            std::size_t BufferOffset;
+        };
+        std::vector<LevelUpload> levelUploads;
+        std::size_t uploadSize = 0;
+        if (Image.CompressedLevels.empty())
+        {
+            uploadSize = static_cast<std::size_t>(Image.Width) * Image.Height * Image.Channels;
+            levelUploads.push_back({ Image.Pixels, Image.Width, Image.Height, uploadSize, 0 });
+        }
+        for (const MipLevel& level : Image.CompressedLevels.empty() ? Image.MipLevels : Image.CompressedLevels)
+        {
+            levelUploads.push_back({ level.Pixels.data(), level.Width, level.Height, level.Pixels.size(), uploadSize });
+            uploadSize += level.Pixels.size();
+        }
+
+        unsigned char* mappedMemory = MapPixelBuffer(FreePixelBuffer, uploadSize, Image.FilePath);
+        if (mappedMemory == nullptr)
+        {
+            return EUploadResult::Retry;
+        }
+        for (const LevelUpload& levelUpload : levelUploads)
+        {
+            std::memcpy(mappedMemory + levelUpload.BufferOffset, levelUpload.Pixels, levelUpload.Size);
+        }
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        GLStateCache::BindTexture(0, GL_TEXTURE_2D, texture->TextureID);
+        if (!Image.CompressedLevels.empty())
+        {
+            // compressed levels come straight from the pixel buffer, their size is known up front
+            const GLenum internalFormat = BlockCompressor::GetInternalFormat(Image.BlockFormat, Image.Options.bSRGB && Image.Channels >= 3);
+            GLStateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, FreePixelBuffer.BufferID);
+            for (std::size_t levelIndex = 0; levelIndex < levelUploads.size(); ++levelIndex)
+            {
+                const LevelUpload& levelUpload = levelUploads[levelIndex];
+                glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(levelIndex), internalFormat, levelUpload.Width, levelUpload.Height, 0,
+                    static_cast<GLsizei>(levelUpload.Size), reinterpret_cast<const void*>(levelUpload.BufferOffset));
+            }
+            GLStateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levelUploads.size()) - 1);
+        }
+        else
+        {
+            GLenum pixelFormat;
+            GLenum internalFormat;
+            TextureCache::GetUploadFormats(Image.Channels, Image.Options.bSRGB, pixelFormat, internalFormat);
+
+            // storage is (re)allocated at the final size with no data, then filled from the pixel buffer
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            for (std::size_t levelIndex = 0; levelIndex < levelUploads.size(); ++levelIndex)
+            {
+                const LevelUpload& levelUpload = levelUploads[levelIndex];
+                GLStateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(levelIndex), internalFormat, levelUpload.Width, levelUpload.Height, 0, pixelFormat, GL_UNSIGNED_BYTE,
+                    nullptr);
+                GLStateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, FreePixelBuffer.BufferID);
+                glTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(levelIndex), 0, 0, levelUpload.Width, levelUpload.Height, pixelFormat, GL_UNSIGNED_BYTE,
+                    reinterpret_cast<const void*>(levelUpload.BufferOffset));
+            }
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            GLStateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+            if (Image.MipLevels.empty())
+            {
+                glGenerateMipmap(GL_TEXTURE_2D);
+            }
+            else
+            {
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(Image.MipLevels.size()));
+            }
+        }
+
+        FreePixelBuffer.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        FreePixelBuffer.Texture = texture;
+        FreePixelBuffer.bFinishesTexture = true;
+
+        texture->Width = Image.Width;
+        texture->Height = Image.Height;
+        texture->Channels = Image.Channels;
+        TextureCache::ResizeResident(*texture, Image.CompressedLevels.empty() ? TextureCache::ComputeMipChainSize(Image.Width, Image.Height, Image.Channels) :
+            uploadSize);
+        return EUploadResult::Started;
+    }
+
+    // Marks the texture as landed; false if it was gone already
+    bool FinishStreaming(const std::weak_ptr<CachedTexture>& StreamedTexture)
+    {
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            --PendingTexturesCount;
+        }
+
+        const std::shared_ptr<CachedTexture> texture = StreamedTexture.lock();
+        if (texture == nullptr)
+        {
+            return false;
+        }
+        texture->bStreaming = false;
+        return true;
+    }
+
+    static bool IsSignaled(GLsync Fence)
+    {
+        // flush, so the fence gets to the GPU (and eventually signals) even if nothing else gets submitted
+        const GLenum waitResult = glClientWaitSync(Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        return waitResult == GL_ALREADY_SIGNALED || waitResult == GL_CONDITION_SATISFIED || waitResult == GL_WAIT_FAILED;
+    }
+
+private:
+    std::vector<std::thread> Workers;
+    mutable std::mutex Mutex;
+    std::condition_variable WorkAvailable;
+    bool bStopping = false;
+
+    // shared with the workers, guarded by Mutex
+    std::deque<DecodeJob> DecodeJobs;
+    std::vector<DecodedImage> FinishedImages;
+    unsigned int PendingTexturesCount = 0;
+
+    // GL thread only
+    std::vector<DecodedImage> DecodedImages;
+    PixelBuffer PixelBuffers[PIXEL_BUFFERS_COUNT];
+};
+#endif
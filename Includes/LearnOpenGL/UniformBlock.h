@@ -0,0 +1,358 @@
+#ifndef UNIFORM_BLOCK_H
+#define UNIFORM_BLOCK_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "LearnOpenGL/GLExtensions.h"
+#include "LearnOpenGL/GLStateCache.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <iostream>
+#include <type_traits>
+#include <unordered_map>
+
+
+/*
+ * C++ counterparts of GLSL types with std140 base alignment & size, to declare uniform block structs with.
+ * Scalars are 4 bytes, vec2 is aligned to 8, vec3/vec4 and matrix columns to 16, array elements are padded to 16.
+ * Note: Vec3 occupies all 16 bytes, so don't pack a scalar right after a vec3 in GLSL (declare explicit padding instead).
+ */
+namespace Std140
+{
+    using Float = float;
+    using Int = std::int32_t;
+    using UInt = std::uint32_t;
+    // GLSL bool is 4 bytes in a uniform block
+    using Bool = std::uint32_t;
+
+    struct alignas(8) Vec2
+    {
+        glm::vec2 Value = glm::vec2(0.f);
+
+        Vec2& operator=(const glm::vec2& NewValue) { Value = NewValue; return *this; }
+    };
+
+    struct alignas(16) Vec3
+    {
+        glm::vec3 Value = glm::vec3(0.f);
+
+        Vec3& operator=(const glm::vec3& NewValue) { Value = NewValue; return *this; }
+    };
+
+    struct alignas(16) Vec4
+    {
+        glm::vec4 Value = glm::vec4(0.f);
+
+        Vec4& operator=(const glm::vec4& NewValue) { Value = NewValue; return *this; }
+    };
+
+    // columns are padded to vec4
+    struct alignas(16) Mat3
+    {
+        glm::vec4 Columns[3] = { glm::vec4(1.f, 0.f, 0.f, 0.f), glm::vec4(0.f, 1.f, 0.f, 0.f), glm::vec4(0.f, 0.f, 1.f, 0.f) };
+
+        Mat3& operator=(const glm::mat3& NewValue)
+        {
+            for (int columnIndex = 0; columnIndex < 3; ++columnIndex)
+            {
+                Columns[columnIndex] = glm::vec4(NewValue[columnIndex], 0.f);
+            }
+            return *this;
+        }
+    };
+
+    struct alignas(16) Mat4
+    {
+        glm::mat4 Value = glm::mat4(1.f);
+
+        Mat4& operator=(const glm::mat4& NewValue) { Value = NewValue; return *this; }
+    };
+
+    // Array element stride is rounded up to 16 bytes
+    template <typename ElementType>
+    struct alignas(16) ArrayElement
+    {
+        ElementType Value{};
+    };
+
+    template <typename ElementType, std::size_t ElementsCount>
+    struct alignas(16) Array
+    {
+        ArrayElement<ElementType> Elements[ElementsCount];
+
+        ElementType& operator[](std::size_t ElementIndex) { return Elements[ElementIndex].Value; }
+        const ElementType& operator[](std::size_t ElementIndex) const { return Elements[ElementIndex].Value; }
+    };
+
+    static_assert(sizeof(Vec2) == 8 && alignof(Vec2) == 8, "std140 vec2 is 8 bytes, aligned to 8");
+    static_assert(sizeof(Vec3) == 16 && alignof(Vec3) == 16, "std140 vec3 is aligned to 16");
+    static_assert(sizeof(Vec4) == 16 && alignof(Vec4) == 16, "std140 vec4 is 16 bytes, aligned to 16");
+    static_assert(sizeof(Mat3) == 48 && alignof(Mat3) == 16, "std140 mat3 is three vec4 columns");
+    static_assert(sizeof(Mat4) == 64 && alignof(Mat4) == 16, "std140 mat4 is four vec4 columns");
+    static_assert(sizeof(Array<Float, 3>) == 48, "std140 array elements have 16 bytes stride");
+}
+
+// Checks at compile time that a block struct member lands on the offset the GLSL std140 rules give it
+#define STD140_ASSERT_OFFSET(BlockType, Member, ExpectedOffset) \
+    static_assert(offsetof(BlockType, Member) == (ExpectedOffset), #BlockType "::" #Member " doesn't match its std140 offset")
+
+/*
+ * Assigns every uniform block name one binding point, shared by all programs: UniformBlock<T> binds its buffer there,
+ * and ShaderProgram points its active blocks of the same name there after linking. So any number of programs read
+ * the same buffer without per-program setup.
+ */
+class UniformBlockBindings
+{
+public:
+    // Returned once all GL_MAX_UNIFORM_BUFFER_BINDINGS binding points are taken; blocks left without one are never bound
+    static constexpr GLuint INVALID_BINDING_POINT = GL_INVALID_INDEX;
+
+    static GLuint GetBindingPoint(const std::string& BlockName)
+    {
+        const auto bindingPoint = BindingPoints.find(BlockName);
+        if (bindingPoint != BindingPoints.end())
+        {
+            return bindingPoint->second;
+        }
+
+        if (MaxBindingPointsCount < 0)
+        {
+            glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &MaxBindingPointsCount);
+        }
+
+        GLuint newBindingPoint = static_cast<GLuint>(AssignedBindingPointsCount);
+        if (AssignedBindingPointsCount < MaxBindingPointsCount)
+        {
+            ++AssignedBindingPointsCount;
+        }
+        else
+        {
+            // remembered as invalid, so it's reported only once
+            std::cout << "Uniform block " << BlockName << " gets no binding point, all " << MaxBindingPointsCount <<
+                " of them (GL_MAX_UNIFORM_BUFFER_BINDINGS) are taken." << std::endl;
+            newBindingPoint = INVALID_BINDING_POINT;
+        }
+        BindingPoints.emplace(BlockName, newBindingPoint);
+        return newBindingPoint;
+    }
+
+    // Declares C++ side size of the block, so programs declaring it with a different layout are reported
+    static void RegisterBlockSize(const std::string& BlockName, GLint BlockSize)
+    {
+        BlockSizes[BlockName] = BlockSize;
+    }
+
+    // Points all active uniform blocks of the program to their shared binding points
+    static void BindProgramBlocks(unsigned int ProgramID)
+    {
+        GLint activeBlocksCount = 0;
+        GLint maxBlockNameLength = 0;
+        glGetProgramiv(ProgramID, GL_ACTIVE_UNIFORM_BLOCKS, &activeBlocksCount);
+        glGetProgramiv(ProgramID, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxBlockNameLength);
+
+        std::string blockName(static_cast<std::size_t>(maxBlockNameLength > 0 ? maxBlockNameLength : 1), '\0');
+        for (GLint blockIndex = 0; blockIndex < activeBlocksCount; ++blockIndex)
+        {
+            GLsizei blockNameLength = 0;
+            glGetActiveUniformBlockName(ProgramID, blockIndex, maxBlockNameLength, &blockNameLength, &blockName[0]);
+            const std::string name = blockName.substr(0, blockNameLength);
+
+            const GLuint bindingPoint = GetBindingPoint(name);
+            if (bindingPoint != INVALID_BINDING_POINT)
+            {
+                glUniformBlockBinding(ProgramID, blockIndex, bindingPoint);
+            }
+
+            const auto blockSize = BlockSizes.find(name);
+            GLint programBlockSize = 0;
+            glGetActiveUniformBlockiv(ProgramID, blockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &programBlockSize);
+            if (blockSize != BlockSizes.end() && programBlockSize > blockSize->second)
+            {
+                std::cout << "Uniform block " << name << " is " << programBlockSize << " bytes in the shader, but only " <<
+                    blockSize->second << " bytes in C++; check that both declare the same members." << std::endl;
+            }
+        }
+    }
+
+private:
+    inline static std::unordered_map<std::string, GLuint> BindingPoints;
+    inline static std::unordered_map<std::string, GLint> BlockSizes;
+    inline static GLint MaxBindingPointsCount = -1;
+    inline static GLint AssignedBindingPointsCount = 0;
+};
+
+/*
+ * Uniform buffer holding one std140 block struct (layout checked at compile time, see Std140 types). Edit the CPU copy
+ * freely during the frame, then Upload pushes the whole struct once: with a single glBufferSubData, or - with
+ * ARB_buffer_storage - a plain memcpy into a persistently mapped ring of FRAMES_IN_FLIGHT slots, fenced so the CPU never
+ * overwrites a slot the GPU may still be reading.
+ */
+template <typename BlockType>
+class UniformBlock
+{
+    static_assert(std::is_trivially_copyable_v<BlockType>, "uniform block struct is memcpy'd into the buffer, so it must be trivially copyable");
+    static_assert(std::is_standard_layout_v<BlockType>, "uniform block struct must be standard layout for member offsets to be well defined");
+    static_assert(alignof(BlockType) == 16, "std140 block base alignment is 16: declare the struct alignas(16)");
+    static_assert(sizeof(BlockType) % 16 == 0, "std140 block size is a multiple of 16");
+
+public:
+    explicit UniformBlock(const char* BlockName)
+        : BindingPoint(UniformBlockBindings::GetBindingPoint(BlockName))
+    {
+        UniformBlockBindings::RegisterBlockSize(BlockName, static_cast<GLint>(sizeof(BlockType)));
+
+        glGenBuffers(1, &BufferID);
+        GLStateCache::BindBuffer(GL_UNIFORM_BUFFER, BufferID);
+
+        if (GLExtensions::bHasBufferStorage)
+        {
+            // each slot has to start at a multiple of the offset alignment to be bindable with glBindBufferRange
+            GLint offsetAlignment = 256;
+            glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+            SlotStride = (sizeof(BlockType) + offsetAlignment - 1) / offsetAlignment * offsetAlignment;
+
+            const GLbitfield mappingFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            GLExtensions::BufferStorage(GL_UNIFORM_BUFFER, SlotStride * FRAMES_IN_FLIGHT, nullptr, mappingFlags);
+            MappedMemory = static_cast<char*>(glMapBufferRange(GL_UNIFORM_BUFFER, 0, SlotStride * FRAMES_IN_FLIGHT, mappingFlags));
+        }
+
+        if (MappedMemory == nullptr)
+        {
+            glBufferData(GL_UNIFORM_BUFFER, sizeof(BlockType), nullptr, GL_DYNAMIC_DRAW);
+        }
+
+        Upload();
+    }
+
+    // Deletes GL buffer & fences (not done by a destructor, as blocks usually outlive the GL context)
+    void DeleteBuffer()
+    {
+        for (GLsync& slotFence : SlotFences)
+        {
+            if (slotFence != nullptr)
+            {
+                glDeleteSync(slotFence);
+                slotFence = nullptr;
+            }
+        }
+
+        if (MappedMemory != nullptr)
+        {
+            GLStateCache::BindBuffer(GL_UNIFORM_BUFFER, BufferID);
+            glUnmapBuffer(GL_UNIFORM_BUFFER);
+            MappedMemory = nullptr;
+        }
+        glDeleteBuffers(1, &BufferID);
+        GLStateCache::OnBufferDeleted(BufferID);
+        BufferID = 0;
+    }
+
+    UniformBlock(const UniformBlock&) = delete;
+    UniformBlock& operator=(const UniformBlock&) = delete;
+
+    // CPU copy of the block; changes reach the GPU with the next Upload
+    BlockType& Edit()
+    {
+        bDirty = true;
+        return Data;
+    }
+
+    const BlockType& Get() const
+    {
+        return Data;
+    }
+
+    // Pushes the whole block (if it was edited since the last upload); call once per frame, before the draws using it
+    void Upload()
+    {
+        if (!bDirty)
+        {
+            return;
+        }
+        bDirty = false;
+
+        if (MappedMemory == nullptr)
+        {
+            GLStateCache::BindBuffer(GL_UNIFORM_BUFFER, BufferID);
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(BlockType), &Data);
+            if (BindingPoint != UniformBlockBindings::INVALID_BINDING_POINT)
+            {
+                GLStateCache::BindBufferBase(GL_UNIFORM_BUFFER, BindingPoint, BufferID);
+            }
+            return;
+        }
+
+        // draws issued since the previous upload read the current slot, so fence it before moving on to the next one
+        if (bSlotInUse)
+        {
+            SlotFences[CurrentSlot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            CurrentSlot = (CurrentSlot + 1) % FRAMES_IN_FLIGHT;
+        }
+        bSlotInUse = true;
+
+        WaitForSlot(CurrentSlot);
+        std::memcpy(MappedMemory + CurrentSlot * SlotStride, &Data, sizeof(BlockType));
+        if (BindingPoint != UniformBlockBindings::INVALID_BINDING_POINT)
+        {
+            GLStateCache::BindBufferRange(GL_UNIFORM_BUFFER, BindingPoint, BufferID, static_cast<GLintptr>(CurrentSlot * SlotStride), sizeof(BlockType));
+        }
+    }
+
+    GLuint GetBindingPoint() const
+    {
+        return BindingPoint;
+    }
+
+    bool IsPersistentlyMapped() const
+    {
+        return MappedMemory != nullptr;
+    }
+
+private:
+    static constexpr std::size_t FRAMES_IN_FLIGHT = 3;
+
+    void WaitForSlot(std::size_t SlotIndex)
+    {
+        GLsync& slotFence = SlotFences[SlotIndex];
+        if (slotFence == nullptr)
+        {
+            return;
+        }
+
+        GLbitfield waitFlags = 0;
+        GLuint64 timeout = 0;
+        while (true)
+        {
+            const GLenum waitResult = glClientWaitSync(slotFence, waitFlags, timeout);
+            if (waitResult == GL_ALREADY_SIGNALED || waitResult == GL_CONDITION_SATISFIED || waitResult == GL_WAIT_FAILED)
+            {
+                break;
+            }
+
+            // GPU is FRAMES_IN_FLIGHT frames behind: flush & actually wait
+            waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+            timeout = 1000000;
+        }
+
+        glDeleteSync(slotFence);
+        slotFence = nullptr;
+    }
+
+private:
+    BlockType Data{};
+    GLuint BindingPoint = 0;
+    GLuint BufferID = 0;
+
+    char* MappedMemory = nullptr;
+    std::size_t SlotStride = 0;
+    std::size_t CurrentSlot = 0;
+    bool bSlotInUse = false;
+    GLsync SlotFences[FRAMES_IN_FLIGHT] = {};
+
+    bool bDirty = true;
+};
+#endif
@@ -0,0 +1,192 @@
+#ifndef UNIFORM_LOCATION_TABLE_H
+#define UNIFORM_LOCATION_TABLE_H
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iostream>
+
+
+// FNV-1a hash of a uniform name; constexpr so hot loops can hash their uniform names at compile time
+constexpr std::uint32_t HashUniformName(std::string_view UniformName)
+{
+    std::uint32_t hash = 2166136261u;
+    for (const char character : UniformName)
+    {
+        hash ^= static_cast<unsigned char>(character);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/*
+ * Precomputed uniform name hash. Declare it once as constexpr (e.g. constexpr UniformKey BlendingScale("blendingScale");)
+ * and pass it to ShaderProgram::SetProgramUniform, so per-frame uniform updates never hash strings or touch the driver.
+ * The name is only viewed (lookups compare it, so names with colliding hashes still resolve to their own locations), i.e.
+ * it has to outlive the key, as string literals do.
+ */
+struct UniformKey
+{
+    constexpr explicit UniformKey(std::string_view UniformName) : Name(UniformName), Hash(HashUniformName(UniformName)) {}
+
+    std::string_view Name;
+    std::uint32_t Hash;
+};
+
+// Per-frame counters of how uniform locations were resolved
+struct UniformLookupStats
+{
+    // glGetUniformLocation calls that the old per-call lookup would have issued, but were served from the table instead
+    unsigned int AvoidedDriverLookups = 0;
+    // lookups made by precomputed UniformKey (no string hashing involved)
+    unsigned int KeyLookups = 0;
+    // lookups made by std::string name (hashed at runtime)
+    unsigned int StringLookups = 0;
+    // lookups of names that aren't active uniforms of the program (resolved to -1, just like glGetUniformLocation does)
+    unsigned int Misses = 0;
+};
+
+/*
+ * Flat open addressing (linear probing) hash table of uniform locations, filled once after program link
+ * from the list of program's active uniforms.
+ */
+class UniformLocationTable
+{
+public:
+    // Query all active uniforms of the given (already linked) program and cache their locations
+    void Build(unsigned int ProgramID)
+    {
+        Entries.clear();
+        Names.clear();
+
+        GLint activeUniformsCount = 0;
+        GLint maxUniformNameLength = 0;
+        glGetProgramiv(ProgramID, GL_ACTIVE_UNIFORMS, &activeUniformsCount);
+        glGetProgramiv(ProgramID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxUniformNameLength);
+
+        // names are collected first, as arrays add an entry per element (plus their base name)
+        std::vector<GLint> locations;
+        std::string uniformName(static_cast<std::size_t>(maxUniformNameLength > 0 ? maxUniformNameLength : 1), '\0');
+        for (GLint uniformIndex = 0; uniformIndex < activeUniformsCount; ++uniformIndex)
+        {
+            GLsizei uniformNameLength = 0;
+            GLint uniformArraySize = 0;
+            GLenum uniformType = 0;
+            glGetActiveUniform(ProgramID, uniformIndex, maxUniformNameLength, &uniformNameLength, &uniformArraySize, &uniformType, &uniformName[0]);
+
+            const std::string activeUniformName = uniformName.substr(0, uniformNameLength);
+            const GLint uniformLocation = glGetUniformLocation(ProgramID, activeUniformName.c_str());
+            if (uniformLocation < 0)
+            {
+                // uniform block members have no location of their own
+                continue;
+            }
+
+            Names.push_back(activeUniformName);
+            locations.push_back(uniformLocation);
+
+            // arrays are reported as "name[0]", but are commonly addressed as "name" and "name[i]" as well
+            const std::string::size_type arraySubscriptPosition = activeUniformName.rfind("[0]");
+            if (arraySubscriptPosition != std::string::npos && arraySubscriptPosition + 3 == activeUniformName.size())
+            {
+                const std::string arrayBaseName = activeUniformName.substr(0, arraySubscriptPosition);
+                Names.push_back(arrayBaseName);
+                locations.push_back(uniformLocation);
+
+                for (GLint elementIndex = 1; elementIndex < uniformArraySize; ++elementIndex)
+                {
+                    Names.push_back(arrayBaseName + "[" + std::to_string(elementIndex) + "]");
+                    locations.push_back(glGetUniformLocation(ProgramID, Names.back().c_str()));
+                }
+            }
+        }
+
+        // keep the load factor at 50% or less
+        std::size_t capacity = 8;
+        while (capacity < Names.size() * 2)
+        {
+            capacity <<= 1;
+        }
+        Entries.resize(capacity);
+
+        for (std::size_t nameIndex = 0; nameIndex < Names.size(); ++nameIndex)
+        {
+            Insert(static_cast<std::uint32_t>(nameIndex), locations[nameIndex]);
+        }
+    }
+
+    GLint Find(UniformKey Key) const
+    {
+        const Entry* entry = FindEntry(Key.Hash, Key.Name);
+        return entry != nullptr ? entry->Location : -1;
+    }
+
+    GLint Find(std::string_view UniformName) const
+    {
+        const Entry* entry = FindEntry(HashUniformName(UniformName), UniformName);
+        return entry != nullptr ? entry->Location : -1;
+    }
+
+    std::size_t Size() const
+    {
+        return Names.size();
+    }
+
+private:
+    struct Entry
+    {
+        std::uint32_t Hash = 0;
+        GLint Location = -1;
+        std::uint32_t NameIndex = 0;
+        bool bOccupied = false;
+    };
+
+    // Names with colliding hashes get entries of their own (further along the probe sequence), told apart by FindEntry
+    void Insert(std::uint32_t NameIndex, GLint UniformLocation)
+    {
+        const std::uint32_t hash = HashUniformName(Names[NameIndex]);
+        const std::size_t mask = Entries.size() - 1;
+
+        std::size_t slot = hash & mask;
+        for (std::size_t probesCount = 0; probesCount < Entries.size(); ++probesCount, slot = (slot + 1) & mask)
+        {
+            Entry& entry = Entries[slot];
+            if (!entry.bOccupied)
+            {
+                entry.Hash = hash;
+                entry.Location = UniformLocation;
+                entry.NameIndex = NameIndex;
+                entry.bOccupied = true;
+                return;
+            }
+        }
+
+        std::cout << "Uniform location table is full, \"" << Names[NameIndex] << "\" left out." << std::endl;
+    }
+
+    const Entry* FindEntry(std::uint32_t Hash, std::string_view UniformName) const
+    {
+        const std::size_t mask = Entries.size() - 1;
+
+        std::size_t slot = Hash & mask;
+        for (std::size_t probesCount = 0; probesCount < Entries.size() && Entries[slot].bOccupied; ++probesCount, slot = (slot + 1) & mask)
+        {
+            const Entry& entry = Entries[slot];
+            if (entry.Hash == Hash && Names[entry.NameIndex] == UniformName)
+            {
+                return &entry;
+            }
+        }
+
+        return nullptr;
+    }
+
+private:
+    std::vector<Entry> Entries;
+    std::vector<std::string> Names;
+};
+#endif
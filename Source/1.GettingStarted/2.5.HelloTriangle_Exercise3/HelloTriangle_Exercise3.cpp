@@ -2,18 +2,16 @@
 #include <GLFW/glfw3.h>
 #include <iostream>
 
+#include "LearnOpenGL/GLExtensions.h"
+#include "LearnOpenGL/GLStateCache.h"
+#include "LearnOpenGL/ProgramPipeline.h"
+
 void OnFramebufferSizeChanged(GLFWwindow* Window, int NewWindowWidth, int NewWindowHeight);
 void ProcessInput(GLFWwindow* Window);
 
 /* Configures provided VAO & VBO associated with it, to draw a triangle with 3 vertices in future, considering current shaders attributes */
 void ConfigureTriangleDrawContext(GLuint& VAO, GLuint& AssociatedVBO, GLfloat (&VerticesData)[9]);
 
-/*
- * Creates and links shader program with given, already compiled vertex shader (simply uses it's ID) and fragment shader source code to use:
- * firstly, compile it, and than use it during shader program linkage (using given vertex and compiled fragment shaders).
- */
-GLuint CreateShaderProgram(const GLuint& vertexShaderID, const char*& FragmentShaderSourceCode);
-
 // Settings
 const int WINDOW_WIDTH = 800.f;
 const int WINDOW_HEIGHT = 600.f;
@@ -75,26 +73,13 @@ int main()
         return -1;
     }
 
-    // Create and compile vertex shader
-    const GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, nullptr);
-    glCompileShader(vertexShader);
-
-    // Verify compiled shader for errors
-    GLint bOperationScceeded = 0;
-    constexpr int compileInfoLogSize = 512;
-    char infoLog[compileInfoLogSize];
-
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &bOperationScceeded);
-    if (!bOperationScceeded)
-    {
-        glGetShaderInfoLog(vertexShader, compileInfoLogSize, nullptr, infoLog);
-        std::cout << "Vertex shader compilation failed:\n" << infoLog << std::endl;
-    }
+    // load post 3.3 core entry points (separate shader objects etc.), features relying on them get disabled if they're missing
+    GLExtensions::Load(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
 
-    const GLuint firstShaderProgram = CreateShaderProgram(vertexShader, fragmentShaderSourceOrange);
-    const GLuint secondShaderProgram = CreateShaderProgram(vertexShader, fragmentShaderSourceYellow);
-    glDeleteShader(vertexShader);
+    // Both pipelines share the same vertex stage: it's compiled once (stages are cached by source), and with separate shader objects
+    // the stages are combined without relinking at all; otherwise each pipeline falls back to linking a regular program
+    ProgramPipeline firstPipeline(vertexShaderSource, fragmentShaderSourceOrange);
+    ProgramPipeline secondPipeline(vertexShaderSource, fragmentShaderSourceYellow);
 
     // Vertices data in NDC (Normalized Device Coordinates)
     float firstTriangleVertices[] =
@@ -129,14 +114,14 @@ int main()
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
-        // Draw first triangle
-        glUseProgram(firstShaderProgram);
-        glBindVertexArray(VAOs[0]);
+        // Draw first triangle (binds go through the state cache, which skips them whenever the object is bound already)
+        firstPipeline.Bind();
+        GLStateCache::BindVertexArray(VAOs[0]);
         glDrawArrays(GL_TRIANGLES, 0, 3);
 
         // Draw second triangle
-        glUseProgram(secondShaderProgram);
-        glBindVertexArray(VAOs[1]); 
+        secondPipeline.Bind();
+        GLStateCache::BindVertexArray(VAOs[1]); 
         glDrawArrays(GL_TRIANGLES, 0, 3);
         // glBindVertexArray(0); // no need to unbind VAO every time 
 
@@ -148,7 +133,9 @@ int main()
     // optional: de-allocate all resources once they've outlived their purpose
     glDeleteVertexArrays(2, VAOs);
     glDeleteBuffers(2, VBOs);
-    glDeleteProgram(firstShaderProgram);
+    firstPipeline.DeletePipeline();
+    secondPipeline.DeletePipeline();
+    ShaderStageCache::DeleteAll();
 
     // glfw: terminate, clearing all previously allocated GLFW resources.
     glfwTerminate();
@@ -189,44 +176,4 @@ void ConfigureTriangleDrawContext(GLuint& VAO, GLuint& AssociatedVBO, GLfloat (&
     // You can unbind the VAO afterwards so other VAO calls won't accidentally modify this VAO, but this rarely happens. Modifying other
     // VAOs requires a call to glBindVertexArray anyways so we generally don't unbind VAOs (nor VBOs) when it's not directly necessary.
     glBindVertexArray(0);
-}
-
-GLuint CreateShaderProgram(const GLuint& vertexShaderID, const char*& FragmentShaderSourceCode)
-{
-    // Create and compile fragment shader from given source code
-    const GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &FragmentShaderSourceCode, nullptr);
-    glCompileShader(fragmentShader);
-
-    GLint bOperationScceeded = 0;
-    constexpr int compileInfoLogSize = 512;
-    char infoLog[compileInfoLogSize];
-
-    // Verify compiled shader for errors
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &bOperationScceeded);
-    if (!bOperationScceeded)
-    {
-        std::fill(std::begin(infoLog), std::end(infoLog), '\0');
-        glGetShaderInfoLog(fragmentShader, compileInfoLogSize, nullptr, infoLog);
-        std::cout << "Fragment shader compilation failed:\n" << infoLog << std::endl;
-    }
-
-    // Link shader program using given vertex and compile fragment shaders
-    const GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShaderID);
-    glAttachShader(shaderProgram, fragmentShader);
-    glDeleteShader(fragmentShader); // we can safely delete compiled shader after attachment to a shader program
-    glLinkProgram(shaderProgram);
-
-    // Verify shader program linkage
-    bOperationScceeded = 0;
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &bOperationScceeded);
-    if (!bOperationScceeded)
-    {
-        std::fill(std::begin(infoLog), std::end(infoLog), '\0');
-        glGetProgramInfoLog(shaderProgram, 512, nullptr, infoLog);
-        std::cout << "Shaders linkage failed:\n" << infoLog << std::endl;
-    }
-
-    return shaderProgram;
 }
\ No newline at end of file
@@ -1,9 +1,14 @@
 #version 330 core
+#extension GL_ARB_explicit_uniform_location : enable
 out vec4 FragColor;
   
 in vec3 ourColor;
 in vec2 TexCoord;
 
+// explicit location lets the shader be baked into SPIR-V (see SpirVShaderLoader); drivers without the extension find it by name
+#ifdef GL_ARB_explicit_uniform_location
+layout(location = 0)
+#endif
 uniform sampler2D ourTexture;
 
 void main()
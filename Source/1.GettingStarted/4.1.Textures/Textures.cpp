@@ -3,7 +3,8 @@
 #include <iostream>
 
 #include "LearnOpenGL/ShaderProgram.h"
-#include "Images/stb_image.h"
+#include "LearnOpenGL/GLStateCache.h"
+#include "LearnOpenGL/TextureCache.h"
 
 void OnFramebufferSizeChanged(GLFWwindow* Window, int NewWindowWidth, int NewWindowHeight);
 void ProcessInput(GLFWwindow* Window);
@@ -91,31 +92,10 @@ int main()
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), reinterpret_cast<void*>(6 * sizeof(float)));
     glEnableVertexAttribArray(2);
 
-    // load and create a texture 
+    // load and create a texture (each image file is decoded & uploaded once, and shared by everything loading it with the same options)
     // -------------------------
-    unsigned int texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture); // all upcoming GL_TEXTURE_2D operations now have effect on this texture object
-    // set the texture wrapping parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);	// set texture wrapping to GL_REPEAT (default wrapping method)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    // set texture filtering parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    // load image, create texture and generate mipmaps
-    int width, height, nrChannels;
-    // The FileSystem::getPath(...) is part of the GitHub repository so we can find files on any IDE/platform; replace it with your own image path.
-    unsigned char *data = stbi_load("Resources\\Textures\\container.jpg", &width, &height, &nrChannels, 0);
-    if (data)
-    {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else
-    {
-        std::cout << "Failed to load texture" << std::endl;
-    }
-    stbi_image_free(data);
+    TextureHandle containerTexture = TextureCache::Load("Resources\\Textures\\container.jpg");
+    GLStateCache::BindTexture(0, GL_TEXTURE_2D, containerTexture->GetID());
     
     // Render Loop
     while (!glfwWindowShouldClose(window))
@@ -139,6 +119,7 @@ int main()
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
+    TextureCache::DeleteAll();
     
     // glfw: terminate, clearing all previously allocated GLFW resources.
     glfwTerminate();
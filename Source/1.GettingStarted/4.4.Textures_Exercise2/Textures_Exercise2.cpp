@@ -2,8 +2,9 @@
 #include <GLFW/glfw3.h>
 #include <iostream>
 
-#include "LearnOpenGL/ShaderProgram.h"
-#include "Images/stb_image.h"
+#include "LearnOpenGL/ShaderVariantSet.h"
+#include "LearnOpenGL/GLStateCache.h"
+#include "LearnOpenGL/TextureCache.h"
 
 void OnFramebufferSizeChanged(GLFWwindow* Window, int NewWindowWidth, int NewWindowHeight);
 void ProcessInput(GLFWwindow* Window);
@@ -45,8 +46,11 @@ int main()
         return -1;
     }
 
-    // build and compile our shader program
-    ShaderProgram program("Source\\1.GettingStarted\\4.4.Textures_Exercise2\\4.4.Shader.vs", "Source\\1.GettingStarted\\4.4.Textures_Exercise2\\4.4.Shader.fs");
+    // build and compile our shader program: all the texture mixing exercises share one fragment shader, each of them just picks its variant (compiled on first use)
+    // blending scale never changes here, so it's baked into the shader as a constant the compiler can fold
+    ShaderVariantSet shaderVariants("Source\\1.GettingStarted\\4.4.Textures_Exercise2\\4.4.Shader.vs", "Source\\1.GettingStarted\\Shared\\TexturesCombined.fs",
+        { "FLIP_SECOND_TEXTURE_X" }, ShaderSpecialization().Set("blendingScale", 0.2f));
+    ShaderProgram& program = shaderVariants.GetVariant({});
     program.UseProgram();
 
     // set up vertex data (and buffer(s)) and configure vertex attributes
@@ -91,56 +95,24 @@ int main()
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), reinterpret_cast<void*>(6 * sizeof(float)));
     glEnableVertexAttribArray(2);
 
-    // load and create textures
+    // load and create textures (each image file is decoded & uploaded once, and shared by everything loading it with the same options)
     // -------------------------
-    unsigned int textures[2];
-    glGenTextures(2, textures);
-
-    glActiveTexture(GL_TEXTURE0); // it's active texture unit by default by i'll bind it explicitly here, to illustrate the concept
-    glBindTexture(GL_TEXTURE_2D, textures[0]); // all upcoming GL_TEXTURE_2D operations now have effect on this texture object
-    // set the texture wrapping parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);	// set texture wrapping to GL_REPEAT (default wrapping method)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    // set texture filtering parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    // load image, create texture and generate mipmaps
-    int width, height, nrChannels;
-    // The FileSystem::getPath(...) is part of the GitHub repository so we can find files on any IDE/platform; replace it with your own image path.
-    unsigned char *data = stbi_load("Resources\\Textures\\container.jpg", &width, &height, &nrChannels, 0);
-    if (data != nullptr)
-    {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else
-    {
-        std::cout << "Failed to load texture" << std::endl;
-    }
-    stbi_image_free(data);
-
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, textures[1]);
-
-    // set the texture wrapping parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);	// set texture wrapping to GL_REPEAT (default wrapping method)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    // set texture filtering parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    stbi_set_flip_vertically_on_load(true); // flip image on load  
-    data = stbi_load("Resources\\Textures\\awesomeface.png", &width, &height, &nrChannels, 0);
-    if (data != nullptr)
-    {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else
-    {
-        std::cout << "Failed to load texture" << std::endl;
-    }
-    stbi_image_free(data);
+    TextureLoadOptions faceLoadOptions;
+    faceLoadOptions.bFlipVertically = true; // flip image on load
+    TextureHandle containerTexture = TextureCache::Load("Resources\\Textures\\container.jpg");
+    TextureHandle faceTexture = TextureCache::Load("Resources\\Textures\\awesomeface.png", faceLoadOptions);
+
+    GLStateCache::BindTexture(0, GL_TEXTURE_2D, containerTexture->GetID());
+    GLStateCache::BindTexture(1, GL_TEXTURE_2D, faceTexture->GetID());
+
+    // cached textures are shared, so wrapping that differs from their defaults goes into a sampler object bound to the unit instead
+    GLuint clampingSampler;
+    glGenSamplers(1, &clampingSampler);
+    glSamplerParameteri(clampingSampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glSamplerParameteri(clampingSampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glSamplerParameteri(clampingSampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glSamplerParameteri(clampingSampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    GLStateCache::BindSampler(0, clampingSampler);
 
     program.SetProgramUniform("texture2", 1); // Bind second texture uniform sample with second texture unit 
     
@@ -166,6 +138,9 @@ int main()
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
+    shaderVariants.DeleteVariants();
+    glDeleteSamplers(1, &clampingSampler);
+    TextureCache::DeleteAll();
     
     // glfw: terminate, clearing all previously allocated GLFW resources.
     glfwTerminate();
@@ -2,8 +2,10 @@
 #include <GLFW/glfw3.h>
 #include <iostream>
 
-#include "LearnOpenGL/ShaderProgram.h"
-#include "Images/stb_image.h"
+#include "LearnOpenGL/GLExtensions.h"
+#include "LearnOpenGL/ShaderVariantSet.h"
+#include "LearnOpenGL/GLStateCache.h"
+#include "LearnOpenGL/TextureCache.h"
 
 void OnFramebufferSizeChanged(GLFWwindow* Window, int NewWindowWidth, int NewWindowHeight);
 void ProcessInput(GLFWwindow* Window, float& OutBlendingScale);
@@ -12,6 +14,9 @@ void ProcessInput(GLFWwindow* Window, float& OutBlendingScale);
 const int WINDOW_WIDTH = 800.f;
 const int WINDOW_HEIGHT = 600.f;
 
+// Uniform names are hashed at compile time, so the render loop doesn't do any string or driver lookups
+constexpr UniformKey BLENDING_SCALE_UNIFORM("blendingScale");
+
 int main()
 {
     // GLWF initialization
@@ -45,8 +50,14 @@ int main()
         return -1;
     }
 
-    // build and compile our shader program
-    ShaderProgram program("Source\\1.GettingStarted\\4.6.Textures_Exercise4\\4.6.Shader.vs", "Source\\1.GettingStarted\\4.6.Textures_Exercise4\\4.6.Shader.fs");
+    // load post 3.3 core entry points (program binaries etc.), features relying on them get disabled if they're missing
+    GLExtensions::Load(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
+
+    // build and compile our shader program: all the texture mixing exercises share one fragment shader, each of them just picks its variant (compiled on first use)
+    ShaderVariantSet shaderVariants("Source\\1.GettingStarted\\4.6.Textures_Exercise4\\4.6.Shader.vs", "Source\\1.GettingStarted\\Shared\\TexturesCombined.fs",
+        { "FLIP_SECOND_TEXTURE_X" });
+    // blending scale is adjusted at runtime, so unlike the other exercises it stays a uniform (every specialized value would be a program of its own)
+    ShaderProgram& program = shaderVariants.GetVariant({});
     program.UseProgram();
 
     // set up vertex data (and buffer(s)) and configure vertex attributes
@@ -91,56 +102,15 @@ int main()
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), reinterpret_cast<void*>(6 * sizeof(float)));
     glEnableVertexAttribArray(2);
 
-    // load and create textures
+    // load and create textures (each image file is decoded & uploaded once, and shared by everything loading it with the same options)
     // -------------------------
-    unsigned int textures[2];
-    glGenTextures(2, textures);
-
-    glActiveTexture(GL_TEXTURE0); // it's active texture unit by default by i'll bind it explicitly here, to illustrate the concept
-    glBindTexture(GL_TEXTURE_2D, textures[0]); // all upcoming GL_TEXTURE_2D operations now have effect on this texture object
-    // set the texture wrapping parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);	// set texture wrapping to GL_REPEAT (default wrapping method)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    // set texture filtering parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    // load image, create texture and generate mipmaps
-    int width, height, nrChannels;
-    // The FileSystem::getPath(...) is part of the GitHub repository so we can find files on any IDE/platform; replace it with your own image path.
-    unsigned char *data = stbi_load("Resources\\Textures\\container.jpg", &width, &height, &nrChannels, 0);
-    if (data != nullptr)
-    {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else
-    {
-        std::cout << "Failed to load texture" << std::endl;
-    }
-    stbi_image_free(data);
+    TextureLoadOptions faceLoadOptions;
+    faceLoadOptions.bFlipVertically = true; // flip image on load
+    TextureHandle containerTexture = TextureCache::Load("Resources\\Textures\\container.jpg");
+    TextureHandle faceTexture = TextureCache::Load("Resources\\Textures\\awesomeface.png", faceLoadOptions);
 
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, textures[1]);
-
-    // set the texture wrapping parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);	// set texture wrapping to GL_REPEAT (default wrapping method)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    // set texture filtering parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    stbi_set_flip_vertically_on_load(true); // flip image on load  
-    data = stbi_load("Resources\\Textures\\awesomeface.png", &width, &height, &nrChannels, 0);
-    if (data != nullptr)
-    {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else
-    {
-        std::cout << "Failed to load texture" << std::endl;
-    }
-    stbi_image_free(data);
+    GLStateCache::BindTexture(0, GL_TEXTURE_2D, containerTexture->GetID());
+    GLStateCache::BindTexture(1, GL_TEXTURE_2D, faceTexture->GetID());
 
     program.SetProgramUniform("texture2", 1); // Bind second texture uniform sample with second texture unit
 
@@ -151,7 +121,7 @@ int main()
     {
         // --- Input ---
         ProcessInput(window, initialBlendingScale);
-        program.SetProgramUniform("blendingScale", initialBlendingScale);
+        program.SetProgramUniform(BLENDING_SCALE_UNIFORM, initialBlendingScale);
 
         // --- Render ---
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
@@ -169,6 +139,8 @@ int main()
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
+    shaderVariants.DeleteVariants();
+    TextureCache::DeleteAll();
     
     // glfw: terminate, clearing all previously allocated GLFW resources.
     glfwTerminate();
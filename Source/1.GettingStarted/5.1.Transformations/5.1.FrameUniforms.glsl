@@ -0,0 +1,5 @@
+// Matrices of the vertex stage, uploaded at once by UniformBlock<FrameUniforms> (keep in sync with the C++ struct)
+layout (std140) uniform FrameUniforms
+{
+    mat4 transform;
+};
@@ -1,11 +1,7 @@
 #version 330 core
 out vec4 FragColor;
-  
-in vec3 ourColor;
-in vec2 TexCoord;
 
-uniform sampler2D texture1;
-uniform sampler2D texture2;
+#include "../Shared/TexturedQuadInputs.glsl"
 uniform float blendingScale;
 
 void main()
@@ -1,14 +1,10 @@
 #version 330 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aColor;
-layout (location = 2) in vec2 aTexCoord;
-
-out vec3 ourColor;
-out vec2 TexCoord;
+#include "../Shared/TexturedQuadAttributes.glsl"
+#include "5.1.FrameUniforms.glsl"
 
 void main()
 {
-    gl_Position = vec4(aPos, 1.0);
+    gl_Position = transform * vec4(aPos, 1.0);
     ourColor = aColor;
     TexCoord = aTexCoord;
 }
\ No newline at end of file
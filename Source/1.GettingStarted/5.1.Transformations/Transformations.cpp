@@ -5,8 +5,13 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
 
+#include "LearnOpenGL/GLExtensions.h"
 #include "LearnOpenGL/ShaderProgram.h"
-#include "Images/stb_image.h"
+#include "LearnOpenGL/ShaderHotReloader.h"
+#include "LearnOpenGL/UniformBlock.h"
+#include "LearnOpenGL/GLStateCache.h"
+#include "LearnOpenGL/TextureCache.h"
+#include "LearnOpenGL/TextureStreamer.h"
 
 void OnFramebufferSizeChanged(GLFWwindow* Window, int NewWindowWidth, int NewWindowHeight);
 void ProcessInput(GLFWwindow* Window, float& OutBlendingScale);
@@ -15,6 +20,16 @@ void ProcessInput(GLFWwindow* Window, float& OutBlendingScale);
 const int WINDOW_WIDTH = 800.f;
 const int WINDOW_HEIGHT = 600.f;
 
+// Uniform names are hashed at compile time, so the render loop doesn't do any string or driver lookups
+constexpr UniformKey BLENDING_SCALE_UNIFORM("blendingScale");
+
+// Mirrors FrameUniforms block of 5.1.FrameUniforms.glsl: the matrices are uploaded as a whole block, instead of per-uniform calls
+struct alignas(16) FrameUniforms
+{
+    Std140::Mat4 Transform;
+};
+STD140_ASSERT_OFFSET(FrameUniforms, Transform, 0);
+
 int main()
 {
     // GLWF initialization
@@ -48,9 +63,19 @@ int main()
         return -1;
     }
 
+    // load post 3.3 core entry points (program binaries etc.), features relying on them get disabled if they're missing
+    GLExtensions::Load(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
+
     // build and compile our shader program
     ShaderProgram program("Source\\1.GettingStarted\\5.1.Transformations\\5.1.Shader.vs", "Source\\1.GettingStarted\\5.1.Transformations\\5.1.Shader.fs");
     program.UseProgram();
+    ProgramBinaryCache::PrintStartupReport();
+    // list the slowest shader builds (and dump all of them as JSON) on exit
+    ShaderBuildTelemetry::ReportAtExit();
+
+    // pick up edits of the shader files while running (Linux only, the watcher is inert elsewhere)
+    ShaderHotReloader shaderHotReloader;
+    shaderHotReloader.Register(program);
 
     // set up vertex data (and buffer(s)) and configure vertex attributes
     // ------------------------------------------------------------------
@@ -94,56 +119,17 @@ int main()
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), reinterpret_cast<void*>(6 * sizeof(float)));
     glEnableVertexAttribArray(2);
 
-    // load and create textures
+    // load and create textures (each image file is decoded & uploaded once, and shared by everything loading it with the same options)
+    // images are decoded in the background, textures show a placeholder until they land, so the first frame doesn't wait for them
     // -------------------------
-    unsigned int textures[2];
-    glGenTextures(2, textures);
-
-    glActiveTexture(GL_TEXTURE0); // it's active texture unit by default by i'll bind it explicitly here, to illustrate the concept
-    glBindTexture(GL_TEXTURE_2D, textures[0]); // all upcoming GL_TEXTURE_2D operations now have effect on this texture object
-    // set the texture wrapping parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);	// set texture wrapping to GL_REPEAT (default wrapping method)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    // set texture filtering parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    // load image, create texture and generate mipmaps
-    int width, height, nrChannels;
-    // The FileSystem::getPath(...) is part of the GitHub repository so we can find files on any IDE/platform; replace it with your own image path.
-    unsigned char *data = stbi_load("Resources\\Textures\\container.jpg", &width, &height, &nrChannels, 0);
-    if (data != nullptr)
-    {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else
-    {
-        std::cout << "Failed to load texture" << std::endl;
-    }
-    stbi_image_free(data);
-
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, textures[1]);
-
-    // set the texture wrapping parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);	// set texture wrapping to GL_REPEAT (default wrapping method)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    // set texture filtering parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    TextureStreamer textureStreamer;
+    TextureLoadOptions faceLoadOptions;
+    faceLoadOptions.bFlipVertically = true; // flip image on load
+    TextureHandle containerTexture = textureStreamer.Load("Resources\\Textures\\container.jpg");
+    TextureHandle faceTexture = textureStreamer.Load("Resources\\Textures\\awesomeface.png", faceLoadOptions);
 
-    stbi_set_flip_vertically_on_load(true); // flip image on load  
-    data = stbi_load("Resources\\Textures\\awesomeface.png", &width, &height, &nrChannels, 0);
-    if (data != nullptr)
-    {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else
-    {
-        std::cout << "Failed to load texture" << std::endl;
-    }
-    stbi_image_free(data);
+    GLStateCache::BindTexture(0, GL_TEXTURE_2D, containerTexture->GetID());
+    GLStateCache::BindTexture(1, GL_TEXTURE_2D, faceTexture->GetID());
 
     program.SetProgramUniform("texture2", 1); // Bind second texture uniform sample with second texture unit
 
@@ -154,30 +140,62 @@ int main()
     trans = glm::translate(trans, glm::vec3(1.0f, 1.0f, 0.0f));
     vec = trans * vec;
     std::cout << vec.x << vec.y << vec.z << std::endl;
+
+    // bound to the same binding point as the FrameUniforms block of every program declaring it; the container itself stays
+    // where it is (identity transform), trans above is only applied to vec
+    UniformBlock<FrameUniforms> frameUniforms("FrameUniforms");
+    frameUniforms.Edit().Transform = glm::mat4(1.0f);
+    frameUniforms.Upload();
+
+    double lastUniformStatsReportTime = glfwGetTime();
     
     // Render Loop
     while (!glfwWindowShouldClose(window))
     {
+        // swap in reloaded shader programs at the frame boundary
+        shaderHotReloader.Update();
+        // upload textures decoded since the last frame
+        textureStreamer.Update();
+
         // --- Input ---
         ProcessInput(window, initialBlendingScale);
-        program.SetProgramUniform("blendingScale", initialBlendingScale);
+        program.SetProgramUniform(BLENDING_SCALE_UNIFORM, initialBlendingScale);
 
         // --- Render ---
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
         
-        glBindVertexArray(VAO);
+        // bind everything the draw needs, as a scene with many objects would; binds of already bound objects never reach the driver
+        program.UseProgram();
+        GLStateCache::BindTexture(0, GL_TEXTURE_2D, containerTexture->GetID());
+        GLStateCache::BindTexture(1, GL_TEXTURE_2D, faceTexture->GetID());
+        GLStateCache::BindVertexArray(VAO);
         glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 
         // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
         glfwPollEvents();
         glfwSwapBuffers(window);
+
+        // report how many glGetUniformLocation calls the cached uniform locations saved us (once a second, to not flood the output)
+        const UniformLookupStats uniformLookupStats = ShaderProgram::ConsumeUniformLookupStats();
+        if (glfwGetTime() - lastUniformStatsReportTime >= 1.0)
+        {
+            std::cout << "Uniform driver lookups avoided this frame: " << uniformLookupStats.AvoidedDriverLookups << std::endl;
+            lastUniformStatsReportTime = glfwGetTime();
+        }
     }
 
+    // report how many bind calls the state cache saved us over the whole run (stats are never consumed before that)
+    const GLStateCacheStats stateCacheStats = GLStateCache::ConsumeFrameStats();
+    std::cout << "GL bind calls: " << stateCacheStats.IssuedCalls << " issued, " << stateCacheStats.ElidedCalls << " elided" << std::endl;
+
     // optional: de-allocate all resources once they've outlived their purpose
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
+    frameUniforms.DeleteBuffer();
+    textureStreamer.Shutdown();
+    TextureCache::DeleteAll();
     
     // glfw: terminate, clearing all previously allocated GLFW resources.
     glfwTerminate();
@@ -0,0 +1,12 @@
+#version 330 core
+#include "../Shared/TexturedQuadAttributes.glsl"
+
+// one transform per instance, all of them set with a single call (see ShaderProgram::SetProgramUniformArray)
+uniform mat4 transforms[2];
+
+void main()
+{
+    gl_Position = transforms[gl_InstanceID] * vec4(aPos, 1.0);
+    ourColor = aColor;
+    TexCoord = aTexCoord;
+}
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <cmath>
+#include <iostream>
+
+#include "LearnOpenGL/GLExtensions.h"
+#include "LearnOpenGL/ShaderProgram.h"
+#include "LearnOpenGL/ShaderBuildQueue.h"
+#include "LearnOpenGL/GLStateCache.h"
+#include "LearnOpenGL/TextureCache.h"
+
+void OnFramebufferSizeChanged(GLFWwindow* Window, int NewWindowWidth, int NewWindowHeight);
+void ProcessInput(GLFWwindow* Window);
+
+// Settings
+const int WINDOW_WIDTH = 800.f;
+const int WINDOW_HEIGHT = 600.f;
+
+// Uniform names are hashed at compile time, so the render loop doesn't do any string or driver lookups
+constexpr UniformKey TRANSFORMS_UNIFORM("transforms");
+
+int main()
+{
+    // GLWF initialization
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    // Initialization adjunct for MacOS 
+#ifdef __APPLE__
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+
+    // GLWF window creation
+    GLFWwindow* window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "LearnOpenGL", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        std::cout << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+
+    // Init context & bind window framebuffer size change callback
+    glfwMakeContextCurrent(window);
+    glfwSetFramebufferSizeCallback(window, OnFramebufferSizeChanged);
+
+    // GLAD: loads all OpenGL function pointers
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+    {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        return -1;
+    }
+
+    // load post 3.3 core entry points (program binaries etc.), features relying on them get disabled if they're missing
+    GLExtensions::Load(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
+
+    // build and compile our shader program (blending scale never changes here, so it's baked into the shader as a constant);
+    // only submitted here, the driver compiles it while the buffers & textures below are set up
+    ShaderBuildQueue buildQueue;
+    ShaderProgram program("Source\\1.GettingStarted\\5.2.Transformations_Exercise2\\5.2.Shader.vs", "Source\\1.GettingStarted\\Shared\\TexturesCombined.fs",
+        {}, ShaderSpecialization().Set("blendingScale", 0.2f), ShaderProgram::EBuildMode::Deferred);
+    buildQueue.Submit(program);
+
+    // set up vertex data (and buffer(s)) and configure vertex attributes
+    // ------------------------------------------------------------------
+    float vertexData[] = {
+        // positions        // colors           // texture coords
+        0.5f,  0.5f, 0.0f,  1.0f, 0.0f, 0.0f,   1.0f, 1.0f, // top right
+        0.5f, -0.5f, 0.0f,  0.0f, 1.0f, 0.0f,   1.0f, 0.0f, // bottom right
+        -0.5f, -0.5f, 0.0f, 0.0f, 0.0f, 1.0f,   0.0f, 0.0f, // bottom left
+        -0.5f,  0.5f, 0.0f, 1.0f, 1.0f, 0.0f,   0.0f, 1.0f  // top left 
+    };
+    
+    unsigned int vertexIndices[] = {  
+        0, 1, 3, // first triangle
+        1, 2, 3  // second triangle
+    };
+
+    // Create and bind vertex array object, to store all vertex attributes related calls with it
+    GLuint VAO, VBO, EBO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+
+    // Bind vertex array object, to store all vertex attributes related calls with it
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO); 
+
+    // Allocates memory on GPU and stores data withing the initialized memory in the currently bound VBO
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertexData), vertexData, GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    // Allocates memory and stores data withing the initialized memory in the currently bound EBO
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(vertexIndices), vertexIndices, GL_STATIC_DRAW); 
+
+    // position attribute
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), static_cast<void*>(0));
+    glEnableVertexAttribArray(0);
+    // color attribute
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), reinterpret_cast<void*>(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    // texture coord attribute
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), reinterpret_cast<void*>(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    // load and create textures (each image file is decoded & uploaded once, and shared by everything loading it with the same options)
+    // -------------------------
+    TextureLoadOptions faceLoadOptions;
+    faceLoadOptions.bFlipVertically = true; // flip image on load
+    TextureHandle containerTexture = TextureCache::Load("Resources\\Textures\\container.jpg");
+    TextureHandle faceTexture = TextureCache::Load("Resources\\Textures\\awesomeface.png", faceLoadOptions);
+
+    GLStateCache::BindTexture(0, GL_TEXTURE_2D, containerTexture->GetID());
+    GLStateCache::BindTexture(1, GL_TEXTURE_2D, faceTexture->GetID());
+
+    // finish the shader program build (errors are reported there)
+    buildQueue.WaitAll();
+    program.UseProgram();
+    program.SetProgramUniform("texture2", 1); // Bind second texture uniform sample with second texture unit
+    
+    // Render Loop
+    while (!glfwWindowShouldClose(window))
+    {
+        // --- Input ---
+        ProcessInput(window);
+
+        const float time = static_cast<float>(glfwGetTime());
+        glm::mat4 transforms[2];
+
+        // first container: translated to the bottom right, then rotated over time
+        transforms[0] = glm::translate(glm::mat4(1.0f), glm::vec3(0.5f, -0.5f, 0.0f));
+        transforms[0] = glm::rotate(transforms[0], time, glm::vec3(0.0f, 0.0f, 1.0f));
+
+        // second container: translated to the top left, then scaled over time
+        const float scale = std::sin(time);
+        transforms[1] = glm::translate(glm::mat4(1.0f), glm::vec3(-0.5f, 0.5f, 0.0f));
+        transforms[1] = glm::scale(transforms[1], glm::vec3(scale, scale, scale));
+
+        // both transforms go to the program in one call (no need for the program to be in use), and both containers are drawn by one instanced draw
+        program.SetProgramUniformArray(TRANSFORMS_UNIFORM, transforms, 2);
+
+        // --- Render ---
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        
+        program.UseProgram();
+        glBindVertexArray(VAO);
+        glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, 2);
+
+        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+        glfwPollEvents();
+        glfwSwapBuffers(window);
+    }
+
+    // optional: de-allocate all resources once they've outlived their purpose
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+    TextureCache::DeleteAll();
+    
+    // glfw: terminate, clearing all previously allocated GLFW resources.
+    glfwTerminate();
+    return 0;
+}
+
+void OnFramebufferSizeChanged(GLFWwindow* Window, int NewWindowWidth, int NewWindowHeight)
+{
+    // Resize viewport accordingly
+    glViewport(0, 0, NewWindowWidth, NewWindowHeight);
+}
+
+void ProcessInput(GLFWwindow* Window)
+{
+    if (glfwGetKey(Window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+    {
+        glfwSetWindowShouldClose(Window, true);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+// Vertex attributes layout & outputs shared by the textured quad samples
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aColor;
+layout (location = 2) in vec2 aTexCoord;
+
+out vec3 ourColor;
+out vec2 TexCoord;
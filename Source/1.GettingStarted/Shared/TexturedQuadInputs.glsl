@@ -0,0 +1,6 @@
+// Interpolated inputs & texture samplers shared by the fragment shaders mixing two textures
+in vec3 ourColor;
+in vec2 TexCoord;
+
+uniform sampler2D texture1;
+uniform sampler2D texture2;
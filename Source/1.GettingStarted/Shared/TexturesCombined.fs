@@ -0,0 +1,18 @@
+#version 330 core
+out vec4 FragColor;
+
+// Variants (see ShaderVariantSet): FLIP_SECOND_TEXTURE_X mirrors the second texture horizontally.
+// blendingScale is turned into a constant by samples specializing it (see ShaderSpecialization)
+#include "TexturedQuadInputs.glsl"
+
+uniform float blendingScale;
+
+void main()
+{
+#ifdef FLIP_SECOND_TEXTURE_X
+    vec2 secondTexCoord = vec2(1.0 - TexCoord.x, TexCoord.y);
+#else
+    vec2 secondTexCoord = TexCoord;
+#endif
+    FragColor = mix(texture(texture1, TexCoord), texture(texture2, secondTexCoord), blendingScale);
+}
@@ -0,0 +1,200 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <cmath>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <utility>
+#include <algorithm>
+#include <filesystem>
+
+#include "Images/stb_image.h"
+#include "LearnOpenGL/GLExtensions.h"
+#include "LearnOpenGL/BlockCompressor.h"
+
+/*
+ * Measures BlockCompressor on every format & quality: encode throughput (single threaded & on all cores) and PSNR of the result.
+ * PSNR is taken from what the driver decodes (blocks are uploaded with glCompressedTexImage2D & read back), over the channels the
+ * format stores, with the image's missing channels read as GL does. Images are decoded once up front, only encoding is timed.
+ * Usage: BlockCompression [textures root directory (default: Resources/Textures)] [passes over all found images (default: 5)]
+ * Needs a GL context (hidden window); formats the driver doesn't support are skipped.
+ */
+
+struct DecodedImage
+{
+    std::string FilePath;
+    std::vector<unsigned char> Pixels;
+    int Width = 0;
+    int Height = 0;
+    int Channels = 0;
+};
+
+// Collects & decodes all image files under the given directory
+std::vector<DecodedImage> DecodeImageFiles(const std::filesystem::path& RootDirectory);
+
+// Encodes every image passesCount times; returns the time spent in milliseconds
+double MeasureEncoding(const std::vector<DecodedImage>& Images, int PassesCount, const BlockCompressionOptions& Options);
+
+// Mean squared error of the decoded blocks over all images & the channels of the format
+double MeasureError(const std::vector<DecodedImage>& Images, const BlockCompressionOptions& Options);
+
+int main(int argc, char* argv[])
+{
+    const std::filesystem::path rootDirectory = argc > 1 ? argv[1] : "Resources/Textures";
+    const int passesCount = argc > 2 ? std::stoi(argv[2]) : 5;
+
+    const std::vector<DecodedImage> images = DecodeImageFiles(rootDirectory);
+    if (images.empty())
+    {
+        std::cout << "No image files found under " << rootDirectory.string() << std::endl;
+        return -1;
+    }
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+
+    GLFWwindow* window = glfwCreateWindow(64, 64, "BlockCompression", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        std::cout << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+    {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    GLExtensions::Load(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
+
+    double pixelsCount = 0.0;
+    for (const DecodedImage& image : images)
+    {
+        pixelsCount += static_cast<double>(image.Width) * image.Height;
+    }
+    const unsigned int coresCount = std::max(std::thread::hardware_concurrency(), 1u);
+    std::cout << "Encoded " << images.size() << " images x " << passesCount << " passes (" << pixelsCount / 1e6 << " Mpixels per pass, " << coresCount << " cores)\n";
+
+    const std::pair<const char*, EBlockFormat> formats[] = {
+        { "BC1", EBlockFormat::BC1 }, { "BC3", EBlockFormat::BC3 }, { "BC4", EBlockFormat::BC4 }, { "BC5", EBlockFormat::BC5 }, { "BC7", EBlockFormat::BC7 }
+    };
+    const std::pair<const char*, EBlockCompressionQuality> qualities[] = {
+        { "fast  ", EBlockCompressionQuality::Fast }, { "normal", EBlockCompressionQuality::Normal }, { "high  ", EBlockCompressionQuality::High }
+    };
+    for (const auto& format : formats)
+    {
+        if (!BlockCompressor::IsSupported(format.second, false))
+        {
+            std::cout << "  " << format.first << ": not supported by the driver, skipped\n";
+            continue;
+        }
+
+        for (const auto& quality : qualities)
+        {
+            BlockCompressionOptions options;
+            options.Format = format.second;
+            options.Quality = quality.second;
+            const double meanSquaredError = MeasureError(images, options);
+
+            options.ThreadsCount = 1;
+            const double singleThreadTime = MeasureEncoding(images, passesCount, options);
+            options.ThreadsCount = 0;
+            const double allCoresTime = MeasureEncoding(images, passesCount, options);
+
+            const double psnr = meanSquaredError > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / meanSquaredError) : 99.0;
+            std::cout << "  " << format.first << " " << quality.first << ": PSNR " << psnr << " dB, " << pixelsCount * passesCount / (singleThreadTime * 1e3) <<
+                " Mpixels/s on 1 thread, " << pixelsCount * passesCount / (allCoresTime * 1e3) << " Mpixels/s on all cores (" <<
+                BlockCompressor::GetBlockSize(format.second) / 2 << " bits per texel)\n";
+        }
+    }
+    std::cout << std::flush;
+
+    glfwTerminate();
+    return 0;
+}
+
+std::vector<DecodedImage> DecodeImageFiles(const std::filesystem::path& RootDirectory)
+{
+    std::vector<DecodedImage> images;
+
+    std::error_code errorCode;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(RootDirectory, errorCode))
+    {
+        const std::filesystem::path extension = entry.path().extension();
+        if (!entry.is_regular_file() || (extension != ".jpg" && extension != ".jpeg" && extension != ".png" && extension != ".tga" && extension != ".bmp"))
+        {
+            continue;
+        }
+
+        DecodedImage image;
+        image.FilePath = entry.path().string();
+        unsigned char* pixels = stbi_load(image.FilePath.c_str(), &image.Width, &image.Height, &image.Channels, 0);
+        if (pixels == nullptr)
+        {
+            std::cout << "Failed to load texture " << image.FilePath << std::endl;
+            continue;
+        }
+        image.Pixels.assign(pixels, pixels + static_cast<std::size_t>(image.Width) * image.Height * image.Channels);
+        stbi_image_free(pixels);
+        images.push_back(std::move(image));
+    }
+
+    return images;
+}
+
+double MeasureEncoding(const std::vector<DecodedImage>& Images, int PassesCount, const BlockCompressionOptions& Options)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    for (int passIndex = 0; passIndex < PassesCount; ++passIndex)
+    {
+        for (const DecodedImage& image : Images)
+        {
+            BlockCompressor::Compress(image.Pixels.data(), image.Width, image.Height, image.Channels, Options);
+        }
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+double MeasureError(const std::vector<DecodedImage>& Images, const BlockCompressionOptions& Options)
+{
+    const int formatChannels = BlockCompressor::GetChannels(Options.Format);
+    double squaredErrorsSum = 0.0;
+    double valuesCount = 0.0;
+    for (const DecodedImage& image : Images)
+    {
+        const std::vector<unsigned char> blocks = BlockCompressor::Compress(image.Pixels.data(), image.Width, image.Height, image.Channels, Options);
+
+        GLuint textureID;
+        glGenTextures(1, &textureID);
+        glBindTexture(GL_TEXTURE_2D, textureID);
+        glCompressedTexImage2D(GL_TEXTURE_2D, 0, BlockCompressor::GetInternalFormat(Options.Format, false), image.Width, image.Height, 0,
+            static_cast<GLsizei>(blocks.size()), blocks.data());
+
+        std::vector<unsigned char> decodedPixels(static_cast<std::size_t>(image.Width) * image.Height * 4);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, decodedPixels.data());
+        glDeleteTextures(1, &textureID);
+
+        for (std::size_t texelIndex = 0; texelIndex < static_cast<std::size_t>(image.Width) * image.Height; ++texelIndex)
+        {
+            for (int channel = 0; channel < formatChannels; ++channel)
+            {
+                const int sourceValue = channel < image.Channels ? image.Pixels[texelIndex * image.Channels + channel] : channel == 3 ? 255 : 0;
+                const double difference = sourceValue - decodedPixels[texelIndex * 4 + channel];
+                squaredErrorsSum += difference * difference;
+            }
+        }
+        valuesCount += static_cast<double>(image.Width) * image.Height * formatChannels;
+    }
+    return squaredErrorsSum / valuesCount;
+}
\ No newline at end of file
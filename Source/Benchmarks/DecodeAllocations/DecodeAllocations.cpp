@@ -0,0 +1,120 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <filesystem>
+
+#include "Images/stb_image.h"
+#include "LearnOpenGL/ImageArena.h"
+
+/*
+ * Counts the heap allocations stb_image makes while decoding, with & without an ImageArena::Scope around each image (as
+ * TextureCache & BakedTextureLoader do). Every image is decoded PassesCount times; the first pass in the arena is reported on
+ * its own since it's the one that sizes the arena, the following ones are the steady state.
+ * Usage: DecodeAllocations [textures root directory (default: Resources/Textures)] [passes over all found images (default: 5)]
+ * Doesn't need a GL context.
+ */
+
+struct DecodePassResult
+{
+    ImageArenaStats Stats;
+    double Milliseconds = 0.0;
+};
+
+// Collects all image files under the given directory
+std::vector<std::string> FindImageFiles(const std::filesystem::path& RootDirectory);
+
+// Decodes every image once, each one in its own arena scope if bInArena; stats are the difference over the pass
+DecodePassResult DecodePass(const std::vector<std::string>& FilePaths, bool bInArena);
+
+void PrintResult(const char* Label, const DecodePassResult& Result, int PassesCount, std::size_t ImagesCount);
+
+int main(int argc, char* argv[])
+{
+    const std::filesystem::path rootDirectory = argc > 1 ? argv[1] : "Resources/Textures";
+    const int passesCount = std::max(argc > 2 ? std::stoi(argv[2]) : 5, 2);
+
+    const std::vector<std::string> filePaths = FindImageFiles(rootDirectory);
+    if (filePaths.empty())
+    {
+        std::cout << "No image files found under " << rootDirectory.string() << std::endl;
+        return -1;
+    }
+    std::cout << "Decoded " << filePaths.size() << " images x " << passesCount << " passes\n";
+
+    DecodePassResult heapResult;
+    for (int passIndex = 0; passIndex < passesCount; ++passIndex)
+    {
+        const DecodePassResult passResult = DecodePass(filePaths, false);
+        heapResult.Stats.HeapAllocations += passResult.Stats.HeapAllocations;
+        heapResult.Milliseconds += passResult.Milliseconds;
+    }
+    PrintResult("heap              ", heapResult, passesCount, filePaths.size());
+
+    const DecodePassResult firstArenaResult = DecodePass(filePaths, true);
+    PrintResult("arena, first pass ", firstArenaResult, 1, filePaths.size());
+
+    DecodePassResult arenaResult;
+    for (int passIndex = 1; passIndex < passesCount; ++passIndex)
+    {
+        const DecodePassResult passResult = DecodePass(filePaths, true);
+        arenaResult.Stats.HeapAllocations += passResult.Stats.HeapAllocations;
+        arenaResult.Stats.ArenaAllocations += passResult.Stats.ArenaAllocations;
+        arenaResult.Milliseconds += passResult.Milliseconds;
+    }
+    PrintResult("arena, next passes", arenaResult, passesCount - 1, filePaths.size());
+    std::cout << "  arena reserved " << ImageArena::GetStats().ReservedBytes / 1024 << " KB" << std::endl;
+
+    return 0;
+}
+
+std::vector<std::string> FindImageFiles(const std::filesystem::path& RootDirectory)
+{
+    std::vector<std::string> filePaths;
+
+    std::error_code errorCode;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(RootDirectory, errorCode))
+    {
+        const std::filesystem::path extension = entry.path().extension();
+        if (entry.is_regular_file() && (extension == ".jpg" || extension == ".jpeg" || extension == ".png" || extension == ".tga" || extension == ".bmp"))
+        {
+            filePaths.push_back(entry.path().string());
+        }
+    }
+
+    return filePaths;
+}
+
+DecodePassResult DecodePass(const std::vector<std::string>& FilePaths, bool bInArena)
+{
+    const ImageArenaStats startStats = ImageArena::GetStats();
+    const auto startTime = std::chrono::steady_clock::now();
+    for (const std::string& filePath : FilePaths)
+    {
+        std::unique_ptr<ImageArena::Scope> arenaScope = bInArena ? std::make_unique<ImageArena::Scope>() : nullptr;
+        int width, height, channels;
+        unsigned char* pixels = stbi_load(filePath.c_str(), &width, &height, &channels, 0);
+        if (pixels == nullptr)
+        {
+            std::cout << "Failed to load texture " << filePath << std::endl;
+            continue;
+        }
+        stbi_image_free(pixels);
+    }
+
+    DecodePassResult result;
+    result.Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    const ImageArenaStats endStats = ImageArena::GetStats();
+    result.Stats.ArenaAllocations = endStats.ArenaAllocations - startStats.ArenaAllocations;
+    result.Stats.HeapAllocations = endStats.HeapAllocations - startStats.HeapAllocations;
+    return result;
+}
+
+void PrintResult(const char* Label, const DecodePassResult& Result, int PassesCount, std::size_t ImagesCount)
+{
+    const double decodesCount = static_cast<double>(PassesCount) * ImagesCount;
+    std::cout << "  " << Label << ": " << Result.Stats.HeapAllocations << " heap allocations (" << Result.Stats.HeapAllocations / decodesCount <<
+        " per image), " << Result.Stats.ArenaAllocations << " arena allocations, " << Result.Milliseconds / decodesCount << " ms per image\n";
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+
+#include "Images/stb_image.h"
+#include "LearnOpenGL/JpegSimdKernels.h"
+
+/*
+ * Decodes every JPEG under a directory with stb_image's SSE2 kernels, then with the AVX2 ones (JpegSimdKernels), for RGB &
+ * RGBA output, and checks both give the very same pixels. Decoding is timed over PassesCount passes on each path.
+ * Usage: JpegDecoding [textures root directory (default: Resources/Textures)] [passes over all found images (default: 20)]
+ * Doesn't need a GL context.
+ */
+
+struct DecodedImage
+{
+    std::vector<unsigned char> Pixels;
+    int Width = 0;
+    int Height = 0;
+};
+
+// Collects all JPEG files under the given directory
+std::vector<std::string> FindJpegFiles(const std::filesystem::path& RootDirectory);
+
+// Decodes all images PassesCount times into Channels channels; returns the total time & keeps the images of the last pass
+double DecodeImages(const std::vector<std::string>& FilePaths, int Channels, int PassesCount, std::vector<DecodedImage>& OutImages);
+
+int main(int argc, char* argv[])
+{
+    const std::filesystem::path rootDirectory = argc > 1 ? argv[1] : "Resources/Textures";
+    const int passesCount = std::max(argc > 2 ? std::stoi(argv[2]) : 20, 1);
+
+    const std::vector<std::string> filePaths = FindJpegFiles(rootDirectory);
+    if (filePaths.empty())
+    {
+        std::cout << "No JPEG files found under " << rootDirectory.string() << std::endl;
+        return -1;
+    }
+    if (!JpegSimdKernels::IsAvx2Supported())
+    {
+        std::cout << "AVX2 isn't supported on this CPU, only the SSE2 kernels can be measured" << std::endl;
+    }
+    std::cout << "Decoded " << filePaths.size() << " JPEGs x " << passesCount << " passes\n";
+
+    bool bAllMatching = true;
+    for (const int channels : { 3, 4 })
+    {
+        std::vector<DecodedImage> sse2Images;
+        JpegSimdKernels::SetAvx2Enabled(false);
+        const double sse2Milliseconds = DecodeImages(filePaths, channels, passesCount, sse2Images);
+
+        std::vector<DecodedImage> avx2Images;
+        JpegSimdKernels::SetAvx2Enabled(true);
+        const double avx2Milliseconds = DecodeImages(filePaths, channels, passesCount, avx2Images);
+
+        double pixelsCount = 0.0;
+        for (const DecodedImage& image : sse2Images)
+        {
+            pixelsCount += static_cast<double>(image.Width) * image.Height * passesCount;
+        }
+
+        bool bMatching = sse2Images.size() == avx2Images.size();
+        for (std::size_t imageIndex = 0; bMatching && imageIndex < sse2Images.size(); ++imageIndex)
+        {
+            bMatching = sse2Images[imageIndex].Pixels == avx2Images[imageIndex].Pixels;
+        }
+        bAllMatching = bAllMatching && bMatching;
+
+        std::cout << "  " << channels << " channels: SSE2 " << pixelsCount / (sse2Milliseconds * 1000.0) << " Mpixels/s, " << (JpegSimdKernels::IsAvx2Enabled() ?
+            "AVX2 " : "AVX2 (unsupported, SSE2) ") << pixelsCount / (avx2Milliseconds * 1000.0) << " Mpixels/s (x" << sse2Milliseconds / avx2Milliseconds << "), " <<
+            (bMatching ? "identical output" : "OUTPUT MISMATCH") << "\n";
+    }
+
+    return bAllMatching ? 0 : -1;
+}
+
+std::vector<std::string> FindJpegFiles(const std::filesystem::path& RootDirectory)
+{
+    std::vector<std::string> filePaths;
+
+    std::error_code errorCode;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(RootDirectory, errorCode))
+    {
+        const std::filesystem::path extension = entry.path().extension();
+        if (entry.is_regular_file() && (extension == ".jpg" || extension == ".jpeg"))
+        {
+            filePaths.push_back(entry.path().string());
+        }
+    }
+
+    return filePaths;
+}
+
+double DecodeImages(const std::vector<std::string>& FilePaths, int Channels, int PassesCount, std::vector<DecodedImage>& OutImages)
+{
+    // read the files up front, so only decoding gets timed
+    std::vector<std::vector<unsigned char>> fileContents;
+    for (const std::string& filePath : FilePaths)
+    {
+        std::error_code errorCode;
+        const std::uintmax_t fileSize = std::filesystem::file_size(filePath, errorCode);
+        std::vector<unsigned char> contents(errorCode ? 0 : static_cast<std::size_t>(fileSize));
+        if (FILE* file = std::fopen(filePath.c_str(), "rb"))
+        {
+            contents.resize(std::fread(contents.data(), 1, contents.size(), file));
+            std::fclose(file);
+        }
+        fileContents.push_back(std::move(contents));
+    }
+
+    OutImages.assign(FilePaths.size(), DecodedImage());
+    const auto startTime = std::chrono::steady_clock::now();
+    for (int passIndex = 0; passIndex < PassesCount; ++passIndex)
+    {
+        for (std::size_t fileIndex = 0; fileIndex < fileContents.size(); ++fileIndex)
+        {
+            const std::vector<unsigned char>& contents = fileContents[fileIndex];
+            int width, height, channels;
+            unsigned char* pixels = stbi_load_from_memory(contents.data(), static_cast<int>(contents.size()), &width, &height, &channels, Channels);
+            if (pixels == nullptr)
+            {
+                if (passIndex == 0)
+                {
+                    std::cout << "Failed to decode " << FilePaths[fileIndex] << ": " << stbi_failure_reason() << std::endl;
+                }
+                continue;
+            }
+            if (passIndex == PassesCount - 1)
+            {
+                OutImages[fileIndex] = { std::vector<unsigned char>(pixels, pixels + static_cast<std::size_t>(width) * height * Channels), width, height };
+            }
+            stbi_image_free(pixels);
+        }
+    }
+
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
\ No newline at end of file
@@ -0,0 +1,201 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <utility>
+#include <algorithm>
+#include <filesystem>
+
+#include "Images/stb_image.h"
+#include "LearnOpenGL/MipChainGenerator.h"
+
+/*
+ * Compares glGenerateMipmap with MipChainGenerator (box & Kaiser filters, single threaded & on all cores) plus the upload
+ * of the generated levels. Images are decoded once up front, so only mipmap generation & uploads are measured.
+ * Usage: MipmapGeneration [textures root directory (default: Resources/Textures)] [passes over all found images (default: 20)]
+ * Needs a GL context (hidden window); every texture ends with glFinish, so the GPU (or llvmpipe) side is included.
+ */
+
+struct DecodedImage
+{
+    std::string FilePath;
+    std::vector<unsigned char> Pixels;
+    int Width = 0;
+    int Height = 0;
+    int Channels = 0;
+};
+
+// Collects & decodes all image files under the given directory
+std::vector<DecodedImage> DecodeImageFiles(const std::filesystem::path& RootDirectory);
+
+GLenum GetPixelFormat(int Channels);
+
+// Uploads every image & generates its mipmaps passesCount times; returns the time spent in milliseconds
+double MeasureDriverMipmaps(const std::vector<DecodedImage>& Images, int PassesCount);
+double MeasureCpuMipmaps(const std::vector<DecodedImage>& Images, int PassesCount, const MipGenerationOptions& Options);
+
+int main(int argc, char* argv[])
+{
+    const std::filesystem::path rootDirectory = argc > 1 ? argv[1] : "Resources/Textures";
+    const int passesCount = argc > 2 ? std::stoi(argv[2]) : 20;
+
+    const std::vector<DecodedImage> images = DecodeImageFiles(rootDirectory);
+    if (images.empty())
+    {
+        std::cout << "No image files found under " << rootDirectory.string() << std::endl;
+        return -1;
+    }
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+
+    GLFWwindow* window = glfwCreateWindow(64, 64, "MipmapGeneration", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        std::cout << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+    {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+
+    MipGenerationOptions boxOptions;
+    boxOptions.bPremultipliedAlpha = true;
+    MipGenerationOptions boxSingleThreadOptions = boxOptions;
+    boxSingleThreadOptions.ThreadsCount = 1;
+    MipGenerationOptions boxSrgbOptions = boxOptions;
+    boxSrgbOptions.bSRGB = true;
+    MipGenerationOptions kaiserOptions = boxOptions;
+    kaiserOptions.Filter = EMipFilter::Kaiser;
+    MipGenerationOptions kaiserSrgbOptions = kaiserOptions;
+    kaiserSrgbOptions.bSRGB = true;
+
+    // warm up the driver & the generator's tables
+    MeasureDriverMipmaps(images, 1);
+    MeasureCpuMipmaps(images, 1, kaiserSrgbOptions);
+
+    const double driverTime = MeasureDriverMipmaps(images, passesCount);
+    const double texturesCount = static_cast<double>(images.size()) * passesCount;
+    std::cout << "Generated mipmaps of " << images.size() << " textures x " << passesCount << " passes (" <<
+        std::max(std::thread::hardware_concurrency(), 1u) << " cores)\n" <<
+        "  glGenerateMipmap:          " << driverTime << " ms (" << driverTime / texturesCount << " ms per texture)\n";
+
+    const std::pair<const char*, const MipGenerationOptions*> cpuVariants[] = {
+        { "box, 1 thread:             ", &boxSingleThreadOptions },
+        { "box:                       ", &boxOptions },
+        { "box, sRGB:                 ", &boxSrgbOptions },
+        { "Kaiser:                    ", &kaiserOptions },
+        { "Kaiser, sRGB:              ", &kaiserSrgbOptions }
+    };
+    for (const auto& cpuVariant : cpuVariants)
+    {
+        const double cpuTime = MeasureCpuMipmaps(images, passesCount, *cpuVariant.second);
+        std::cout << "  MipChainGenerator " << cpuVariant.first << cpuTime << " ms (" << cpuTime / texturesCount << " ms per texture, " <<
+            driverTime / cpuTime << "x the driver speed)\n";
+    }
+    std::cout << std::flush;
+
+    glfwTerminate();
+    return 0;
+}
+
+std::vector<DecodedImage> DecodeImageFiles(const std::filesystem::path& RootDirectory)
+{
+    std::vector<DecodedImage> images;
+
+    std::error_code errorCode;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(RootDirectory, errorCode))
+    {
+        const std::filesystem::path extension = entry.path().extension();
+        if (!entry.is_regular_file() || (extension != ".jpg" && extension != ".jpeg" && extension != ".png" && extension != ".tga" && extension != ".bmp"))
+        {
+            continue;
+        }
+
+        DecodedImage image;
+        image.FilePath = entry.path().string();
+        unsigned char* pixels = stbi_load(image.FilePath.c_str(), &image.Width, &image.Height, &image.Channels, 0);
+        if (pixels == nullptr)
+        {
+            std::cout << "Failed to load texture " << image.FilePath << std::endl;
+            continue;
+        }
+        image.Pixels.assign(pixels, pixels + static_cast<std::size_t>(image.Width) * image.Height * image.Channels);
+        stbi_image_free(pixels);
+        images.push_back(std::move(image));
+    }
+
+    return images;
+}
+
+GLenum GetPixelFormat(int Channels)
+{
+    return Channels == 1 ? GL_RED : Channels == 2 ? GL_RG : Channels == 3 ? GL_RGB : GL_RGBA;
+}
+
+double MeasureDriverMipmaps(const std::vector<DecodedImage>& Images, int PassesCount)
+{
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    const auto startTime = std::chrono::steady_clock::now();
+    for (int passIndex = 0; passIndex < PassesCount; ++passIndex)
+    {
+        for (const DecodedImage& image : Images)
+        {
+            GLuint textureID;
+            glGenTextures(1, &textureID);
+            glBindTexture(GL_TEXTURE_2D, textureID);
+
+            const GLenum pixelFormat = GetPixelFormat(image.Channels);
+            glTexImage2D(GL_TEXTURE_2D, 0, pixelFormat, image.Width, image.Height, 0, pixelFormat, GL_UNSIGNED_BYTE, image.Pixels.data());
+            glGenerateMipmap(GL_TEXTURE_2D);
+
+            glFinish();
+            glDeleteTextures(1, &textureID);
+        }
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+double MeasureCpuMipmaps(const std::vector<DecodedImage>& Images, int PassesCount, const MipGenerationOptions& Options)
+{
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    const auto startTime = std::chrono::steady_clock::now();
+    for (int passIndex = 0; passIndex < PassesCount; ++passIndex)
+    {
+        for (const DecodedImage& image : Images)
+        {
+            GLuint textureID;
+            glGenTextures(1, &textureID);
+            glBindTexture(GL_TEXTURE_2D, textureID);
+
+            const GLenum pixelFormat = GetPixelFormat(image.Channels);
+            glTexImage2D(GL_TEXTURE_2D, 0, pixelFormat, image.Width, image.Height, 0, pixelFormat, GL_UNSIGNED_BYTE, image.Pixels.data());
+            const std::vector<MipLevel> mipLevels = MipChainGenerator::Generate(image.Pixels.data(), image.Width, image.Height, image.Channels, Options);
+            for (std::size_t levelIndex = 0; levelIndex < mipLevels.size(); ++levelIndex)
+            {
+                glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(levelIndex + 1), pixelFormat, mipLevels[levelIndex].Width, mipLevels[levelIndex].Height, 0,
+                    pixelFormat, GL_UNSIGNED_BYTE, mipLevels[levelIndex].Pixels.data());
+            }
+
+            glFinish();
+            glDeleteTextures(1, &textureID);
+        }
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
\ No newline at end of file
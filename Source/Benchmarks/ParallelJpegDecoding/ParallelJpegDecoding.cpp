@@ -0,0 +1,135 @@
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <filesystem>
+
+#include "Images/stb_image.h"
+#include "LearnOpenGL/ParallelJpegDecoder.h"
+
+/*
+ * Decodes every JPEG under a directory with stbi_load_from_memory, then with ParallelJpegDecoder on 1, 2, 4... threads up to the
+ * cores count, and checks all of them give the very same pixels. Small images & JPEGs the parallel path doesn't take (progressive
+ * ones, several scans...) are decoded by stb_image either way, so the corpus should have large baseline JPEGs, with & without
+ * restart markers (e.g. cjpeg -restart 1 for one interval per MCU row), to measure the scaling of both splits.
+ * Usage: ParallelJpegDecoding [textures root directory (default: Resources/Textures)] [passes over all found images (default: 5)]
+ * Doesn't need a GL context.
+ */
+
+struct JpegFile
+{
+    std::string FilePath;
+    std::vector<unsigned char> Contents;
+};
+
+// Reads all JPEG files under the given directory
+std::vector<JpegFile> ReadJpegFiles(const std::filesystem::path& RootDirectory);
+
+// Decodes all files PassesCount times, with stb_image if ThreadsCount is 0; returns the total time & the images of the last pass
+double DecodeFiles(const std::vector<JpegFile>& Files, unsigned int ThreadsCount, int PassesCount, std::vector<std::vector<unsigned char>>& OutImages,
+    double& OutPixelsCount);
+
+int main(int argc, char* argv[])
+{
+    const std::filesystem::path rootDirectory = argc > 1 ? argv[1] : "Resources/Textures";
+    const int passesCount = std::max(argc > 2 ? std::stoi(argv[2]) : 5, 1);
+
+    const std::vector<JpegFile> files = ReadJpegFiles(rootDirectory);
+    if (files.empty())
+    {
+        std::cout << "No JPEG files found under " << rootDirectory.string() << std::endl;
+        return -1;
+    }
+    const unsigned int coresCount = std::max(std::thread::hardware_concurrency(), 1u);
+    std::cout << "Decoded " << files.size() << " JPEGs x " << passesCount << " passes, " << coresCount << " cores\n";
+
+    std::vector<std::vector<unsigned char>> stbImages;
+    double pixelsCount = 0.0;
+    const double stbMilliseconds = DecodeFiles(files, 0, passesCount, stbImages, pixelsCount);
+    std::cout << "  stb_image         : " << stbMilliseconds / passesCount << " ms per pass, " << pixelsCount / (stbMilliseconds * 1000.0) << " Mpixels/s\n";
+
+    bool bAllMatching = true;
+    for (unsigned int threadsCount = 1; ; threadsCount = std::min(threadsCount * 2, coresCount))
+    {
+        std::vector<std::vector<unsigned char>> images;
+        const double milliseconds = DecodeFiles(files, threadsCount, passesCount, images, pixelsCount);
+        const bool bMatching = images == stbImages;
+        bAllMatching = bAllMatching && bMatching;
+
+        std::cout << "  " << threadsCount << (threadsCount < 10 ? " " : "") << " threads        : " << milliseconds / passesCount << " ms per pass, " <<
+            pixelsCount / (milliseconds * 1000.0) << " Mpixels/s (x" << stbMilliseconds / milliseconds << "), " << (bMatching ? "identical output" :
+            "OUTPUT MISMATCH") << "\n";
+        if (threadsCount == coresCount)
+        {
+            break;
+        }
+    }
+
+    return bAllMatching ? 0 : -1;
+}
+
+std::vector<JpegFile> ReadJpegFiles(const std::filesystem::path& RootDirectory)
+{
+    std::vector<JpegFile> files;
+
+    std::error_code errorCode;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(RootDirectory, errorCode))
+    {
+        const std::filesystem::path extension = entry.path().extension();
+        if (!entry.is_regular_file() || (extension != ".jpg" && extension != ".jpeg"))
+        {
+            continue;
+        }
+
+        JpegFile file;
+        file.FilePath = entry.path().string();
+        file.Contents.resize(static_cast<std::size_t>(entry.file_size(errorCode)));
+        if (FILE* fileHandle = std::fopen(file.FilePath.c_str(), "rb"))
+        {
+            file.Contents.resize(std::fread(file.Contents.data(), 1, file.Contents.size(), fileHandle));
+            std::fclose(fileHandle);
+            files.push_back(std::move(file));
+        }
+    }
+
+    return files;
+}
+
+double DecodeFiles(const std::vector<JpegFile>& Files, unsigned int ThreadsCount, int PassesCount, std::vector<std::vector<unsigned char>>& OutImages,
+    double& OutPixelsCount)
+{
+    OutImages.assign(Files.size(), std::vector<unsigned char>());
+    OutPixelsCount = 0.0;
+
+    const auto startTime = std::chrono::steady_clock::now();
+    for (int passIndex = 0; passIndex < PassesCount; ++passIndex)
+    {
+        for (std::size_t fileIndex = 0; fileIndex < Files.size(); ++fileIndex)
+        {
+            const std::vector<unsigned char>& contents = Files[fileIndex].Contents;
+            int width, height, channels;
+            unsigned char* pixels = ThreadsCount == 0 ?
+                stbi_load_from_memory(contents.data(), static_cast<int>(contents.size()), &width, &height, &channels, 0) :
+                ParallelJpegDecoder::LoadFromMemory(contents.data(), static_cast<int>(contents.size()), &width, &height, &channels, 0, ThreadsCount);
+            if (pixels == nullptr)
+            {
+                if (passIndex == 0)
+                {
+                    std::cout << "Failed to decode " << Files[fileIndex].FilePath << ": " << stbi_failure_reason() << std::endl;
+                }
+                continue;
+            }
+            OutPixelsCount += static_cast<double>(width) * height;
+            if (passIndex == PassesCount - 1)
+            {
+                OutImages[fileIndex].assign(pixels, pixels + static_cast<std::size_t>(width) * height * channels);
+            }
+            stbi_image_free(pixels);
+        }
+    }
+
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+
+// a private copy of stb_image's own zlib decoder, the one stb_image.cpp leaves out for FastInflate
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_PNG
+// stb_image's own warnings (unused static declarations, signed/unsigned comparisons) aren't ours to fix
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+#include "Images/stb_image.h"
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+#include "LearnOpenGL/FastInflate.h"
+
+/*
+ * Inflates the image data (IDAT chunks) of every PNG under a directory with stb_image's zlib decoder, then with FastInflate
+ * (checking the Adler-32 of the data, then skipping it as for trusted assets) and checks all of them give the very same bytes.
+ * Only inflating is timed, both decoders being given the exact inflated size up front as stb_image's PNG loader does; unfiltering
+ * & channel conversion are left out. Large, noisy textures (photos, normal maps...) show the gains best, highly compressible
+ * ones are mostly bound by writing the output.
+ * Usage: PngInflate [textures root directory (default: Resources/Textures)] [passes over all found images (default: 20)]
+ * Doesn't need a GL context.
+ */
+
+struct ZlibStream
+{
+    std::string FilePath;
+    std::vector<unsigned char> Data;
+    std::vector<unsigned char> Inflated;
+};
+
+// Reads the concatenated IDAT chunks of all PNG files under the given directory, inflated once with stb_image for reference
+std::vector<ZlibStream> ReadZlibStreams(const std::filesystem::path& RootDirectory);
+
+// Inflates all streams PassesCount times, with stb_image if bFastInflate is false; returns the total time & whether all outputs matched
+double InflateStreams(const std::vector<ZlibStream>& Streams, bool bFastInflate, bool bVerifyChecksum, int PassesCount, bool& OutMatching);
+
+int main(int argc, char* argv[])
+{
+    const std::filesystem::path rootDirectory = argc > 1 ? argv[1] : "Resources/Textures";
+    const int passesCount = std::max(argc > 2 ? std::stoi(argv[2]) : 20, 1);
+
+    const std::vector<ZlibStream> streams = ReadZlibStreams(rootDirectory);
+    if (streams.empty())
+    {
+        std::cout << "No PNG files found under " << rootDirectory.string() << std::endl;
+        return -1;
+    }
+    double megabytesCount = 0.0;
+    for (const ZlibStream& stream : streams)
+    {
+        megabytesCount += static_cast<double>(stream.Inflated.size()) * passesCount / 1000000.0;
+    }
+    std::cout << "Inflated " << streams.size() << " PNGs x " << passesCount << " passes, " << megabytesCount / passesCount << " MB per pass\n";
+
+    bool bMatching = true;
+    const double stbMilliseconds = InflateStreams(streams, false, false, passesCount, bMatching);
+    std::cout << "  stb_image                 : " << megabytesCount * 1000.0 / stbMilliseconds << " MB/s\n";
+
+    bool bAllMatching = true;
+    for (const bool bVerifyChecksum : { true, false })
+    {
+        const double milliseconds = InflateStreams(streams, true, bVerifyChecksum, passesCount, bMatching);
+        bAllMatching = bAllMatching && bMatching;
+
+        std::cout << "  FastInflate" << (bVerifyChecksum ? " (Adler-32)    : " : " (no checksum) : ") << megabytesCount * 1000.0 / milliseconds << " MB/s (x" <<
+            stbMilliseconds / milliseconds << "), " << (bMatching ? "identical output" : "OUTPUT MISMATCH") << "\n";
+    }
+
+    return bAllMatching ? 0 : -1;
+}
+
+std::vector<ZlibStream> ReadZlibStreams(const std::filesystem::path& RootDirectory)
+{
+    std::vector<ZlibStream> streams;
+
+    std::error_code errorCode;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(RootDirectory, errorCode))
+    {
+        if (!entry.is_regular_file() || entry.path().extension() != ".png")
+        {
+            continue;
+        }
+
+        std::vector<unsigned char> contents(static_cast<std::size_t>(entry.file_size(errorCode)));
+        if (FILE* file = std::fopen(entry.path().string().c_str(), "rb"))
+        {
+            contents.resize(std::fread(contents.data(), 1, contents.size(), file));
+            std::fclose(file);
+        }
+
+        // chunks are a big endian length, a 4 character type, the data & a CRC, after the 8 bytes signature
+        ZlibStream stream;
+        stream.FilePath = entry.path().string();
+        for (std::size_t chunkPosition = 8; chunkPosition + 12 <= contents.size(); )
+        {
+            const unsigned char* chunk = contents.data() + chunkPosition;
+            const std::size_t length = static_cast<std::size_t>(chunk[0]) << 24 | chunk[1] << 16 | chunk[2] << 8 | chunk[3];
+            if (length > contents.size() - chunkPosition - 12)
+            {
+                break;
+            }
+            if (std::memcmp(chunk + 4, "IDAT", 4) == 0)
+            {
+                stream.Data.insert(stream.Data.end(), chunk + 8, chunk + 8 + length);
+            }
+            chunkPosition += length + 12;
+        }
+
+        int inflatedSize = 0;
+        char* inflated = stbi_zlib_decode_malloc(reinterpret_cast<const char*>(stream.Data.data()), static_cast<int>(stream.Data.size()), &inflatedSize);
+        if (inflated == nullptr)
+        {
+            std::cout << "Failed to inflate " << stream.FilePath << ": " << stbi_failure_reason() << std::endl;
+            continue;
+        }
+        stream.Inflated.assign(inflated, inflated + inflatedSize);
+        STBI_FREE(inflated);
+        streams.push_back(std::move(stream));
+    }
+
+    return streams;
+}
+
+double InflateStreams(const std::vector<ZlibStream>& Streams, bool bFastInflate, bool bVerifyChecksum, int PassesCount, bool& OutMatching)
+{
+    OutMatching = true;
+
+    const auto startTime = std::chrono::steady_clock::now();
+    for (int passIndex = 0; passIndex < PassesCount; ++passIndex)
+    {
+        for (const ZlibStream& stream : Streams)
+        {
+            const std::size_t inflatedSize = stream.Inflated.size();
+            unsigned char* inflated = nullptr;
+            std::size_t size = 0;
+            if (bFastInflate)
+            {
+                FastInflate::OutputBuffer output = { static_cast<unsigned char*>(std::malloc(std::max<std::size_t>(inflatedSize, 1))), 0, inflatedSize,
+                    [](unsigned char* Data, std::size_t, std::size_t NewSize) { return static_cast<unsigned char*>(std::realloc(Data, NewSize)); } };
+                const char* failureReason = nullptr;
+                if (!FastInflate::Inflate(stream.Data.data(), stream.Data.size(), true, bVerifyChecksum, output, failureReason) && passIndex == 0)
+                {
+                    std::cout << "FastInflate failed on " << stream.FilePath << ": " << failureReason << std::endl;
+                }
+                inflated = output.Data;
+                size = output.Size;
+            }
+            else
+            {
+                int length = 0;
+                inflated = reinterpret_cast<unsigned char*>(stbi_zlib_decode_malloc_guesssize_headerflag(reinterpret_cast<const char*>(stream.Data.data()),
+                    static_cast<int>(stream.Data.size()), static_cast<int>(inflatedSize), &length, 1));
+                size = inflated != nullptr ? static_cast<std::size_t>(length) : 0;
+            }
+
+            if (passIndex == PassesCount - 1)
+            {
+                OutMatching = OutMatching && size == inflatedSize && (size == 0 || std::memcmp(inflated, stream.Inflated.data(), size) == 0);
+            }
+            std::free(inflated);
+        }
+    }
+
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
\ No newline at end of file
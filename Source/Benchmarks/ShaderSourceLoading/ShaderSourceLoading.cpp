@@ -0,0 +1,117 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#include "LearnOpenGL/ShaderSourceLoader.h"
+
+/*
+ * Compares ShaderProgram's former ifstream -> stringstream -> string source loading with ReadShaderSourceFile, the single read
+ * straight into an exactly sized string that ShaderPreprocessor loads (and caches) every shader file with.
+ * Usage: ShaderSourceLoading [shaders root directory (default: Source)] [passes over all found shaders (default: 200)]
+ * Needs no GL context, since glShaderSource isn't part of what's measured.
+ */
+
+// Collects all .vs/.fs files under the given directory
+std::vector<std::string> FindShaderFiles(const std::filesystem::path& RootDirectory);
+
+// Returns total number of loaded bytes (so the compiler can't throw the work away)
+std::size_t LoadWithStringStreams(const std::vector<std::string>& ShaderFilePaths);
+std::size_t LoadWithSingleRead(const std::vector<std::string>& ShaderFilePaths);
+
+int main(int argc, char* argv[])
+{
+    const std::filesystem::path rootDirectory = argc > 1 ? argv[1] : "Source";
+    const int passesCount = argc > 2 ? std::stoi(argv[2]) : 200;
+
+    const std::vector<std::string> shaderFilePaths = FindShaderFiles(rootDirectory);
+    if (shaderFilePaths.empty())
+    {
+        std::cout << "No shader files found under " << rootDirectory.string() << std::endl;
+        return -1;
+    }
+
+    // warm up the OS file cache, so both paths read from memory
+    LoadWithSingleRead(shaderFilePaths);
+
+    std::size_t loadedBytesCount = 0;
+
+    const auto streamsStartTime = std::chrono::steady_clock::now();
+    for (int passIndex = 0; passIndex < passesCount; ++passIndex)
+    {
+        loadedBytesCount += LoadWithStringStreams(shaderFilePaths);
+    }
+    const std::chrono::duration<double, std::milli> streamsTime = std::chrono::steady_clock::now() - streamsStartTime;
+
+    const auto singleReadStartTime = std::chrono::steady_clock::now();
+    for (int passIndex = 0; passIndex < passesCount; ++passIndex)
+    {
+        loadedBytesCount += LoadWithSingleRead(shaderFilePaths);
+    }
+    const std::chrono::duration<double, std::milli> singleReadTime = std::chrono::steady_clock::now() - singleReadStartTime;
+
+    const double filesCount = static_cast<double>(shaderFilePaths.size()) * passesCount;
+    std::cout << "Loaded " << shaderFilePaths.size() << " shader files x " << passesCount << " passes (" << loadedBytesCount / 2 << " bytes per method)\n" <<
+        "  ifstream + stringstream: " << streamsTime.count() << " ms (" << streamsTime.count() * 1000.0 / filesCount << " us per file)\n" <<
+        "  ReadShaderSourceFile:    " << singleReadTime.count() << " ms (" << singleReadTime.count() * 1000.0 / filesCount << " us per file)\n" <<
+        "  speedup: " << streamsTime.count() / singleReadTime.count() << "x" << std::endl;
+
+    return 0;
+}
+
+std::vector<std::string> FindShaderFiles(const std::filesystem::path& RootDirectory)
+{
+    std::vector<std::string> shaderFilePaths;
+
+    std::error_code errorCode;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(RootDirectory, errorCode))
+    {
+        const std::filesystem::path extension = entry.path().extension();
+        if (entry.is_regular_file() && (extension == ".vs" || extension == ".fs"))
+        {
+            shaderFilePaths.push_back(entry.path().string());
+        }
+    }
+
+    return shaderFilePaths;
+}
+
+std::size_t LoadWithStringStreams(const std::vector<std::string>& ShaderFilePaths)
+{
+    std::size_t loadedBytesCount = 0;
+
+    // exactly what ShaderProgram used to do per stage
+    for (const std::string& shaderFilePath : ShaderFilePaths)
+    {
+        std::ifstream shaderSourceFile;
+        shaderSourceFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        shaderSourceFile.open(shaderFilePath);
+
+        std::stringstream shaderStream;
+        shaderStream << shaderSourceFile.rdbuf();
+        shaderSourceFile.close();
+
+        const std::string shaderSourceCode = shaderStream.str();
+        loadedBytesCount += shaderSourceCode.size();
+    }
+
+    return loadedBytesCount;
+}
+
+std::size_t LoadWithSingleRead(const std::vector<std::string>& ShaderFilePaths)
+{
+    std::size_t loadedBytesCount = 0;
+
+    // a string per file, as ShaderPreprocessor keeps every file it reads
+    for (const std::string& shaderFilePath : ShaderFilePaths)
+    {
+        std::string shaderSourceCode;
+        ReadShaderSourceFile(shaderFilePath.c_str(), shaderSourceCode);
+        loadedBytesCount += shaderSourceCode.size();
+    }
+
+    return loadedBytesCount;
+}
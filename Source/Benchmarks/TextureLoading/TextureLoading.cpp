@@ -0,0 +1,225 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#include "LearnOpenGL/BakedTextureLoader.h"
+
+/*
+ * Compares the runtime texture loading path (stb_image decode + glTexImage2D + glGenerateMipmap) with uploading baked KTX2
+ * files (memory mapped, all levels uploaded as they are). The images are copied into a scratch directory under the system's
+ * temp directory and baked there (not measured), so the benchmark doesn't leave baked files in the source tree; both paths
+ * load the copies. Every baked file has to open, otherwise the benchmark fails instead of timing a partial pass.
+ * Usage: TextureLoading [textures root directory (default: Resources/Textures)] [passes over all found images (default: 20)]
+ * Needs a GL context (hidden window); both paths end with glFinish, so the GPU side of uploads & mipmap generation is included.
+ */
+
+// Collects all image files under the given directory
+std::vector<std::string> FindImageFiles(const std::filesystem::path& RootDirectory);
+
+// Copies the images into the scratch directory (keeping their paths relative to the root), unless they're there already; returns the copies' paths
+std::vector<std::string> CopyImageFiles(const std::vector<std::string>& ImageFilePaths, const std::filesystem::path& RootDirectory,
+    const std::filesystem::path& ScratchDirectory);
+
+// Returns total number of uploaded bytes (level 0 only for the decode path, as the driver generates the rest)
+std::size_t LoadWithDecode(const std::vector<std::string>& ImageFilePaths);
+// Same as above; images whose baked file couldn't be opened are counted in OutMissedFilesCount
+std::size_t LoadBaked(const std::vector<std::string>& ImageFilePaths, std::size_t& OutMissedFilesCount);
+
+int main(int argc, char* argv[])
+{
+    const std::filesystem::path rootDirectory = argc > 1 ? argv[1] : "Resources/Textures";
+    const int passesCount = argc > 2 ? std::stoi(argv[2]) : 20;
+
+    const std::vector<std::string> sourceImageFilePaths = FindImageFiles(rootDirectory);
+    if (sourceImageFilePaths.empty())
+    {
+        std::cout << "No image files found under " << rootDirectory.string() << std::endl;
+        return -1;
+    }
+
+    std::error_code errorCode;
+    const std::filesystem::path scratchDirectory = std::filesystem::temp_directory_path(errorCode) / "LearnOpenGL" / "TextureLoading";
+    const std::vector<std::string> imageFilePaths = errorCode ? std::vector<std::string>() :
+        CopyImageFiles(sourceImageFilePaths, rootDirectory, scratchDirectory);
+    if (imageFilePaths.size() != sourceImageFilePaths.size())
+    {
+        std::cout << "Failed to copy the images into " << scratchDirectory.string() << std::endl;
+        return -1;
+    }
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+
+    GLFWwindow* window = glfwCreateWindow(64, 64, "TextureLoading", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        std::cout << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+    {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+
+    for (const std::string& imageFilePath : imageFilePaths)
+    {
+        if (!BakedTextureLoader::IsUpToDate(imageFilePath, TextureLoadOptions()) && !BakedTextureLoader::Bake(imageFilePath, TextureLoadOptions()))
+        {
+            glfwTerminate();
+            return -1;
+        }
+    }
+
+    // warm up the OS file cache & the driver, so both paths start from the same state
+    std::size_t missedFilesCount = 0;
+    const std::size_t decodedBytesCount = LoadWithDecode(imageFilePaths);
+    const std::size_t bakedBytesCount = LoadBaked(imageFilePaths, missedFilesCount);
+    if (missedFilesCount > 0)
+    {
+        std::cout << missedFilesCount << " of " << imageFilePaths.size() << " baked textures failed to open" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+
+    const auto decodeStartTime = std::chrono::steady_clock::now();
+    for (int passIndex = 0; passIndex < passesCount; ++passIndex)
+    {
+        LoadWithDecode(imageFilePaths);
+    }
+    const std::chrono::duration<double, std::milli> decodeTime = std::chrono::steady_clock::now() - decodeStartTime;
+
+    const auto bakedStartTime = std::chrono::steady_clock::now();
+    for (int passIndex = 0; passIndex < passesCount; ++passIndex)
+    {
+        LoadBaked(imageFilePaths, missedFilesCount);
+    }
+    const std::chrono::duration<double, std::milli> bakedTime = std::chrono::steady_clock::now() - bakedStartTime;
+    if (missedFilesCount > 0)
+    {
+        std::cout << missedFilesCount << " baked texture loads failed during the timed passes" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+
+    const double texturesCount = static_cast<double>(imageFilePaths.size()) * passesCount;
+    std::cout << "Loaded " << imageFilePaths.size() << " textures x " << passesCount << " passes (" << decodedBytesCount << " decoded bytes, " << bakedBytesCount <<
+        " baked bytes per pass)\n" <<
+        "  stb_image + glGenerateMipmap: " << decodeTime.count() << " ms (" << decodeTime.count() / texturesCount << " ms per texture)\n" <<
+        "  baked KTX2:                   " << bakedTime.count() << " ms (" << bakedTime.count() / texturesCount << " ms per texture)\n" <<
+        "  speedup: " << decodeTime.count() / bakedTime.count() << "x" << std::endl;
+
+    glfwTerminate();
+    return 0;
+}
+
+std::vector<std::string> FindImageFiles(const std::filesystem::path& RootDirectory)
+{
+    std::vector<std::string> imageFilePaths;
+
+    std::error_code errorCode;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(RootDirectory, errorCode))
+    {
+        const std::filesystem::path extension = entry.path().extension();
+        if (entry.is_regular_file() && (extension == ".jpg" || extension == ".jpeg" || extension == ".png" || extension == ".tga" || extension == ".bmp"))
+        {
+            imageFilePaths.push_back(entry.path().string());
+        }
+    }
+
+    return imageFilePaths;
+}
+
+std::vector<std::string> CopyImageFiles(const std::vector<std::string>& ImageFilePaths, const std::filesystem::path& RootDirectory,
+    const std::filesystem::path& ScratchDirectory)
+{
+    std::vector<std::string> copiedFilePaths;
+
+    for (const std::string& imageFilePath : ImageFilePaths)
+    {
+        std::error_code errorCode;
+        const std::filesystem::path copiedFilePath = ScratchDirectory / std::filesystem::path(imageFilePath).lexically_relative(RootDirectory);
+        std::filesystem::create_directories(copiedFilePath.parent_path(), errorCode);
+        // an unchanged copy keeps its write time, so its baked file stays up to date between runs
+        std::filesystem::copy_file(imageFilePath, copiedFilePath, std::filesystem::copy_options::update_existing, errorCode);
+        if (errorCode)
+        {
+            std::cout << "Failed to copy " << imageFilePath << ": " << errorCode.message() << std::endl;
+            continue;
+        }
+        copiedFilePaths.push_back(copiedFilePath.string());
+    }
+
+    return copiedFilePaths;
+}
+
+std::size_t LoadWithDecode(const std::vector<std::string>& ImageFilePaths)
+{
+    std::size_t uploadedBytesCount = 0;
+
+    // what the 4.x samples do per texture
+    for (const std::string& imageFilePath : ImageFilePaths)
+    {
+        GLuint textureID;
+        glGenTextures(1, &textureID);
+        glBindTexture(GL_TEXTURE_2D, textureID);
+
+        int width, height, channels;
+        unsigned char* pixels = stbi_load(imageFilePath.c_str(), &width, &height, &channels, 0);
+        if (pixels != nullptr)
+        {
+            const GLenum pixelFormat = channels == 1 ? GL_RED : channels == 2 ? GL_RG : channels == 3 ? GL_RGB : GL_RGBA;
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glTexImage2D(GL_TEXTURE_2D, 0, pixelFormat, width, height, 0, pixelFormat, GL_UNSIGNED_BYTE, pixels);
+            glGenerateMipmap(GL_TEXTURE_2D);
+            uploadedBytesCount += static_cast<std::size_t>(width) * height * channels;
+            stbi_image_free(pixels);
+        }
+
+        glFinish();
+        glDeleteTextures(1, &textureID);
+    }
+
+    return uploadedBytesCount;
+}
+
+std::size_t LoadBaked(const std::vector<std::string>& ImageFilePaths, std::size_t& OutMissedFilesCount)
+{
+    std::size_t uploadedBytesCount = 0;
+
+    for (const std::string& imageFilePath : ImageFilePaths)
+    {
+        GLuint textureID;
+        glGenTextures(1, &textureID);
+        glBindTexture(GL_TEXTURE_2D, textureID);
+
+        BakedTextureFile bakedTexture;
+        if (BakedTextureLoader::OpenUpToDate(imageFilePath, TextureLoadOptions(), bakedTexture))
+        {
+            bakedTexture.Upload();
+            uploadedBytesCount += bakedTexture.GetSizeInBytes();
+        }
+        else
+        {
+            ++OutMissedFilesCount;
+        }
+
+        glFinish();
+        glDeleteTextures(1, &textureID);
+    }
+
+    return uploadedBytesCount;
+}
\ No newline at end of file
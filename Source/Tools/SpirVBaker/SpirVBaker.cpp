@@ -0,0 +1,125 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#include "LearnOpenGL/ShaderPreprocessor.h"
+#include "LearnOpenGL/SpirVShaderLoader.h"
+
+/*
+ * Offline build step baking GLSL shaders into SPIR-V modules for OpenGL (picked up by ShaderProgram through SpirVShaderLoader).
+ * Usage: SpirVBaker [shaders root directory (default: Source)] [glslangValidator executable (default: $GLSLANG_VALIDATOR,
+ * or ThirdParty/glslang/bin/glslangValidator)]
+ * Every .vs/.fs file gets its #includes expanded exactly like at runtime, and is compiled into "<file>.spv" next to it.
+ * Only shaders with explicit locations / bindings for all of their uniforms are baked (the rest are found by name, which
+ * SPIR-V doesn't guarantee, so they're always compiled from GLSL). Up to date binaries are skipped. No GL context is needed.
+ */
+
+// Collects all .vs/.fs files under the given directory
+std::vector<std::string> FindShaderFiles(const std::filesystem::path& RootDirectory);
+
+enum class EBakeResult : unsigned int
+{
+    // (re)baked successfully or up to date already
+    Baked,
+    // shader relies on uniform names, so it's left to GLSL
+    Skipped,
+    Failed
+};
+
+EBakeResult BakeShader(ShaderPreprocessor& Preprocessor, const std::string& ShaderFilePath, const std::string& CompilerPath);
+
+int main(int argc, char* argv[])
+{
+    const std::filesystem::path rootDirectory = argc > 1 ? argv[1] : "Source";
+    const char* compilerPathVariable = std::getenv("GLSLANG_VALIDATOR");
+    const std::string compilerPath = argc > 2 ? argv[2] : compilerPathVariable != nullptr ? compilerPathVariable : "ThirdParty/glslang/bin/glslangValidator";
+
+    const std::vector<std::string> shaderFilePaths = FindShaderFiles(rootDirectory);
+    if (shaderFilePaths.empty())
+    {
+        std::cout << "No shader files found under " << rootDirectory.string() << std::endl;
+        return -1;
+    }
+
+    ShaderPreprocessor preprocessor;
+    std::size_t bakedShadersCount = 0;
+    std::size_t skippedShadersCount = 0;
+    int failedShadersCount = 0;
+    for (const std::string& shaderFilePath : shaderFilePaths)
+    {
+        const EBakeResult bakeResult = BakeShader(preprocessor, shaderFilePath, compilerPath);
+        bakedShadersCount += bakeResult == EBakeResult::Baked ? 1 : 0;
+        skippedShadersCount += bakeResult == EBakeResult::Skipped ? 1 : 0;
+        failedShadersCount += bakeResult == EBakeResult::Failed ? 1 : 0;
+    }
+
+    std::cout << "Baked " << bakedShadersCount << " of " << shaderFilePaths.size() << " shaders into SPIR-V (" << skippedShadersCount <<
+        " without explicit uniform layouts skipped)" << std::endl;
+    return failedShadersCount == 0 ? 0 : 1;
+}
+
+std::vector<std::string> FindShaderFiles(const std::filesystem::path& RootDirectory)
+{
+    std::vector<std::string> shaderFilePaths;
+
+    std::error_code errorCode;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(RootDirectory, errorCode))
+    {
+        const std::filesystem::path extension = entry.path().extension();
+        if (entry.is_regular_file() && (extension == ".vs" || extension == ".fs"))
+        {
+            shaderFilePaths.push_back(entry.path().string());
+        }
+    }
+
+    return shaderFilePaths;
+}
+
+EBakeResult BakeShader(ShaderPreprocessor& Preprocessor, const std::string& ShaderFilePath, const std::string& CompilerPath)
+{
+    const ShaderSourceView expandedSourceCode = Preprocessor.Expand(ShaderFilePath);
+    if (!expandedSourceCode.IsValid())
+    {
+        return EBakeResult::Failed;
+    }
+
+    const std::string binaryFilePath = SpirVShaderLoader::GetBinaryFilePath(ShaderFilePath);
+    std::error_code errorCode;
+    if (!SpirVShaderLoader::DeclaresExplicitUniformLayouts(expandedSourceCode.ToStringView()))
+    {
+        // a binary baked before the shader dropped its explicit layouts would only be ignored at runtime
+        std::filesystem::remove(binaryFilePath, errorCode);
+        return EBakeResult::Skipped;
+    }
+
+    std::string upToDateBinary;
+    if (SpirVShaderLoader::LoadUpToDateBinary(ShaderFilePath, Preprocessor.GetDependencies(ShaderFilePath), upToDateBinary))
+    {
+        return EBakeResult::Baked;
+    }
+
+    // compiler gets the expanded source, as it doesn't know our #include semantics
+    const std::string expandedSourceFilePath = binaryFilePath + ".glsl";
+    {
+        std::ofstream expandedSourceFile(expandedSourceFilePath, std::ios::binary);
+        expandedSourceFile.write(expandedSourceCode.Data, expandedSourceCode.Length);
+    }
+
+    const char* shaderStage = std::filesystem::path(ShaderFilePath).extension() == ".vs" ? "vert" : "frag";
+    const std::string compileCommand = "\"" + CompilerPath + "\" -G --quiet -S " + shaderStage + " -o \"" + binaryFilePath + "\" \"" + expandedSourceFilePath + "\"";
+    const int compilerExitCode = std::system(compileCommand.c_str());
+
+    std::filesystem::remove(expandedSourceFilePath, errorCode);
+    if (compilerExitCode != 0)
+    {
+        // stale binary must not be picked up at runtime
+        std::filesystem::remove(binaryFilePath, errorCode);
+        std::cout << "Failed to bake " << ShaderFilePath << " (compiler exit code " << compilerExitCode << ")" << std::endl;
+        return EBakeResult::Failed;
+    }
+
+    return EBakeResult::Baked;
+}
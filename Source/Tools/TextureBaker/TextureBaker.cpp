@@ -0,0 +1,147 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#include "LearnOpenGL/BakedTextureLoader.h"
+
+/*
+ * Offline build step baking images into KTX2 files with precomputed mip chains (picked up by TextureCache through BakedTextureLoader).
+ * Usage: TextureBaker [textures root directory (default: Resources/Textures)] [--filter=box|kaiser (mip filter, default: box)]
+ * [--compress[=fast|normal|high] (BCn compression & its quality, default: uncompressed / normal)] [--bc3 (RGBA into BC3 instead of BC7)]
+ * [load options sets (default: default flip)]
+ * A load options set matches the TextureLoadOptions the texture is loaded with at runtime, as "+" separated words:
+ * "default", "flip", "srgb", and "r"/"rg"/"rgb"/"rgba" for DesiredChannels (e.g. "flip+srgb"). Every .jpg/.png/.tga/.bmp
+ * file gets baked once per set, into "<file>[.flip][.c<channels>][.srgb].ktx2" next to it. Up to date files are skipped (even if baked
+ * with other settings, so delete them to re-bake). No GL context is needed.
+ */
+
+// Collects all image files under the given directory
+std::vector<std::string> FindImageFiles(const std::filesystem::path& RootDirectory);
+
+// Returns whether the set was parsed successfully
+bool ParseLoadOptions(const std::string& LoadOptionsSet, TextureLoadOptions& OutOptions);
+
+int main(int argc, char* argv[])
+{
+    const std::filesystem::path rootDirectory = argc > 1 ? argv[1] : "Resources/Textures";
+
+    TextureBakeOptions bakeOptions;
+    std::vector<TextureLoadOptions> loadOptionsSets;
+    for (int argumentIndex = 2; argumentIndex < argc; ++argumentIndex)
+    {
+        const std::string argument = argv[argumentIndex];
+        if (argument == "--filter=box" || argument == "--filter=kaiser")
+        {
+            bakeOptions.MipFilter = argument == "--filter=kaiser" ? EMipFilter::Kaiser : EMipFilter::Box;
+            continue;
+        }
+        if (argument == "--compress" || argument == "--compress=fast" || argument == "--compress=normal" || argument == "--compress=high")
+        {
+            bakeOptions.bBlockCompressed = true;
+            bakeOptions.CompressionQuality = argument == "--compress=fast" ? EBlockCompressionQuality::Fast :
+                argument == "--compress=high" ? EBlockCompressionQuality::High : EBlockCompressionQuality::Normal;
+            continue;
+        }
+        if (argument == "--bc3")
+        {
+            bakeOptions.bBC7Available = false;
+            continue;
+        }
+
+        TextureLoadOptions options;
+        if (!ParseLoadOptions(argument, options))
+        {
+            std::cout << "Unknown load options set " << argument << std::endl;
+            return -1;
+        }
+        loadOptionsSets.push_back(options);
+    }
+    if (loadOptionsSets.empty())
+    {
+        // what the samples load textures with
+        TextureLoadOptions flippedOptions;
+        flippedOptions.bFlipVertically = true;
+        loadOptionsSets = { TextureLoadOptions(), flippedOptions };
+    }
+
+    const std::vector<std::string> imageFilePaths = FindImageFiles(rootDirectory);
+    if (imageFilePaths.empty())
+    {
+        std::cout << "No image files found under " << rootDirectory.string() << std::endl;
+        return -1;
+    }
+
+    int bakedFilesCount = 0;
+    int failedFilesCount = 0;
+    for (const std::string& imageFilePath : imageFilePaths)
+    {
+        for (const TextureLoadOptions& options : loadOptionsSets)
+        {
+            if (BakedTextureLoader::IsUpToDate(imageFilePath, options))
+            {
+                continue;
+            }
+
+            if (BakedTextureLoader::Bake(imageFilePath, options, bakeOptions))
+            {
+                ++bakedFilesCount;
+            }
+            else
+            {
+                ++failedFilesCount;
+            }
+        }
+    }
+
+    std::cout << "Baked " << bakedFilesCount << " textures (" << imageFilePaths.size() * loadOptionsSets.size() - bakedFilesCount - failedFilesCount <<
+        " up to date, " << failedFilesCount << " failed)" << std::endl;
+    return failedFilesCount == 0 ? 0 : 1;
+}
+
+std::vector<std::string> FindImageFiles(const std::filesystem::path& RootDirectory)
+{
+    std::vector<std::string> imageFilePaths;
+
+    std::error_code errorCode;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(RootDirectory, errorCode))
+    {
+        const std::filesystem::path extension = entry.path().extension();
+        if (entry.is_regular_file() && (extension == ".jpg" || extension == ".jpeg" || extension == ".png" || extension == ".tga" || extension == ".bmp"))
+        {
+            imageFilePaths.push_back(entry.path().string());
+        }
+    }
+
+    return imageFilePaths;
+}
+
+bool ParseLoadOptions(const std::string& LoadOptionsSet, TextureLoadOptions& OutOptions)
+{
+    std::size_t wordStart = 0;
+    while (wordStart <= LoadOptionsSet.size())
+    {
+        const std::size_t wordEnd = std::min(LoadOptionsSet.find('+', wordStart), LoadOptionsSet.size());
+        const std::string word = LoadOptionsSet.substr(wordStart, wordEnd - wordStart);
+        wordStart = wordEnd + 1;
+
+        if (word == "flip")
+        {
+            OutOptions.bFlipVertically = true;
+        }
+        else if (word == "srgb")
+        {
+            OutOptions.bSRGB = true;
+        }
+        else if (word == "r" || word == "rg" || word == "rgb" || word == "rgba")
+        {
+            OutOptions.DesiredChannels = static_cast<int>(word.size());
+        }
+        else if (word != "default")
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
\ No newline at end of file
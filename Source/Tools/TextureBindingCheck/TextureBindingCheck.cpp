@@ -0,0 +1,129 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+
+#include "LearnOpenGL/GLStateCache.h"
+#include "LearnOpenGL/TextureStreamer.h"
+
+/*
+ * Regression check for GLStateCache's texture binds: with textures bound to units 0 and 1 (leaving unit 1 active), streaming an
+ * image into the unit 0 texture must upload it there, even though TextureStreamer's bind of that texture to unit 0 is elided.
+ * Usage: TextureBindingCheck [image file (default: Resources/Textures/container.jpg)]
+ * The image is copied into a temporary directory first, so a baked file next to it doesn't skip the streaming. Needs a GL context
+ * (hidden window); returns 0 when the streamed texture holds the image and the unit 1 texture is left as it was.
+ */
+
+// Reads back the base level of the texture as RGBA
+std::vector<unsigned char> ReadTexturePixels(GLuint TextureID, int& OutWidth, int& OutHeight);
+
+int main(int argc, char* argv[])
+{
+    const std::filesystem::path imagePath = argc > 1 ? argv[1] : "Resources/Textures/container.jpg";
+
+    const std::filesystem::path checkDirectory = std::filesystem::temp_directory_path() / "LearnOpenGL" / "TextureBindingCheck";
+    const std::filesystem::path streamedImagePath = checkDirectory / imagePath.filename();
+    std::error_code errorCode;
+    std::filesystem::remove_all(checkDirectory, errorCode);
+    std::filesystem::create_directories(checkDirectory, errorCode);
+    if (!std::filesystem::copy_file(imagePath, streamedImagePath, std::filesystem::copy_options::overwrite_existing, errorCode))
+    {
+        std::cout << "Failed to copy " << imagePath.string() << " into " << checkDirectory.string() << std::endl;
+        return -1;
+    }
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+
+    GLFWwindow* window = glfwCreateWindow(64, 64, "TextureBindingCheck", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        std::cout << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+    {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+
+    TextureStreamer streamer;
+    const TextureHandle streamedTexture = streamer.Load(streamedImagePath.string());
+    GLStateCache::BindTexture(0, GL_TEXTURE_2D, streamedTexture->GetID());
+
+    // 1x1 texture on unit 1, whose pixel must survive the streaming
+    const unsigned char markerPixel[4] = { 255, 0, 255, 255 };
+    GLuint markerTextureID = 0;
+    glGenTextures(1, &markerTextureID);
+    GLStateCache::BindTexture(1, GL_TEXTURE_2D, markerTextureID);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, markerPixel);
+
+    while (streamer.GetPendingTexturesCount() > 0)
+    {
+        streamer.Update();
+    }
+    glFinish();
+
+    int streamedWidth = 0;
+    int streamedHeight = 0;
+    const std::vector<unsigned char> streamedPixels = ReadTexturePixels(streamedTexture->GetID(), streamedWidth, streamedHeight);
+    int markerWidth = 0;
+    int markerHeight = 0;
+    const std::vector<unsigned char> markerPixels = ReadTexturePixels(markerTextureID, markerWidth, markerHeight);
+
+    int imageWidth = 0;
+    int imageHeight = 0;
+    int imageChannels = 0;
+    stbi_set_flip_vertically_on_load(false);
+    unsigned char* imagePixels = stbi_load(streamedImagePath.string().c_str(), &imageWidth, &imageHeight, &imageChannels, 4);
+    const std::size_t imageSize = static_cast<std::size_t>(imageWidth) * imageHeight * 4;
+
+    bool bPassed = true;
+    if (imagePixels == nullptr || streamedWidth != imageWidth || streamedHeight != imageHeight ||
+        !std::equal(imagePixels, imagePixels + imageSize, streamedPixels.begin()))
+    {
+        std::cout << "Streamed texture (" << streamedWidth << "x" << streamedHeight << ") doesn't hold the image (" << imageWidth << "x" << imageHeight << ")" << std::endl;
+        bPassed = false;
+    }
+    if (markerWidth != 1 || markerHeight != 1 || !std::equal(markerPixel, markerPixel + 4, markerPixels.begin()))
+    {
+        std::cout << "Texture bound to unit 1 got overwritten (now " << markerWidth << "x" << markerHeight << ")" << std::endl;
+        bPassed = false;
+    }
+    stbi_image_free(imagePixels);
+    std::cout << (bPassed ? "Passed" : "Failed") << std::endl;
+
+    streamer.Shutdown();
+    glDeleteTextures(1, &markerTextureID);
+    GLStateCache::OnTextureDeleted(markerTextureID);
+    TextureCache::DeleteAll();
+    std::filesystem::remove_all(checkDirectory, errorCode);
+
+    glfwTerminate();
+    return bPassed ? 0 : 1;
+}
+
+std::vector<unsigned char> ReadTexturePixels(GLuint TextureID, int& OutWidth, int& OutHeight)
+{
+    GLStateCache::BindTexture(0, GL_TEXTURE_2D, TextureID);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &OutWidth);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &OutHeight);
+
+    std::vector<unsigned char> pixels(static_cast<std::size_t>(OutWidth) * OutHeight * 4);
+    GLStateCache::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    return pixels;
+}
@@ -1,2 +1,589 @@
-﻿#define STB_IMAGE_IMPLEMENTATION
-#include "Images/stb_image.h"
\ No newline at end of file
+﻿#include "LearnOpenGL/ImageArena.h"
+#include "LearnOpenGL/FastInflate.h"
+#include "LearnOpenGL/JpegSimdKernels.h"
+#include "LearnOpenGL/ParallelJpegDecoder.h"
+#include "LearnOpenGL/ParallelFor.h"
+
+#include <atomic>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <climits>
+#include <algorithm>
+
+// allocations go through the calling thread's arena while an ImageArena::Scope is alive on it
+#define STBI_MALLOC(Size) ImageArena::Allocate(Size)
+#define STBI_REALLOC_SIZED(Memory, OldSize, NewSize) ImageArena::Reallocate(Memory, OldSize, NewSize)
+#define STBI_FREE(Memory) ImageArena::Free(Memory)
+// stb_image's own zlib decoder is left out, its zlib API (which its PNG decoder goes through) is defined below with FastInflate
+#define STBI_NO_ZLIB
+#define STB_IMAGE_IMPLEMENTATION
+
+#if defined(JPEG_SIMD_KERNELS_AVX2) && !defined(STBI_NO_SIMD)
+/*
+ * stb_image's SSE2 row kernels for JPEGs get renamed on the way in (the macros only match their definitions, which are followed by a
+ * parameter list), so the kernel setup picks up the functions below instead, which hand the work to the AVX2 kernels when enabled.
+ */
+static unsigned char* stbi__resample_row_hv_2_simd(unsigned char* Out, unsigned char* InNear, unsigned char* InFar, int Width, int HorizontalScale);
+static void stbi__YCbCr_to_RGB_simd(unsigned char* Out, const unsigned char* Y, const unsigned char* Cb, const unsigned char* Cr, int Count, int Step);
+#define stbi__resample_row_hv_2_simd(...) stbi__resample_row_hv_2_sse2(__VA_ARGS__)
+#define stbi__YCbCr_to_RGB_simd(...) stbi__YCbCr_to_RGB_sse2(__VA_ARGS__)
+#endif
+
+#include "Images/stb_image.h"
+
+#if defined(JPEG_SIMD_KERNELS_AVX2) && !defined(STBI_NO_SIMD)
+#undef stbi__resample_row_hv_2_simd
+#undef stbi__YCbCr_to_RGB_simd
+
+#ifdef STBI_SSE2
+static unsigned char* stbi__resample_row_hv_2_simd(unsigned char* Out, unsigned char* InNear, unsigned char* InFar, int Width, int HorizontalScale)
+{
+    if (JpegSimdKernels::IsAvx2Enabled())
+    {
+        return JpegSimdKernels::ResampleRowHV2(Out, InNear, InFar, Width, HorizontalScale);
+    }
+    return stbi__resample_row_hv_2_sse2(Out, InNear, InFar, Width, HorizontalScale);
+}
+
+static void stbi__YCbCr_to_RGB_simd(unsigned char* Out, const unsigned char* Y, const unsigned char* Cb, const unsigned char* Cr, int Count, int Step)
+{
+    if (JpegSimdKernels::IsAvx2Enabled())
+    {
+        JpegSimdKernels::YCbCrToRgb(Out, Y, Cb, Cr, Count, Step);
+        return;
+    }
+    stbi__YCbCr_to_RGB_sse2(Out, Y, Cb, Cr, Count, Step);
+}
+#endif
+#endif
+
+#ifndef STBI_NO_JPEG
+// below that, splitting an image doesn't pay for the threads
+static constexpr int PARALLEL_JPEG_MIN_PIXELS_PER_THREAD = 256 * 256;
+static constexpr int PARALLEL_JPEG_MIN_ROWS_PER_THREAD = 32;
+
+// Where the entropy coded data of a scan starts over after each restart marker, & the marker ending the scan (none if the data just ends)
+struct JpegScanSegments
+{
+    std::vector<const unsigned char*> Starts;
+    unsigned char EndMarker = STBI__MARKER_none;
+    // 0xFF byte the end marker starts with
+    const unsigned char* EndMarkerPosition = nullptr;
+};
+
+static JpegScanSegments FindScanSegments(const unsigned char* Data, const unsigned char* DataEnd)
+{
+    JpegScanSegments segments;
+    segments.Starts.push_back(Data);
+
+    const unsigned char* current = Data;
+    while (current < DataEnd)
+    {
+        current = static_cast<const unsigned char*>(std::memchr(current, 0xFF, static_cast<std::size_t>(DataEnd - current)));
+        if (current == nullptr)
+        {
+            break;
+        }
+        const unsigned char* markerCode = current + 1;
+        while (markerCode < DataEnd && *markerCode == 0xFF)
+        {
+            ++markerCode;
+        }
+        if (markerCode == DataEnd)
+        {
+            break;
+        }
+
+        // a zero is a stuffed 0xFF byte of the data
+        if (*markerCode != 0x00)
+        {
+            if (!STBI__RESTART(*markerCode))
+            {
+                segments.EndMarker = *markerCode;
+                segments.EndMarkerPosition = current;
+                break;
+            }
+            segments.Starts.push_back(markerCode + 1);
+        }
+        current = markerCode + 1;
+    }
+
+    return segments;
+}
+
+// Entropy decodes a block, IDCTing it into its component's plane, or keeping its coefficients if the component has a buffer for them
+static bool DecodeJpegBlock(stbi__jpeg* Decoder, int ComponentIndex, int BlockX, int BlockY, short Data[64])
+{
+    auto& component = Decoder->img_comp[ComponentIndex];
+    short* coefficients = component.coeff != nullptr ? component.coeff + 64 * (BlockY * component.coeff_w + BlockX) : Data;
+    if (!stbi__jpeg_decode_block(Decoder, coefficients, Decoder->huff_dc + component.hd, Decoder->huff_ac + component.ha, Decoder->fast_ac[component.ha],
+        ComponentIndex, Decoder->dequant[component.tq]))
+    {
+        return false;
+    }
+    if (component.coeff == nullptr)
+    {
+        Decoder->idct_block_kernel(component.data + component.w2 * BlockY * 8 + BlockX * 8, component.w2, Data);
+    }
+    return true;
+}
+
+/*
+ * Whether stb_image would take the scan as ended where the decoder stopped: right at the end marker, or with no other 0xFF byte
+ * before it (stbi__decode_jpeg_image looks for the next marker from there, & fails on stuffed bytes or restart markers). Corrupt
+ * data that leaves the decoder anywhere else is left to stb_image, so the outcome is the same.
+ */
+static bool IsAtJpegScanEnd(stbi__jpeg* Decoder, const JpegScanSegments& Segments)
+{
+    if (Decoder->marker != STBI__MARKER_none)
+    {
+        return true;
+    }
+    const unsigned char* position = Decoder->s->img_buffer;
+    return position <= Segments.EndMarkerPosition && std::memchr(position, 0xFF, static_cast<std::size_t>(Segments.EndMarkerPosition - position)) == nullptr &&
+        stbi__EOI(Segments.EndMarkerPosition[1]);
+}
+
+// Units of a scan are interleaved MCUs, or blocks for single component scans (as in stbi__parse_entropy_coded_data); false on corrupt data
+static bool DecodeJpegUnits(stbi__jpeg* Decoder, int FirstUnit, int EndUnit)
+{
+    STBI_SIMD_ALIGN(short, data[64]);
+    for (int unitIndex = FirstUnit; unitIndex < EndUnit; ++unitIndex)
+    {
+        if (Decoder->scan_n == 1)
+        {
+            const int componentIndex = Decoder->order[0];
+            const int blocksCountX = (Decoder->img_comp[componentIndex].x + 7) >> 3;
+            if (!DecodeJpegBlock(Decoder, componentIndex, unitIndex % blocksCountX, unitIndex / blocksCountX, data))
+            {
+                return false;
+            }
+            continue;
+        }
+
+        const int mcuX = unitIndex % Decoder->img_mcu_x;
+        const int mcuY = unitIndex / Decoder->img_mcu_x;
+        for (int scanComponent = 0; scanComponent < Decoder->scan_n; ++scanComponent)
+        {
+            const int componentIndex = Decoder->order[scanComponent];
+            const int blocksCountX = Decoder->img_comp[componentIndex].h;
+            const int blocksCountY = Decoder->img_comp[componentIndex].v;
+            for (int blockY = 0; blockY < blocksCountY; ++blockY)
+            {
+                for (int blockX = 0; blockX < blocksCountX; ++blockX)
+                {
+                    if (!DecodeJpegBlock(Decoder, componentIndex, mcuX * blocksCountX + blockX, mcuY * blocksCountY + blockY, data))
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/*
+ * Reads the JPEG up to its scan & decodes the scan into the component planes, split over threads. False if it's not a JPEG the
+ * parallel path takes (progressive, several scans, RGB or CMYK, restart markers not matching the restart interval) or if its
+ * data is corrupt, stb_image then decodes it (or reports why it can't).
+ */
+static bool DecodeJpegPlanes(stbi__jpeg* Jpeg, unsigned int ThreadsCount)
+{
+    if (!stbi__decode_jpeg_header(Jpeg, STBI__SCAN_load) || Jpeg->progressive)
+    {
+        return false;
+    }
+    int marker = stbi__get_marker(Jpeg);
+    while (!stbi__SOS(marker))
+    {
+        if (stbi__EOI(marker) || stbi__DNL(marker) || !stbi__process_marker(Jpeg, marker))
+        {
+            return false;
+        }
+        marker = stbi__get_marker(Jpeg);
+    }
+
+    const int componentsCount = Jpeg->s->img_n;
+    // same test as load_jpeg_image, all markers that could change it come before the scan
+    const bool bRgb = componentsCount == 3 && (Jpeg->rgb == 3 || (Jpeg->app14_color_transform == 0 && !Jpeg->jfif));
+    if (!stbi__process_scan_header(Jpeg) || Jpeg->scan_n != componentsCount || (componentsCount != 1 && componentsCount != 3) || bRgb)
+    {
+        return false;
+    }
+    const JpegScanSegments segments = FindScanSegments(Jpeg->s->img_buffer, Jpeg->s->img_buffer_end);
+    // more scans or a DNL marker are left to stb_image, as are restart markers without a restart interval
+    if (!stbi__EOI(segments.EndMarker) || (Jpeg->restart_interval == 0 && segments.Starts.size() > 1))
+    {
+        return false;
+    }
+
+    const auto& firstComponent = Jpeg->img_comp[Jpeg->order[0]];
+    const int unitsCountX = Jpeg->scan_n == 1 ? (firstComponent.x + 7) >> 3 : Jpeg->img_mcu_x;
+    const int unitsCountY = Jpeg->scan_n == 1 ? (firstComponent.y + 7) >> 3 : Jpeg->img_mcu_y;
+    const int unitsCount = unitsCountX * unitsCountY;
+
+    if (Jpeg->restart_interval > 0)
+    {
+        const int intervalsCount = (unitsCount + Jpeg->restart_interval - 1) / Jpeg->restart_interval;
+        if (segments.Starts.size() != static_cast<std::size_t>(intervalsCount))
+        {
+            return false;
+        }
+
+        // intervals decode independently (DC predictions start over), each thread with its own copy of the decoder & its own reader
+        std::atomic<bool> bCorrupt(false);
+        ParallelFor(intervalsCount, ThreadsCount, 1, [&](int FirstInterval, int EndInterval)
+        {
+            stbi__context intervalContext;
+            // ~18 KB, fine on a thread's stack
+            stbi__jpeg decoder = *Jpeg;
+            decoder.s = &intervalContext;
+            for (int intervalIndex = FirstInterval; intervalIndex < EndInterval && !bCorrupt; ++intervalIndex)
+            {
+                const unsigned char* intervalData = segments.Starts[intervalIndex];
+                stbi__start_mem(&intervalContext, intervalData, static_cast<int>(Jpeg->s->img_buffer_end - intervalData));
+                stbi__jpeg_reset(&decoder);
+                const int firstUnit = intervalIndex * Jpeg->restart_interval;
+                const int endUnit = std::min(firstUnit + Jpeg->restart_interval, unitsCount);
+                if (!DecodeJpegUnits(&decoder, firstUnit, endUnit))
+                {
+                    bCorrupt = true;
+                    break;
+                }
+
+                // as stbi__parse_entropy_coded_data checks after full intervals, the decoder has to have stopped at the following marker
+                if (endUnit - firstUnit == Jpeg->restart_interval && decoder.code_bits < 24)
+                {
+                    stbi__grow_buffer_unsafe(&decoder);
+                }
+                if (intervalIndex + 1 < intervalsCount ? !STBI__RESTART(decoder.marker) : !IsAtJpegScanEnd(&decoder, segments))
+                {
+                    bCorrupt = true;
+                }
+            }
+        });
+        return !bCorrupt;
+    }
+
+    // a single stream has to be entropy decoded in order, so only the IDCT gets split, coefficients are kept for it meanwhile
+    for (int componentIndex = 0; componentIndex < componentsCount; ++componentIndex)
+    {
+        auto& component = Jpeg->img_comp[componentIndex];
+        component.coeff_w = component.w2 / 8;
+        component.coeff_h = component.h2 / 8;
+        component.raw_coeff = stbi__malloc_mad3(component.w2, component.h2, sizeof(short), 15);
+        if (component.raw_coeff == nullptr)
+        {
+            return false;
+        }
+        component.coeff = reinterpret_cast<short*>((reinterpret_cast<std::size_t>(component.raw_coeff) + 15) & ~static_cast<std::size_t>(15));
+    }
+    stbi__jpeg_reset(Jpeg);
+    if (!DecodeJpegUnits(Jpeg, 0, unitsCount) || !IsAtJpegScanEnd(Jpeg, segments))
+    {
+        return false;
+    }
+
+    ParallelFor(unitsCountY, ThreadsCount, 1, [&](int FirstUnitRow, int EndUnitRow)
+    {
+        for (int componentIndex = 0; componentIndex < componentsCount; ++componentIndex)
+        {
+            const auto& component = Jpeg->img_comp[componentIndex];
+            // only the blocks the scan has, single component scans leave the MCU padding out
+            const int blocksCountX = Jpeg->scan_n == 1 ? unitsCountX : unitsCountX * component.h;
+            const int blockRowsPerUnit = Jpeg->scan_n == 1 ? 1 : component.v;
+            for (int blockY = FirstUnitRow * blockRowsPerUnit; blockY < EndUnitRow * blockRowsPerUnit; ++blockY)
+            {
+                for (int blockX = 0; blockX < blocksCountX; ++blockX)
+                {
+                    Jpeg->idct_block_kernel(component.data + component.w2 * blockY * 8 + blockX * 8, component.w2,
+                        component.coeff + 64 * (blockY * component.coeff_w + blockX));
+                }
+            }
+        }
+    });
+    return true;
+}
+
+// Moves a resampler on to the next row of the image, as load_jpeg_image's row loop does
+static void AdvanceJpegResampler(stbi__resample& Resampler, int PlaneRowsCount, int PlaneStride)
+{
+    if (++Resampler.ystep >= Resampler.vs)
+    {
+        Resampler.ystep = 0;
+        Resampler.line0 = Resampler.line1;
+        if (++Resampler.ypos < PlaneRowsCount)
+        {
+            Resampler.line1 += PlaneStride;
+        }
+    }
+}
+
+// Upsamples & color converts the decoded planes into a new image, split by rows over threads; same output as load_jpeg_image
+static unsigned char* ConvertJpegPlanes(stbi__jpeg* Jpeg, int DesiredChannels, unsigned int ThreadsCount)
+{
+    const int componentsCount = Jpeg->s->img_n;
+    const int width = static_cast<int>(Jpeg->s->img_x);
+    const int height = static_cast<int>(Jpeg->s->img_y);
+    const int channels = DesiredChannels != 0 ? DesiredChannels : (componentsCount >= 3 ? 3 : 1);
+    // gray output of a color image only takes its luma
+    const int planesCount = componentsCount == 3 && channels < 3 ? 1 : componentsCount;
+
+    unsigned char* pixels = static_cast<unsigned char*>(stbi__malloc_mad3(channels, width, height, 1));
+    if (pixels == nullptr)
+    {
+        return nullptr;
+    }
+    // flipping is a per thread setting, so it's read here; rows are written flipped right away instead of swapped afterwards
+    const bool bFlipVertically = stbi__vertically_flip_on_load != 0;
+
+    ParallelFor(height, ThreadsCount, PARALLEL_JPEG_MIN_ROWS_PER_THREAD, [&](int FirstRow, int EndRow)
+    {
+        stbi__resample resamplers[4];
+        std::vector<unsigned char> lineBuffers[4];
+        for (int planeIndex = 0; planeIndex < planesCount; ++planeIndex)
+        {
+            const auto& component = Jpeg->img_comp[planeIndex];
+            stbi__resample& resampler = resamplers[planeIndex];
+            // room for upsampling off the edges by up to 4
+            lineBuffers[planeIndex].resize(static_cast<std::size_t>(width) + 3);
+            resampler.hs = Jpeg->img_h_max / component.h;
+            resampler.vs = Jpeg->img_v_max / component.v;
+            resampler.ystep = resampler.vs >> 1;
+            resampler.w_lores = (width + resampler.hs - 1) / resampler.hs;
+            resampler.ypos = 0;
+            resampler.line0 = resampler.line1 = component.data;
+
+            if (resampler.hs == 1 && resampler.vs == 1)
+            {
+                resampler.resample = resample_row_1;
+            }
+            else if (resampler.hs == 1 && resampler.vs == 2)
+            {
+                resampler.resample = stbi__resample_row_v_2;
+            }
+            else if (resampler.hs == 2 && resampler.vs == 1)
+            {
+                resampler.resample = stbi__resample_row_h_2;
+            }
+            else if (resampler.hs == 2 && resampler.vs == 2)
+            {
+                resampler.resample = Jpeg->resample_row_hv_2_kernel;
+            }
+            else
+            {
+                resampler.resample = stbi__resample_row_generic;
+            }
+
+            for (int row = 0; row < FirstRow; ++row)
+            {
+                AdvanceJpegResampler(resampler, component.y, component.w2);
+            }
+        }
+
+        unsigned char* planeRows[4] = {};
+        for (int row = FirstRow; row < EndRow; ++row)
+        {
+            for (int planeIndex = 0; planeIndex < planesCount; ++planeIndex)
+            {
+                stbi__resample& resampler = resamplers[planeIndex];
+                const bool bBottomHalf = resampler.ystep >= (resampler.vs >> 1);
+                planeRows[planeIndex] = resampler.resample(lineBuffers[planeIndex].data(), bBottomHalf ? resampler.line1 : resampler.line0,
+                    bBottomHalf ? resampler.line0 : resampler.line1, resampler.w_lores, resampler.hs);
+                AdvanceJpegResampler(resampler, Jpeg->img_comp[planeIndex].y, Jpeg->img_comp[planeIndex].w2);
+            }
+
+            unsigned char* out = pixels + static_cast<std::size_t>(channels) * width * (bFlipVertically ? height - 1 - row : row);
+            if (planesCount == 3 && channels == 4)
+            {
+                Jpeg->YCbCr_to_RGB_kernel(out, planeRows[0], planeRows[1], planeRows[2], width, channels);
+            }
+            else if (planesCount == 3)
+            {
+                // 3 channel conversion writes a 4th byte after each pixel, the last one's would land in the next row, which another thread
+                // may have written already (or this one, flipping)
+                unsigned char lastPixel[4];
+                const int lastX = width - 1;
+                Jpeg->YCbCr_to_RGB_kernel(out, planeRows[0], planeRows[1], planeRows[2], lastX, channels);
+                Jpeg->YCbCr_to_RGB_kernel(lastPixel, planeRows[0] + lastX, planeRows[1] + lastX, planeRows[2] + lastX, 1, channels);
+                std::memcpy(out + lastX * 3, lastPixel, 3);
+            }
+            else if (channels == 1)
+            {
+                std::memcpy(out, planeRows[0], static_cast<std::size_t>(width));
+            }
+            else
+            {
+                for (int x = 0; x < width; ++x, out += channels)
+                {
+                    out[0] = planeRows[0][x];
+                    if (channels == 2)
+                    {
+                        out[1] = 255;
+                        continue;
+                    }
+                    out[1] = out[2] = planeRows[0][x];
+                    if (channels == 4)
+                    {
+                        out[3] = 255;
+                    }
+                }
+            }
+        }
+    });
+
+    return pixels;
+}
+
+// Decodes the image into OutPixels if it's a JPEG worth splitting that the parallel path takes, false leaves it to stb_image
+static bool DecodeJpegInParallel(const unsigned char* Buffer, int Length, int* OutWidth, int* OutHeight, int* OutFileChannels, int DesiredChannels,
+    unsigned int ThreadsCount, unsigned char*& OutPixels)
+{
+    stbi__context context;
+    stbi__start_mem(&context, Buffer, Length);
+    // allocated like stb_image does, so it comes out of the thread's arena too
+    stbi__jpeg* jpeg = static_cast<stbi__jpeg*>(stbi__malloc(sizeof(stbi__jpeg)));
+    if (jpeg == nullptr)
+    {
+        return false;
+    }
+    jpeg->s = &context;
+    stbi__setup_jpeg(jpeg);
+
+    // the frame header tells the image size before anything gets allocated for it
+    unsigned int threadsCount = 1;
+    if (stbi__decode_jpeg_header(jpeg, STBI__SCAN_header))
+    {
+        const std::uint64_t pixelsCount = static_cast<std::uint64_t>(context.img_x) * context.img_y;
+        threadsCount = static_cast<unsigned int>(std::min<std::uint64_t>(ThreadsCount, pixelsCount / PARALLEL_JPEG_MIN_PIXELS_PER_THREAD));
+    }
+    if (threadsCount < 2)
+    {
+        STBI_FREE(jpeg);
+        return false;
+    }
+
+    stbi__rewind(&context);
+    // safe for stbi__cleanup_jpeg whenever decoding stops, as in stbi__decode_jpeg_image
+    context.img_n = 0;
+    for (int componentIndex = 0; componentIndex < 4; ++componentIndex)
+    {
+        jpeg->img_comp[componentIndex].raw_data = nullptr;
+        jpeg->img_comp[componentIndex].raw_coeff = nullptr;
+        jpeg->img_comp[componentIndex].linebuf = nullptr;
+    }
+    jpeg->restart_interval = 0;
+
+    OutPixels = DecodeJpegPlanes(jpeg, threadsCount) ? ConvertJpegPlanes(jpeg, DesiredChannels, threadsCount) : nullptr;
+    if (OutPixels != nullptr)
+    {
+        *OutWidth = static_cast<int>(context.img_x);
+        *OutHeight = static_cast<int>(context.img_y);
+        if (OutFileChannels != nullptr)
+        {
+            *OutFileChannels = context.img_n >= 3 ? 3 : 1;
+        }
+    }
+    stbi__cleanup_jpeg(jpeg);
+    STBI_FREE(jpeg);
+    return OutPixels != nullptr;
+}
+#endif
+
+unsigned char* ParallelJpegDecoder::LoadFromMemory(const unsigned char* Buffer, int Length, int* OutWidth, int* OutHeight, int* OutFileChannels,
+    int DesiredChannels, unsigned int ThreadsCount)
+{
+#ifndef STBI_NO_JPEG
+    const unsigned int threadsCount = ThreadsCount != 0 ? ThreadsCount : std::max(std::thread::hardware_concurrency(), 1u);
+    unsigned char* pixels = nullptr;
+    if (threadsCount > 1 && DesiredChannels >= 0 && DesiredChannels <= 4 &&
+        DecodeJpegInParallel(Buffer, Length, OutWidth, OutHeight, OutFileChannels, DesiredChannels, threadsCount, pixels))
+    {
+        return pixels;
+    }
+#endif
+    return stbi_load_from_memory(Buffer, Length, OutWidth, OutHeight, OutFileChannels, DesiredChannels);
+}
+
+static unsigned char* ReallocateInflateOutput(unsigned char* Memory, std::size_t OldSize, std::size_t NewSize)
+{
+    return static_cast<unsigned char*>(STBI_REALLOC_SIZED(Memory, OldSize, NewSize));
+}
+
+static int InflateZlibStream(const char* Buffer, int Length, bool bZlibHeader, FastInflate::OutputBuffer& Output)
+{
+    const char* failureReason = nullptr;
+    if (!FastInflate::Inflate(reinterpret_cast<const unsigned char*>(Buffer), static_cast<std::size_t>(std::max(Length, 0)), bZlibHeader,
+        FastInflate::IsChecksumVerified(), Output, failureReason))
+    {
+        return stbi__err(failureReason, std::strcmp(failureReason, "outofmem") == 0 ? "Out of memory" : "Corrupt PNG");
+    }
+    if (Output.Size > static_cast<std::size_t>(INT_MAX))
+    {
+        return stbi__err("outofmem", "Out of memory");
+    }
+    return 1;
+}
+
+// Output buffers are grown from InitialSize bytes by stb_image's allocator, as they were by its own zlib decoder
+static char* InflateToNewBuffer(const char* Buffer, int Length, int InitialSize, int* OutLength, bool bZlibHeader)
+{
+    FastInflate::OutputBuffer output;
+    output.Data = static_cast<unsigned char*>(stbi__malloc(static_cast<std::size_t>(InitialSize)));
+    if (output.Data == nullptr)
+    {
+        return nullptr;
+    }
+    output.Capacity = static_cast<std::size_t>(InitialSize);
+    output.Reallocate = ReallocateInflateOutput;
+    if (!InflateZlibStream(Buffer, Length, bZlibHeader, output))
+    {
+        STBI_FREE(output.Data);
+        return nullptr;
+    }
+    if (OutLength != nullptr)
+    {
+        *OutLength = static_cast<int>(output.Size);
+    }
+    return reinterpret_cast<char*>(output.Data);
+}
+
+static int InflateToBuffer(char* OutBuffer, int OutLength, const char* Buffer, int Length, bool bZlibHeader)
+{
+    FastInflate::OutputBuffer output;
+    output.Data = reinterpret_cast<unsigned char*>(OutBuffer);
+    output.Capacity = static_cast<std::size_t>(std::max(OutLength, 0));
+    return InflateZlibStream(Buffer, Length, bZlibHeader, output) ? static_cast<int>(output.Size) : -1;
+}
+
+STBIDEF char* stbi_zlib_decode_malloc_guesssize(const char* Buffer, int Length, int InitialSize, int* OutLength)
+{
+    return InflateToNewBuffer(Buffer, Length, InitialSize, OutLength, true);
+}
+
+STBIDEF char* stbi_zlib_decode_malloc_guesssize_headerflag(const char* Buffer, int Length, int InitialSize, int* OutLength, int ParseHeader)
+{
+    return InflateToNewBuffer(Buffer, Length, InitialSize, OutLength, ParseHeader != 0);
+}
+
+STBIDEF char* stbi_zlib_decode_malloc(const char* Buffer, int Length, int* OutLength)
+{
+    return InflateToNewBuffer(Buffer, Length, 16384, OutLength, true);
+}
+
+STBIDEF int stbi_zlib_decode_buffer(char* OutBuffer, int OutLength, const char* Buffer, int Length)
+{
+    return InflateToBuffer(OutBuffer, OutLength, Buffer, Length, true);
+}
+
+STBIDEF char* stbi_zlib_decode_noheader_malloc(const char* Buffer, int Length, int* OutLength)
+{
+    return InflateToNewBuffer(Buffer, Length, 16384, OutLength, false);
+}
+
+STBIDEF int stbi_zlib_decode_noheader_buffer(char* OutBuffer, int OutLength, const char* Buffer, int Length)
+{
+    return InflateToBuffer(OutBuffer, OutLength, Buffer, Length, false);
+}
\ No newline at end of file